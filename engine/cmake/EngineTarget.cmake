@@ -25,7 +25,6 @@ target_precompile_headers(engine
 target_link_libraries(engine
         PRIVATE glfw
         PRIVATE yaml
-        PRIVATE json
         PRIVATE volk
 )
 
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+namespace setsugen
+{
+
+/**
+ * @brief Single-use countdown a coroutine can suspend on.
+ * Constructed with the number of `count_down` calls to wait for. The coroutine awaiting the latch is resumed by the
+ * last `count_down`, on the thread which made it. Whichever of the awaiter and the last `count_down` comes second
+ * does the resuming, so no lock is needed.
+ */
+class AsyncLatch
+{
+public:
+  explicit AsyncLatch(size_t count) noexcept : m_count{count + 1}
+  {}
+
+  AsyncLatch(const AsyncLatch&)            = delete;
+  AsyncLatch& operator=(const AsyncLatch&) = delete;
+
+  Void count_down() noexcept
+  {
+    if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      m_awaiting.resume();
+    }
+  }
+
+  Bool await_ready() const noexcept
+  {
+    return m_count.load(std::memory_order_acquire) == 1;
+  }
+
+  Bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+  {
+    m_awaiting = awaiting;
+    return m_count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+  }
+
+  Void await_resume() const noexcept
+  {}
+
+private:
+  Atomic<size_t>          m_count;
+  std::coroutine_handle<> m_awaiting;
+};
+
+/**
+ * @brief Result slot shared between a running task and its AsyncFuture.
+ *
+ * @tparam T
+ */
+template<typename T>
+class AsyncState
+{
+public:
+  AsyncState() : m_latch{1}, m_ready{false}
+  {}
+
+  template<typename... U>
+  Void set_value(U&&... value)
+  {
+    if constexpr (!std::is_void_v<T>)
+    {
+      m_value.emplace(std::forward<U>(value)...);
+    }
+  }
+
+  Void set_exception(std::exception_ptr error) noexcept
+  {
+    m_error = std::move(error);
+  }
+
+  Void complete() noexcept
+  {
+    m_ready.store(true, std::memory_order_release);
+    m_ready.notify_all();
+    m_latch.count_down();
+  }
+
+  Bool is_ready() const noexcept
+  {
+    return m_ready.load(std::memory_order_acquire);
+  }
+
+  Void wait() const noexcept
+  {
+    m_ready.wait(false, std::memory_order_acquire);
+  }
+
+  T take()
+  {
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+
+    if constexpr (!std::is_void_v<T>)
+    {
+      return std::move(*m_value);
+    }
+  }
+
+  AsyncLatch& latch() noexcept
+  {
+    return m_latch;
+  }
+
+private:
+  using Storage = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+  Optional<Storage>  m_value;
+  std::exception_ptr m_error;
+  AsyncLatch         m_latch;
+  Atomic<Bool>       m_ready;
+};
+
+/**
+ * @brief Result of a task which was started eagerly with `spawn`.
+ * Await it from a coroutine to suspend until the task is done, no thread is blocked while waiting. Code which is not
+ * a coroutine can call `get` instead, which blocks the calling thread. Either way the result can be taken once.
+ *
+ * @tparam T
+ */
+template<typename T>
+class AsyncFuture
+{
+public:
+  class Awaiter
+  {
+  public:
+    explicit Awaiter(AsyncState<T>* state) noexcept : m_state{state}
+    {}
+
+    Bool await_ready() const noexcept
+    {
+      return m_state->latch().await_ready();
+    }
+
+    Bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+      return m_state->latch().await_suspend(awaiting);
+    }
+
+    T await_resume()
+    {
+      return m_state->take();
+    }
+
+  private:
+    AsyncState<T>* m_state;
+  };
+
+  AsyncFuture() noexcept = default;
+
+  explicit AsyncFuture(Shared<AsyncState<T>> state) noexcept : m_state{std::move(state)}
+  {}
+
+  Bool valid() const noexcept
+  {
+    return static_cast<Bool>(m_state);
+  }
+
+  Bool is_ready() const noexcept
+  {
+    return m_state && m_state->is_ready();
+  }
+
+  /**
+   * @brief Block until the task is done and return its result, or rethrow its exception.
+   * Must not be called from a task running on the executor the awaited task needs, it would tie up that thread.
+   */
+  T get()
+  {
+    check_valid();
+    m_state->wait();
+    return std::exchange(m_state, nullptr)->take();
+  }
+
+  Awaiter operator co_await() const
+  {
+    check_valid();
+    return Awaiter{m_state.get()};
+  }
+
+private:
+  Void check_valid() const
+  {
+    if (!m_state)
+    {
+      throw InvalidStateException("Future has no state");
+    }
+  }
+
+  Shared<AsyncState<T>> m_state;
+};
+
+template<typename T>
+DetachedTask
+run_async_state(Task<T> task, Shared<AsyncState<T>> state)
+{
+  try
+  {
+    if constexpr (std::is_void_v<T>)
+    {
+      co_await task;
+      state->set_value();
+    }
+    else
+    {
+      state->set_value(co_await task);
+    }
+  }
+  catch (...)
+  {
+    state->set_exception(std::current_exception());
+  }
+
+  state->complete();
+}
+
+/**
+ * @brief Run a task on the executor.
+ * The task starts right away instead of when it is awaited. Its result is delivered through the returned future,
+ * which is the non-blocking replacement for `submit(...).get()` inside coroutines.
+ */
+template<class E, typename T>
+AsyncFuture<T>
+spawn(Executor<E>& executor, Task<T> task)
+{
+  auto state = std::make_shared<AsyncState<T>>();
+  run_async_state(
+      [](Executor<E>& executor, Task<T> task) -> Task<T>
+      {
+        co_await executor.schedule();
+        co_return co_await task;
+      }(executor, std::move(task)),
+      state);
+  return AsyncFuture<T>{std::move(state)};
+}
+
+/**
+ * @brief Run a callable on the executor and get an awaitable future to its result.
+ */
+template<class E, typename F, typename... Args>
+  requires CallableType<F, Args...>
+auto
+spawn(Executor<E>& executor, F&& func, Args&&... args)
+{
+  using ReturnType = std::invoke_result_t<F, Args...>;
+
+  return spawn(executor,
+               [](std::decay_t<F> func, std::decay_t<Args>... args) -> Task<ReturnType>
+               { co_return std::invoke(std::move(func), std::move(args)...); }(std::forward<F>(func),
+                                                                                 std::forward<Args>(args)...));
+}
+
+/**
+ * @brief Block the calling thread until the task is done and return its result.
+ * The task starts on the calling thread and continues wherever its `co_await` expressions take it. This is the
+ * bridge from regular code into coroutines, e.g. in `main` or in tests.
+ */
+template<typename T>
+T
+sync_wait(Task<T> task)
+{
+  auto state = std::make_shared<AsyncState<T>>();
+  run_async_state(std::move(task), state);
+  return AsyncFuture<T>{std::move(state)}.get();
+}
+
+} // namespace setsugen
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+#include <setsugen/executor.h>
+
+#include <coroutine>
+
+namespace setsugen
+{
+
+template<typename T>
+class TaskPromise;
+template<typename T = Void>
+class Task;
+class DetachedTask;
+class AsyncLatch;
+template<typename T>
+class AsyncState;
+template<typename T>
+class AsyncFuture;
+template<typename T>
+struct WhenAnyResult;
+
+} // namespace setsugen
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+namespace setsugen
+{
+
+/**
+ * @brief State shared by every task promise.
+ * Holds the coroutine waiting for the task and the exception the task ended with. When the task finishes, control is
+ * transferred straight to the waiting coroutine, so long `co_await` chains do not grow the stack.
+ */
+class TaskPromiseBase
+{
+public:
+  class FinalAwaiter
+  {
+  public:
+    Bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+      auto continuation = handle.promise().m_continuation;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+
+    Void await_resume() noexcept
+    {}
+  };
+
+  std::suspend_always initial_suspend() noexcept
+  {
+    return {};
+  }
+
+  FinalAwaiter final_suspend() noexcept
+  {
+    return {};
+  }
+
+  Void unhandled_exception() noexcept
+  {
+    m_error = std::current_exception();
+  }
+
+  Void set_continuation(std::coroutine_handle<> continuation) noexcept
+  {
+    m_continuation = continuation;
+  }
+
+protected:
+  Void rethrow_if_failed() const
+  {
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+private:
+  std::coroutine_handle<> m_continuation;
+  std::exception_ptr      m_error;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+  Task<T> get_return_object() noexcept;
+
+  template<typename U>
+    requires std::is_convertible_v<U&&, T>
+  Void return_value(U&& value)
+  {
+    m_value.emplace(std::forward<U>(value));
+  }
+
+  T&& result()
+  {
+    rethrow_if_failed();
+    return std::move(*m_value);
+  }
+
+private:
+  Optional<T> m_value;
+};
+
+template<>
+class TaskPromise<Void> : public TaskPromiseBase
+{
+public:
+  Task<Void> get_return_object() noexcept;
+
+  Void return_void() noexcept
+  {}
+
+  Void result()
+  {
+    rethrow_if_failed();
+  }
+};
+
+/**
+ * @brief Lazily started coroutine producing a value of type `T`.
+ * The body does not run until the task is awaited. The awaiting coroutine is resumed on whichever thread the task
+ * finishes on, a task that wants to run on an executor starts with `co_await executor.schedule()`. Exceptions escaping
+ * the body are rethrown from the `co_await` expression.
+ *
+ * A task can be awaited once. Use `spawn` to start a task eagerly, or `sync_wait` to block a thread which is not a
+ * coroutine until the task is done.
+ *
+ * @tparam T
+ */
+template<typename T>
+class Task
+{
+public:
+  using promise_type = TaskPromise<T>;
+  using Handle       = std::coroutine_handle<promise_type>;
+
+  class Awaiter
+  {
+  public:
+    explicit Awaiter(Handle handle) noexcept : m_handle{handle}
+    {}
+
+    Bool await_ready() const noexcept
+    {
+      return !m_handle || m_handle.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+      m_handle.promise().set_continuation(awaiting);
+      return m_handle;
+    }
+
+    T await_resume()
+    {
+      if (!m_handle)
+      {
+        throw InvalidStateException("Cannot await an empty task");
+      }
+
+      return m_handle.promise().result();
+    }
+
+  private:
+    Handle m_handle;
+  };
+
+  Task() noexcept = default;
+
+  explicit Task(Handle handle) noexcept : m_handle{handle}
+  {}
+
+  Task(Task&& other) noexcept : m_handle{std::exchange(other.m_handle, nullptr)}
+  {}
+
+  Task(const Task&) = delete;
+
+  ~Task()
+  {
+    if (m_handle)
+    {
+      m_handle.destroy();
+    }
+  }
+
+  Task& operator=(Task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (m_handle)
+      {
+        m_handle.destroy();
+      }
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+
+    return *this;
+  }
+
+  Task& operator=(const Task&) = delete;
+
+  Bool valid() const noexcept
+  {
+    return static_cast<Bool>(m_handle);
+  }
+
+  Bool is_ready() const noexcept
+  {
+    return !m_handle || m_handle.done();
+  }
+
+  Awaiter operator co_await() const& noexcept
+  {
+    return Awaiter{m_handle};
+  }
+
+  Awaiter operator co_await() const&& noexcept
+  {
+    return Awaiter{m_handle};
+  }
+
+private:
+  Handle m_handle;
+};
+
+template<typename T>
+Task<T>
+TaskPromise<T>::get_return_object() noexcept
+{
+  return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+inline Task<Void>
+TaskPromise<Void>::get_return_object() noexcept
+{
+  return Task<Void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+/**
+ * @brief Eagerly started coroutine nobody waits for.
+ * The frame destroys itself when the body returns. Used to drive tasks from code which is not a coroutine, the body
+ * must not let exceptions escape.
+ */
+class DetachedTask
+{
+public:
+  class promise_type
+  {
+  public:
+    DetachedTask get_return_object() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never final_suspend() noexcept
+    {
+      return {};
+    }
+
+    Void return_void() noexcept
+    {}
+
+    Void unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+  };
+};
+
+} // namespace setsugen
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+namespace setsugen
+{
+
+template<typename T>
+using WhenAllValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/**
+ * @brief Which task of a `when_any` finished first, and its result.
+ */
+template<typename T>
+struct WhenAnyResult
+{
+  size_t index;
+  T      value;
+};
+
+template<>
+struct WhenAnyResult<Void>
+{
+  size_t index;
+};
+
+template<typename T>
+DetachedTask
+run_when_all_child(Task<T> task, Optional<WhenAllValue<T>>& value, std::exception_ptr& error, AsyncLatch& latch)
+{
+  try
+  {
+    if constexpr (std::is_void_v<T>)
+    {
+      co_await task;
+      value.emplace();
+    }
+    else
+    {
+      value.emplace(co_await task);
+    }
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  latch.count_down();
+}
+
+/**
+ * @brief Await several tasks at once.
+ * All tasks are started before the caller suspends, tasks that begin with `co_await executor.schedule()` run in
+ * parallel. The caller is resumed once every task has finished, with a tuple of their results in argument order.
+ * `Void` tasks contribute an empty `std::monostate`. If tasks fail, the exception of the first failed task in argument
+ * order is rethrown after all of them have finished.
+ */
+template<typename... Ts>
+Task<Tuple<WhenAllValue<Ts>...>>
+when_all(Task<Ts>... tasks)
+{
+  AsyncLatch                               latch{sizeof...(Ts)};
+  Tuple<Optional<WhenAllValue<Ts>>...>     values;
+  Array<std::exception_ptr, sizeof...(Ts)> errors;
+
+  [&]<size_t... I>(std::index_sequence<I...>)
+  {
+    (run_when_all_child(std::move(tasks), std::get<I>(values), errors[I], latch), ...);
+  }(std::index_sequence_for<Ts...>{});
+
+  co_await latch;
+
+  for (auto& error: errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  co_return std::apply([](auto&... value) { return Tuple<WhenAllValue<Ts>...>{std::move(*value)...}; }, values);
+}
+
+/**
+ * @brief Await every task of a list, see the variadic overload.
+ * Results are returned in the order of `tasks`, a list of `Void` tasks yields `Void`.
+ */
+template<typename T>
+Task<std::conditional_t<std::is_void_v<T>, Void, DArray<T>>>
+when_all(DArray<Task<T>> tasks)
+{
+  AsyncLatch                        latch{tasks.size()};
+  DArray<Optional<WhenAllValue<T>>> values(tasks.size());
+  DArray<std::exception_ptr>        errors(tasks.size());
+
+  for (size_t i = 0; i < tasks.size(); ++i)
+  {
+    run_when_all_child(std::move(tasks[i]), values[i], errors[i], latch);
+  }
+
+  co_await latch;
+
+  for (auto& error: errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  if constexpr (!std::is_void_v<T>)
+  {
+    DArray<T> results;
+    results.reserve(values.size());
+    for (auto& value: values)
+    {
+      results.emplace_back(std::move(*value));
+    }
+
+    co_return results;
+  }
+}
+
+template<typename T>
+struct WhenAnyState
+{
+  WhenAnyState() : latch{1}, decided{false}, index{0}
+  {}
+
+  AsyncLatch                latch;
+  Atomic<Bool>              decided;
+  size_t                    index;
+  Optional<WhenAllValue<T>> value;
+  std::exception_ptr        error;
+};
+
+template<typename T>
+DetachedTask
+run_when_any_child(Task<T> task, size_t index, Shared<WhenAnyState<T>> state)
+{
+  Optional<WhenAllValue<T>> value;
+  std::exception_ptr        error;
+
+  try
+  {
+    if constexpr (std::is_void_v<T>)
+    {
+      co_await task;
+      value.emplace();
+    }
+    else
+    {
+      value.emplace(co_await task);
+    }
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  if (!state->decided.exchange(true, std::memory_order_acq_rel))
+  {
+    state->index = index;
+    state->value = std::move(value);
+    state->error = error;
+    state->latch.count_down();
+  }
+}
+
+/**
+ * @brief Await the first of several tasks to finish.
+ * All tasks are started before the caller suspends. The caller is resumed as soon as one of them finishes, with its
+ * index and result, or its exception if it failed. The remaining tasks are not cancelled, they keep running and their
+ * results are discarded. Throws an InvalidArgumentException if `tasks` is empty.
+ */
+template<typename T>
+Task<WhenAnyResult<T>>
+when_any(DArray<Task<T>> tasks)
+{
+  if (tasks.empty())
+  {
+    throw InvalidArgumentException("when_any needs at least one task");
+  }
+
+  auto state = std::make_shared<WhenAnyState<T>>();
+  for (size_t i = 0; i < tasks.size(); ++i)
+  {
+    run_when_any_child(std::move(tasks[i]), i, state);
+  }
+
+  co_await state->latch;
+
+  if (state->error)
+  {
+    std::rethrow_exception(state->error);
+  }
+
+  if constexpr (std::is_void_v<T>)
+  {
+    co_return WhenAnyResult<T>{state->index};
+  }
+  else
+  {
+    co_return WhenAnyResult<T>{state->index, std::move(*state->value)};
+  }
+}
+
+template<typename T, typename... Ts>
+  requires(std::is_same_v<Task<T>, Ts> && ...)
+Task<WhenAnyResult<T>>
+when_any(Task<T> first, Ts... rest)
+{
+  DArray<Task<T>> tasks;
+  tasks.reserve(sizeof...(Ts) + 1);
+  tasks.emplace_back(std::move(first));
+  (tasks.emplace_back(std::move(rest)), ...);
+  return when_any(std::move(tasks));
+}
+
+} // namespace setsugen
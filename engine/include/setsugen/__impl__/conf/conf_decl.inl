@@ -12,19 +12,24 @@ public:
 
   ~Configuration();
 
-  Configuration get_child(const String& key) const;
-
-  String  get_string(const String& key, Optional<String>) const;
-  Int32   get_int(const String& key, Optional<Int32>) const;
-  Int64   get_long(const String& key, Optional<Int64>) const;
-  Float32 get_float(const String& key, Optional<Float32>) const;
-  Float64 get_double(const String& key, Optional<Float64>) const;
+  /**
+   * @brief Keys are dotted paths or JSON pointers, see SerializedPath.
+   * A string key is compiled on every call. Keys read in a hot loop should be compiled into a SerializedPath once,
+   * lookups through it do not allocate.
+   */
+  Configuration get_child(const SerializedPath& key) const;
+
+  String  get_string(const SerializedPath& key, Optional<String>) const;
+  Int32   get_int(const SerializedPath& key, Optional<Int32>) const;
+  Int64   get_long(const SerializedPath& key, Optional<Int64>) const;
+  Float32 get_float(const SerializedPath& key, Optional<Float32>) const;
+  Float64 get_double(const SerializedPath& key, Optional<Float64>) const;
 
 private:
   Configuration(const SerializedData& data);
 
-  SerializedData* dive(const String& key) const;
-  SerializedData* dive_insert(const String& key) const;
+  const SerializedData* dive(const SerializedPath& key) const;
+  SerializedData*       dive_insert(const SerializedPath& key) const;
   Void            merge(const SerializedData& other);
   Void            change_value(const String& key, const SerializedData& value);
 
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+namespace setsugen
+{
+
+/**
+ * @brief Shared state of a data-parallel loop.
+ * The index range is cut into chunks of `grain` indices which are claimed through an atomic counter, so each chunk
+ * runs exactly once no matter which thread picks it up. Helpers are forked lazily: every helper that finds work left
+ * forks one more helper before it starts claiming chunks, which spreads the loop over the pool in a binary tree on
+ * work-stealing executors. The calling thread claims chunks as well, so the loop completes even if no helper ever
+ * gets a worker, e.g. when the loop is nested inside a task of a saturated pool.
+ *
+ * @tparam Body Callable taking a chunk index
+ */
+template<typename Body>
+class ParallelLoop
+{
+public:
+  ParallelLoop(Body& body, Int64 chunks) : m_body{&body}, m_chunks{chunks}, m_next{0}, m_done{0}, m_failed{false}
+  {}
+
+  template<class E>
+  Void run(Executor<E>& executor, const Shared<ParallelLoop>& self)
+  {
+    fork(executor, self);
+    work();
+    wait();
+
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+private:
+  template<class E>
+  static Void fork(Executor<E>& executor, const Shared<ParallelLoop>& self)
+  {
+    if (self->m_next.load(std::memory_order_relaxed) + 1 >= self->m_chunks)
+    {
+      return;
+    }
+
+    executor.submit_detached(
+        [&executor, self]
+        {
+          if (self->m_next.load(std::memory_order_relaxed) >= self->m_chunks)
+          {
+            return;
+          }
+
+          fork(executor, self);
+          self->work();
+        });
+  }
+
+  Void work()
+  {
+    Int64 completed = 0;
+    for (auto chunk = m_next.fetch_add(1); chunk < m_chunks; chunk = m_next.fetch_add(1))
+    {
+      if (!m_failed.load(std::memory_order_relaxed))
+      {
+        try
+        {
+          std::invoke(*m_body, chunk);
+        }
+        catch (...)
+        {
+          if (!m_failed.exchange(true))
+          {
+            m_error = std::current_exception();
+          }
+        }
+      }
+      ++completed;
+    }
+
+    if (completed > 0 && m_done.fetch_add(completed, std::memory_order_acq_rel) + completed == m_chunks)
+    {
+      m_done.notify_all();
+    }
+  }
+
+  Void wait()
+  {
+    for (auto done = m_done.load(std::memory_order_acquire); done < m_chunks;
+         done      = m_done.load(std::memory_order_acquire))
+    {
+      m_done.wait(done, std::memory_order_acquire);
+    }
+  }
+
+  Body*              m_body;
+  Int64              m_chunks;
+  Atomic<Int64>      m_next;
+  Atomic<Int64>      m_done;
+  Atomic<Bool>       m_failed;
+  std::exception_ptr m_error;
+};
+
+/**
+ * @brief Run `func(i)` for every `i` in `[first, last)` on the executor.
+ * Indices are processed in chunks of `grain`, the calling thread takes part in the loop and returns once every index
+ * has been processed. The first exception thrown by `func` is rethrown to the caller, remaining chunks are skipped.
+ */
+template<class E, std::integral Index, typename F>
+  requires CallableType<F&, Index>
+Void
+parallel_for(Executor<E>& executor, Index first, Index last, Index grain, F&& func)
+{
+  if (last <= first)
+  {
+    return;
+  }
+
+  grain       = std::max<Index>(grain, 1);
+  auto chunks = static_cast<Int64>((last - first + grain - 1) / grain);
+
+  auto body = [&](Int64 chunk)
+  {
+    auto begin = static_cast<Index>(first + chunk * grain);
+    auto end   = static_cast<Index>(std::min<Int64>(static_cast<Int64>(begin) + grain, last));
+    for (auto i = begin; i < end; ++i)
+    {
+      std::invoke(func, i);
+    }
+  };
+
+  if (chunks == 1)
+  {
+    body(0);
+    return;
+  }
+
+  auto loop = std::make_shared<ParallelLoop<decltype(body)>>(body, chunks);
+  loop->run(executor, loop);
+}
+
+/**
+ * @brief Run `func(element)` for every element of a random access range on the executor.
+ */
+template<class E, std::ranges::random_access_range R, typename F>
+  requires CallableType<F&, std::ranges::range_reference_t<R>>
+Void
+parallel_for(Executor<E>& executor, R&& range, size_t grain, F&& func)
+{
+  auto begin = std::ranges::begin(range);
+  parallel_for(executor, size_t{0}, static_cast<size_t>(std::ranges::size(range)), grain,
+               [&](size_t i) { std::invoke(func, begin[i]); });
+}
+
+/**
+ * @brief Reduce `map(i)` for every `i` in `[first, last)` with `reduce`.
+ * Each chunk is folded starting from `identity`, then the chunk results are folded in index order, so the result is
+ * deterministic for associative operations even if they are not commutative.
+ */
+template<class E, std::integral Index, typename T, typename Map, typename Reduce>
+  requires CallableType<Map&, Index> && CallableType<Reduce&, T, std::invoke_result_t<Map&, Index>>
+T
+parallel_reduce(Executor<E>& executor, Index first, Index last, Index grain, T identity, Map&& map, Reduce&& reduce)
+{
+  if (last <= first)
+  {
+    return identity;
+  }
+
+  grain       = std::max<Index>(grain, 1);
+  auto chunks = static_cast<size_t>((last - first + grain - 1) / grain);
+
+  DArray<T> partials(chunks, identity);
+  parallel_for(executor, size_t{0}, chunks, size_t{1},
+               [&](size_t chunk)
+               {
+                 auto begin = static_cast<Index>(first + chunk * grain);
+                 auto end   = static_cast<Index>(std::min<Int64>(static_cast<Int64>(begin) + grain, last));
+                 auto acc   = identity;
+                 for (auto i = begin; i < end; ++i)
+                 {
+                   acc = std::invoke(reduce, std::move(acc), std::invoke(map, i));
+                 }
+                 partials[chunk] = std::move(acc);
+               });
+
+  auto result = std::move(identity);
+  for (auto& partial: partials)
+  {
+    result = std::invoke(reduce, std::move(result), std::move(partial));
+  }
+
+  return result;
+}
+
+/**
+ * @brief Write `func(input[i])` to `output[i]` for every element of `input`.
+ * `output` must be a random access iterator to at least as many elements as `input` holds.
+ */
+template<class E, std::ranges::random_access_range R, std::random_access_iterator Out, typename F>
+  requires CallableType<F&, std::ranges::range_reference_t<R>>
+Void
+parallel_transform(Executor<E>& executor, R&& input, Out output, size_t grain, F&& func)
+{
+  auto begin = std::ranges::begin(input);
+  parallel_for(executor, size_t{0}, static_cast<size_t>(std::ranges::size(input)), grain,
+               [&](size_t i) { output[i] = std::invoke(func, begin[i]); });
+}
+
+} // namespace setsugen
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+#include <bit>
+
+namespace setsugen
+{
+
+class Logger;
+
+/**
+ * @brief Immutable copy of an ExecutorHistogram.
+ * Bucket `i` counts the samples between `bucket_lower_bound(i)` and `bucket_upper_bound(i)`, percentiles are reported
+ * as the upper bound of the bucket holding the requested rank, so they overestimate by at most 1/16.
+ */
+struct HistogramSnapshot
+{
+  DArray<UInt64> buckets;
+  UInt64         count = 0;
+  UInt64         sum   = 0;
+  UInt64         min   = 0;
+  UInt64         max   = 0;
+
+  Float64 mean() const;
+
+  /**
+   * @brief Smallest bucket bound which at least `percentile` percent of the samples do not exceed, 0 if empty.
+   */
+  UInt64 percentile(Float64 percentile) const;
+};
+
+/**
+ * @brief Log-linear histogram of non-negative integer samples, in the spirit of HdrHistogram.
+ * Every power of two range is split into 16 linear buckets, so a sample is known to within 1/16 of its magnitude
+ * across the whole range. Recording never allocates or locks: it is a few relaxed atomic operations, so any number of
+ * threads can record concurrently. Samples above `max_value` are clamped to it.
+ */
+class ExecutorHistogram
+{
+public:
+  static constexpr UInt32 sub_bucket_bits  = 4;
+  static constexpr UInt64 sub_bucket_count = UInt64{1} << sub_bucket_bits;
+  static constexpr UInt32 max_value_bits   = 40;
+  static constexpr UInt64 max_value        = (UInt64{1} << max_value_bits) - 1;
+  static constexpr size_t bucket_count     = (max_value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+  ExecutorHistogram() noexcept;
+
+  Void record(UInt64 value) noexcept
+  {
+    value = std::min(value, max_value);
+    m_buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    // Both bounds settle after a handful of samples, from then on these are plain loads
+    auto min = m_min.load(std::memory_order_relaxed);
+    while (value < min && !m_min.compare_exchange_weak(min, value, std::memory_order_relaxed))
+    {}
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {}
+  }
+
+  /**
+   * @brief Copy the buckets out.
+   * Samples recorded concurrently may be missing from the copy or counted in the bucket but not yet in the sum.
+   */
+  HistogramSnapshot snapshot() const;
+
+  Void reset() noexcept;
+
+  static constexpr size_t bucket_of(UInt64 value) noexcept
+  {
+    if (value < sub_bucket_count)
+    {
+      return value;
+    }
+
+    auto shift = static_cast<UInt32>(std::bit_width(value)) - 1 - sub_bucket_bits;
+    return (shift + 1) * sub_bucket_count + ((value >> shift) - sub_bucket_count);
+  }
+
+  static constexpr UInt64 bucket_lower_bound(size_t bucket) noexcept
+  {
+    if (bucket < sub_bucket_count)
+    {
+      return bucket;
+    }
+
+    auto shift = bucket / sub_bucket_count - 1;
+    return (bucket % sub_bucket_count + sub_bucket_count) << shift;
+  }
+
+  static constexpr UInt64 bucket_upper_bound(size_t bucket) noexcept
+  {
+    return bucket + 1 < bucket_count ? bucket_lower_bound(bucket + 1) - 1 : max_value;
+  }
+
+private:
+  Array<Atomic<UInt64>, bucket_count> m_buckets;
+  Atomic<UInt64>                      m_sum;
+  Atomic<UInt64>                      m_min;
+  Atomic<UInt64>                      m_max;
+};
+
+/**
+ * @brief Point in time copy of the instrumentation of an executor.
+ * Times are in nanoseconds. `in_flight` counts tasks which were submitted but have neither finished nor been
+ * cancelled, whether they are queued or running. A task is counted as completed once it returned, which is slightly
+ * after its future became ready.
+ */
+struct ExecutorStats
+{
+  UInt64            submitted  = 0;
+  UInt64            completed  = 0;
+  UInt64            cancelled  = 0;
+  UInt64            late_tasks = 0;
+  UInt64            steals     = 0;
+  Int64             in_flight  = 0;
+  HistogramSnapshot wait_time;   // From submission to the start of the task
+  HistogramSnapshot run_time;    // From the start to the end of the task
+  HistogramSnapshot queue_depth; // Number of queued tasks, sampled on every submission
+  HistogramSnapshot idle_time;   // Time a worker spent parked waiting for a task
+
+  /**
+   * @brief Write a summary to the logger at info level, one line per histogram, tagged with `name`.
+   */
+  Void log(Logger& logger, const String& name) const;
+};
+
+/**
+ * @brief Counters and histograms every executor maintains.
+ * Timing costs a few clock reads per task, it can be switched off at run time, in which case only the counters, the
+ * queue depth and the steals are kept.
+ */
+class ExecutorMetrics
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  Int64 now() const noexcept
+  {
+    if (!m_timing.load(std::memory_order_relaxed))
+    {
+      return 0;
+    }
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  }
+
+  Void set_timing(Bool enabled) noexcept
+  {
+    m_timing.store(enabled, std::memory_order_relaxed);
+  }
+
+  Bool is_timing() const noexcept
+  {
+    return m_timing.load(std::memory_order_relaxed);
+  }
+
+  Void record_submit() noexcept
+  {
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Void record_cancel() noexcept
+  {
+    m_cancelled.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Record the wait of a task which is about to run and return its start time.
+   */
+  Int64 record_start(Int64 submitted) noexcept
+  {
+    auto started = submitted != 0 ? now() : 0;
+    if (started != 0)
+    {
+      m_wait_time.record(static_cast<UInt64>(std::max<Int64>(started - submitted, 0)));
+    }
+    return started;
+  }
+
+  Void record_finish(Int64 started) noexcept
+  {
+    m_completed.fetch_add(1, std::memory_order_relaxed);
+    if (started != 0)
+    {
+      m_run_time.record(static_cast<UInt64>(std::max<Int64>(now() - started, 0)));
+    }
+  }
+
+  Void record_queue_depth(Int64 depth) noexcept
+  {
+    m_queue_depth.record(static_cast<UInt64>(std::max<Int64>(depth, 0)));
+  }
+
+  Void record_steal() noexcept
+  {
+    m_steals.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Void record_idle(Int64 parked) noexcept
+  {
+    if (parked != 0)
+    {
+      m_idle_time.record(static_cast<UInt64>(std::max<Int64>(now() - parked, 0)));
+    }
+  }
+
+  ExecutorStats snapshot() const;
+  Void          reset() noexcept;
+
+private:
+  Atomic<Bool>      m_timing{true};
+  Atomic<UInt64>    m_submitted{0};
+  Atomic<UInt64>    m_completed{0};
+  Atomic<UInt64>    m_cancelled{0};
+  Atomic<UInt64>    m_steals{0};
+  ExecutorHistogram m_wait_time;
+  ExecutorHistogram m_run_time;
+  ExecutorHistogram m_queue_depth;
+  ExecutorHistogram m_idle_time;
+};
+
+} // namespace setsugen
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <setsugen/pch.h>
+
+namespace setsugen
+{
+
+/**
+ * @brief Timing of one task graph run.
+ * Durations are in milliseconds. The critical path is the chain of dependent tasks with the largest summed duration,
+ * it is the lower bound of the frame time no matter how many workers the executor has.
+ */
+struct TaskGraphReport
+{
+  struct NodeTiming
+  {
+    String  name;
+    Float64 start;
+    Float64 duration;
+  };
+
+  Float64            wall_time     = 0;
+  Float64            critical_time = 0;
+  DArray<size_t>     critical_path = {};
+  DArray<NodeTiming> nodes         = {};
+};
+
+/**
+ * @brief Directed acyclic graph of tasks run on an executor.
+ * Build the graph once with `add` and `precede`, then call `run` every frame. The graph is compiled on the first run
+ * after it changed: dependency counts, roots and a topological order are computed once and reused by every later run.
+ * A task is submitted as soon as all of its predecessors have finished, so independent tasks overlap across workers.
+ *
+ * `run` blocks the calling thread until the whole graph has finished. It must not be called from a task running on
+ * the same executor. If the executor is stopped before the graph has finished, the tasks which did not start yet are
+ * skipped and `run` throws an InvalidStateException.
+ */
+class TaskGraph
+{
+public:
+  using NodeId = size_t;
+
+  TaskGraph();
+  ~TaskGraph();
+
+  TaskGraph(const TaskGraph&)            = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+
+  NodeId     add(const String& name, InplaceFn<Void()>&& work);
+  TaskGraph& precede(NodeId before, NodeId after);
+
+  /**
+   * @brief Validate the graph and precompute its schedule.
+   * Throws an InvalidStateException if the graph contains a cycle.
+   */
+  Void compile();
+
+  template<class E>
+  Void run(Executor<E>& executor);
+
+  size_t                 size() const;
+  const String&          get_name(NodeId node) const;
+  const TaskGraphReport& last_report() const;
+
+private:
+  struct Node
+  {
+    String            name;
+    InplaceFn<Void()> work;
+    DArray<NodeId>    successors;
+    DArray<NodeId>    predecessors;
+    Atomic<Int32>     pending;
+    Float64           start;
+    Float64           duration;
+  };
+
+  template<class E>
+  Void schedule(Executor<E>& executor, NodeId node);
+
+  Void begin_run();
+  Void execute(NodeId node);
+  Void cancel(NodeId node);
+  Void finish_node();
+  Void end_run();
+
+  DArray<Owner<Node>>                   m_nodes;
+  DArray<NodeId>                        m_roots;
+  DArray<NodeId>                        m_order;
+  Bool                                  m_compiled;
+  Atomic<size_t>                        m_remaining;
+  Bool                                  m_finished;
+  Mutex                                 m_finished_mutex;
+  ConditionalVariable                   m_finished_cond;
+  Atomic<Bool>                          m_failed;
+  std::exception_ptr                    m_error;
+  std::chrono::steady_clock::time_point m_run_start;
+  TaskGraphReport                       m_report;
+};
+
+template<class E>
+Void
+TaskGraph::run(Executor<E>& executor)
+{
+  if (executor.is_stopped())
+  {
+    throw InvalidStateException("Cannot run a task graph on a stopped executor");
+  }
+
+  begin_run();
+
+  for (auto root: m_roots)
+  {
+    schedule(executor, root);
+  }
+
+  end_run();
+}
+
+template<class E>
+Void
+TaskGraph::schedule(Executor<E>& executor, NodeId node)
+{
+  executor.enqueue(executor.instrument(
+                       [this, &executor, node](Bool stopped)
+                       {
+                         if (stopped)
+                         {
+                           cancel(node);
+                           return;
+                         }
+
+                         execute(node);
+
+                         for (auto successor: m_nodes[node]->successors)
+                         {
+                           if (m_nodes[successor]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                           {
+                             schedule(executor, successor);
+                           }
+                         }
+
+                         finish_node();
+                       }),
+                   TaskPriority::Normal);
+}
+
+} // namespace setsugen
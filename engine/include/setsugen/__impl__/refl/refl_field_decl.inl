@@ -1,6 +1,7 @@
 #pragma once
 
 #include "refl_fwd.inl"
+#include "refl_reader_decl.inl"
 
 namespace setsugen
 {
@@ -37,10 +38,20 @@ public:
   template<typename T>
   Void set_value(SerializedData& data, T& target) const;
 
+  /**
+   * @brief The field of `target` and its reader, for reading straight from parser events, see ReflectionReader.
+   */
+  ReflectionSlot get_slot(Void* target) const;
+
 private:
+  template<ClassType T, typename TF>
+  Void bind_slot(std::function<TF&(T&)> accessor);
+
   String                                 m_name;
   std::function<Void(SerializedData&, Void*)> m_getter;
   std::function<Void(SerializedData&, Void*)> m_setter;
+  std::function<Void*(Void*)>                 m_address;
+  const ReflectionValueReader& (*m_reader)();
 };
 
 } // namespace setsugen
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "refl_field_decl.inl"
+#include "refl_reader_impl.inl"
 
 #include <setsugen/serde.h>
 
@@ -15,6 +16,8 @@ ReflectionField::ReflectionField(const String& name, Fn accessor) : ReflectionFi
 template<ClassType T, ScalarType TF>
 ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> accessor) : m_name(name)
 {
+  bind_slot(accessor);
+
   m_getter = [accessor](SerializedData& data, Void* target)
   {
     auto& ref = accessor(*static_cast<T*>(target));
@@ -24,9 +27,14 @@ ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> acce
   m_setter = [accessor](SerializedData& data, Void* target)
   {
     auto& ref = accessor(*static_cast<T*>(target));
-    if constexpr (StringType<TF>)
+    if constexpr (std::is_same_v<TF, String>)
+    {
+      ref.assign(data.get_string().view());
+    }
+    else if constexpr (StringType<TF>)
     {
-      ref = data.get_string().value().c_str();
+      // Points into the string held by the SerializedData, which has to outlive the field
+      ref = data.get_string().view().data();
     }
     else if constexpr (IntegralType<TF>)
     {
@@ -50,6 +58,8 @@ ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> acce
 template<ClassType T, Serializable TF>
 ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> accessor) : m_name(name)
 {
+  bind_slot(accessor);
+
   m_getter = [accessor](SerializedData& data, Void* target) { data.serialize(accessor(*static_cast<T*>(target))); };
   m_setter = [accessor](SerializedData& data, Void* target) { data.deserialize(accessor(*static_cast<T*>(target))); };
 }
@@ -58,6 +68,8 @@ template<ClassType T, IterableType TF>
 requires ScalarType<typename TF::value_type>
 ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> accessor) : m_name(name)
 {
+  bind_slot(accessor);
+
   m_getter = [accessor](SerializedData& data, Void* target)
   {
     auto& ref = accessor(*static_cast<T*>(target));
@@ -69,12 +81,20 @@ ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> acce
     using ValueType = typename TF::value_type;
 
     auto& ref = accessor(*static_cast<T*>(target));
+    if constexpr (requires(TF& value) { value.resize(size_t{}); })
+    {
+      ref.resize(data.get_array().size());
+    }
 
     for (size_t i = 0; i < data.get_array().size(); ++i)
     {
-      if constexpr (StringType<ValueType>)
+      if constexpr (std::is_same_v<ValueType, String>)
+      {
+        ref[i].assign(data.get_array()[i].get_string().view());
+      }
+      else if constexpr (StringType<ValueType>)
       {
-        ref[i] = data.get_array()[i].get_string().value().c_str();
+        ref[i] = data.get_array()[i].get_string().view().data();
       }
       else if constexpr (IntegralType<ValueType>)
       {
@@ -104,18 +124,21 @@ template<ClassType T, IterableType TF>
 requires Serializable<typename TF::value_type>
 ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> accessor) : m_name(name)
 {
+  bind_slot(accessor);
+
   m_getter = [accessor](SerializedData& data, Void* target)
   {
-    auto& ref = accessor(*static_cast<T*>(target));
-    auto tmp = SerializedData::array({});
+    auto& ref   = accessor(*static_cast<T*>(target));
+    auto  tmp   = SerializedData::array({});
+    auto& items = tmp.get_array();
+    items.reserve(ref.size());
 
-    for (auto& item: ref) {
-      SerializedData item_data;
-      item_data.serialize(item);
-      tmp.get_array().push_back(item_data);
+    for (auto& item: ref)
+    {
+      items.emplace_back().serialize(item);
     }
 
-    data = tmp;
+    data = std::move(tmp);
   };
 
   m_setter = [accessor](SerializedData& data, Void* target)
@@ -134,6 +157,8 @@ template<ClassType T, IterableType TF>
 requires IterableType<typename TF::value_type>
 ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> accessor) : m_name(name)
 {
+  bind_slot(accessor);
+
   m_getter = [accessor](SerializedData& data, Void* target)
   {
     auto& ref = accessor(*static_cast<T*>(target));
@@ -147,6 +172,16 @@ ReflectionField::ReflectionField(const String& name, std::function<TF&(T&)> acce
   };
 }
 
+template<ClassType T, typename TF>
+Void
+ReflectionField::bind_slot(std::function<TF&(T&)> accessor)
+{
+  m_address = [accessor](Void* target) -> Void* { return &accessor(*static_cast<T*>(target)); };
+
+  // Taken lazily, the reader of a struct reflects its fields and would otherwise recurse into a struct holding itself
+  m_reader = &reflection_reader<TF>;
+}
+
 template<typename T>
 Void
 ReflectionField::get_value(SerializedData& data, T& target) const
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "refl_fwd.inl"
+
+#include <setsugen/serde.h>
+
+namespace setsugen
+{
+
+class ReflectionValueReader;
+
+/**
+ * @brief A value being read: where it lives and how events are written into it. A slot without a reader belongs to a
+ * value which is not reflected, e.g. an unknown key, and its events are skipped.
+ */
+struct ReflectionSlot
+{
+  Void*                        target = nullptr;
+  const ReflectionValueReader* reader = nullptr;
+};
+
+/**
+ * @brief Writes parser events into objects of one type, there is a single stateless instance per type.
+ * An event the type cannot take throws an InvalidFormatException naming what was expected.
+ */
+class ReflectionValueReader
+{
+public:
+  explicit ReflectionValueReader(const char* expected);
+  virtual ~ReflectionValueReader() = default;
+
+  virtual Void on_null(Void* target) const;
+  virtual Void on_bool(Void* target, Bool value) const;
+  virtual Void on_int(Void* target, Int64 value) const;
+  virtual Void on_float(Void* target, Float64 value) const;
+  virtual Void on_string(Void* target, StringView value) const;
+
+  virtual Void           begin_object(Void* target) const;
+  virtual ReflectionSlot member(Void* target, StringView key) const;
+  virtual Void           begin_array(Void* target) const;
+  virtual ReflectionSlot element(Void* target, size_t index) const;
+
+protected:
+  [[noreturn]] Void unexpected(const char* found) const;
+
+private:
+  const char* m_expected;
+};
+
+/**
+ * @brief Reader of the values of type T.
+ */
+template<typename T>
+const ReflectionValueReader& reflection_reader();
+
+/**
+ * @brief Deserializes a document straight into a reflected object as the parser reports it.
+ * No intermediate SerializedData is built: members are matched against the reflected fields by their precomputed key
+ * hash and written in place, and keys which are not fields are skipped with their whole value. Drive it with a format
+ * which streams to a SerializedVisitor, e.g. `Json::deserialize(stream, reader)`.
+ */
+class ReflectionReader : public SerializedVisitor
+{
+public:
+  template<Serializable T>
+  explicit ReflectionReader(T& target);
+
+  Void on_null() override;
+  Void on_bool(Bool value) override;
+  Void on_int(Int64 value) override;
+  Void on_float(Float64 value) override;
+  Void on_string(StringView value) override;
+  Void on_key(StringView key) override;
+  Void on_object_begin() override;
+  Void on_object_end() override;
+  Void on_array_begin() override;
+  Void on_array_end() override;
+
+private:
+  struct Frame
+  {
+    ReflectionSlot slot;
+    size_t         index  = 0; // Next element of an array
+    Bool           object = false;
+  };
+
+  ReflectionSlot next_slot();
+
+  DArray<Frame>  m_stack;
+  ReflectionSlot m_slot; // The root until it is read, then the member named by the last key
+};
+
+} // namespace setsugen
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "refl_field_decl.inl"
+#include "refl_reader_decl.inl"
+
+namespace setsugen
+{
+
+template<ScalarType T>
+class ScalarReflectionReader final : public ReflectionValueReader
+{
+public:
+  ScalarReflectionReader() : ReflectionValueReader(expected())
+  {}
+
+  Void on_null(Void* target) const override
+  {
+    if constexpr (NullType<T>)
+    {
+      *static_cast<T*>(target) = nullptr;
+    }
+    else
+    {
+      unexpected("null");
+    }
+  }
+
+  Void on_bool(Void* target, Bool value) const override
+  {
+    if constexpr (BooleanType<T>)
+    {
+      *static_cast<T*>(target) = value;
+    }
+    else
+    {
+      unexpected("boolean");
+    }
+  }
+
+  Void on_int(Void* target, Int64 value) const override
+  {
+    if constexpr (NumericType<T>)
+    {
+      *static_cast<T*>(target) = static_cast<T>(value);
+    }
+    else
+    {
+      unexpected("integer");
+    }
+  }
+
+  Void on_float(Void* target, Float64 value) const override
+  {
+    if constexpr (FloatingPointType<T>)
+    {
+      *static_cast<T*>(target) = static_cast<T>(value);
+    }
+    else
+    {
+      unexpected("float");
+    }
+  }
+
+  Void on_string(Void* target, StringView value) const override
+  {
+    if constexpr (std::is_same_v<T, String>)
+    {
+      static_cast<String*>(target)->assign(value);
+    }
+    else if constexpr (StringType<T>)
+    {
+      throw InvalidOperationException("Cannot read into a non-owning string, the parser buffers do not outlive it");
+    }
+    else
+    {
+      unexpected("string");
+    }
+  }
+
+private:
+  static constexpr const char* expected()
+  {
+    if constexpr (NullType<T>)
+    {
+      return "null";
+    }
+    else if constexpr (BooleanType<T>)
+    {
+      return "boolean";
+    }
+    else if constexpr (IntegralType<T>)
+    {
+      return "integer";
+    }
+    else if constexpr (FloatingPointType<T>)
+    {
+      return "number";
+    }
+    else
+    {
+      return "string";
+    }
+  }
+};
+
+template<Serializable T>
+class StructReflectionReader final : public ReflectionValueReader
+{
+public:
+  StructReflectionReader() : ReflectionValueReader("object")
+  {
+    for (const auto& field: Reflection<T>{}.get_fields())
+    {
+      m_members.push_back({DataStorage<SerializedType::Object>::key_hash(field.get_name()), &field});
+    }
+  }
+
+  Void begin_object(Void* /*target*/) const override
+  {}
+
+  ReflectionSlot member(Void* target, StringView key) const override
+  {
+    // Structs have few fields, comparing the hashes first makes a linear scan cheaper than any table
+    auto hash = DataStorage<SerializedType::Object>::key_hash(key);
+    for (const auto& member: m_members)
+    {
+      if (member.hash == hash && member.field->get_name() == key)
+      {
+        return member.field->get_slot(target);
+      }
+    }
+
+    return {};
+  }
+
+private:
+  struct Member
+  {
+    UInt32                 hash;
+    const ReflectionField* field;
+  };
+
+  DArray<Member> m_members;
+};
+
+template<IterableType T>
+class ArrayReflectionReader final : public ReflectionValueReader
+{
+public:
+  using ValueType = typename T::value_type;
+
+  ArrayReflectionReader() : ReflectionValueReader("array")
+  {}
+
+  Void begin_array(Void* target) const override
+  {
+    if constexpr (requires(T& value) { value.clear(); })
+    {
+      static_cast<T*>(target)->clear();
+    }
+  }
+
+  ReflectionSlot element(Void* target, size_t index) const override
+  {
+    auto& array = *static_cast<T*>(target);
+    if constexpr (requires(T& value) { value.emplace_back(); })
+    {
+      return {&array.emplace_back(), &reflection_reader<ValueType>()};
+    }
+    else
+    {
+      if (index >= array.size())
+      {
+        throw OutOfBoundsException("Array has more than {} elements", {array.size()});
+      }
+
+      return {&array[index], &reflection_reader<ValueType>()};
+    }
+  }
+};
+
+template<typename T>
+const ReflectionValueReader&
+reflection_reader()
+{
+  if constexpr (ScalarType<T>)
+  {
+    static const ScalarReflectionReader<T> reader;
+    return reader;
+  }
+  else if constexpr (Serializable<T>)
+  {
+    static const StructReflectionReader<T> reader;
+    return reader;
+  }
+  else
+  {
+    static_assert(IterableType<T>, "Type has no reflection reader");
+    static const ArrayReflectionReader<T> reader;
+    return reader;
+  }
+}
+
+template<Serializable T>
+ReflectionReader::ReflectionReader(T& target) : m_slot{&target, &reflection_reader<T>()}
+{}
+
+} // namespace setsugen
@@ -28,6 +28,13 @@ public:
 
   DataStorage& push_back(const SerializedData& data);
   DataStorage& push_back(SerializedData&& data);
+
+  /**
+   * @brief Construct a new element in place from `args` and return it.
+   */
+  template<typename... Args>
+  SerializedData& emplace_back(Args&&... args);
+
   DataStorage& pop_back();
   DataStorage& clear();
   DataStorage& erase(size_t index);
@@ -56,8 +63,27 @@ public:
 
   explicit operator Bool() const noexcept;
 
+  /**
+   * @brief Structural hash of the elements in order, cached until the array is next accessed mutably.
+   */
+  UInt64 hash() const;
+
+  /**
+   * @brief Element-wise equality, two arrays whose hashes are both cached and differ are unequal without a traversal.
+   */
+  Bool operator==(const DataStorage& other) const;
+
 private:
+  friend class SerializedData;
+
+  // Every element points at the hash of its array, which has to be redone whenever the elements move in memory. After
+  // an append only the new element needs it, unless the array grew and moved the others
+  Void adopt(SerializedData& data) noexcept;
+  Void adopt() noexcept;
+  Void adopt_appended(const SerializedData* previous) noexcept;
+
   DArray<SerializedData> m_arrays;
+  SerializedHash         m_hash;
 };
 
 
@@ -13,6 +13,8 @@ DataStorage<SerializedType::Array>::DataStorage(const T& data) : m_arrays()
   {
     m_arrays.push_back(value);
   }
+
+  adopt();
 }
 
 } // namespace setsugen
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "serde_data.inl"
+
+namespace setsugen
+{
+
+/**
+ * @brief Fluent construction of an object, every value is moved into place.
+ * Unlike the initializer list constructors, which can only copy their elements, adding an rvalue subtree never copies
+ * it, so large documents can be assembled from their parts without a deep copy.
+ */
+class SerializedObjectBuilder
+{
+public:
+  explicit SerializedObjectBuilder(size_t reserve = 0)
+  {
+    m_storage.reserve(reserve);
+  }
+
+  template<typename T>
+  SerializedObjectBuilder& add(StringView key, T&& value) &
+  {
+    m_storage.emplace(key, std::forward<T>(value));
+    return *this;
+  }
+
+  template<typename T>
+  SerializedObjectBuilder&& add(StringView key, T&& value) &&
+  {
+    m_storage.emplace(key, std::forward<T>(value));
+    return std::move(*this);
+  }
+
+  SerializedData build() &&
+  {
+    return SerializedData(std::move(m_storage));
+  }
+
+private:
+  DataStorage<SerializedType::Object> m_storage;
+};
+
+/**
+ * @brief Fluent construction of an array, every element is moved into place.
+ */
+class SerializedArrayBuilder
+{
+public:
+  explicit SerializedArrayBuilder(size_t reserve = 0)
+  {
+    m_storage.reserve(reserve);
+  }
+
+  template<typename T>
+  SerializedArrayBuilder& add(T&& value) &
+  {
+    m_storage.emplace_back(std::forward<T>(value));
+    return *this;
+  }
+
+  template<typename T>
+  SerializedArrayBuilder&& add(T&& value) &&
+  {
+    m_storage.emplace_back(std::forward<T>(value));
+    return std::move(*this);
+  }
+
+  SerializedData build() &&
+  {
+    return SerializedData(std::move(m_storage));
+  }
+
+private:
+  DataStorage<SerializedType::Array> m_storage;
+};
+
+inline SerializedObjectBuilder
+SerializedData::object_builder(size_t reserve)
+{
+  return SerializedObjectBuilder{reserve};
+}
+
+inline SerializedArrayBuilder
+SerializedData::array_builder(size_t reserve)
+{
+  return SerializedArrayBuilder{reserve};
+}
+
+} // namespace setsugen
@@ -21,19 +21,31 @@ public:
   using CRefSerialziedArray  = const DataStorage<SerializedType::Array>&;
   using CRefSerializedObject = const DataStorage<SerializedType::Object>&;
 
+  // Arrays and objects are shared by copies and cloned on the first mutable access, see `get_array` and `get_object`
+  using SharedArray  = Shared<DataStorage<SerializedType::Array>>;
+  using SharedObject = Shared<DataStorage<SerializedType::Object>>;
+
   using SerializedVariant = std::variant<   //
       DataStorage<SerializedType::Null>,    // NULL
       DataStorage<SerializedType::Bool>,    // BOOL
-      DataStorage<SerializedType::Array>,   // ARRAY
+      SharedArray,                          // ARRAY
       DataStorage<SerializedType::Float>,   // FLOAT
       DataStorage<SerializedType::Integer>, // INTEGER
-      DataStorage<SerializedType::Object>,  // OBJECT
+      SharedObject,                         // OBJECT
       DataStorage<SerializedType::String>   // STRING
       >;
 
   SerializedData() noexcept;
   SerializedData(Initializer<SerializedData> value, SerializedType type = SerializedType::Auto);
+
+  /**
+   * @brief Copies share the arrays and objects of `other` and take constant time, whatever the size of the tree.
+   */
   SerializedData(const SerializedData& other) noexcept;
+
+  /**
+   * @brief Takes the value of `other` and leaves it null.
+   */
   SerializedData(SerializedData&& other) noexcept;
 
   template<ScalarType T>
@@ -59,14 +71,28 @@ public:
   SerializedType get_type() const noexcept;
 
   size_t size() const;
+
+  /**
+   * @brief Structural hash, equal values hash equally. Object members hash the same in any order and integers hash
+   * like the equal float. Hashes of arrays and objects are cached, a write to a nested value resets the cached hashes
+   * of every container above it, also when it goes through a reference kept from before the hash was taken. Only
+   * references to the scalar storages returned by `get_bool`, `get_integer`, `get_float` and `get_string` must not be
+   * kept and written through later, take them again instead.
+   */
   size_t hash() const;
 
   DataStorage<SerializedType::Bool>&    get_bool();
   DataStorage<SerializedType::Integer>& get_integer();
   DataStorage<SerializedType::Float>&   get_float();
   DataStorage<SerializedType::String>&  get_string();
-  DataStorage<SerializedType::Array>&   get_array();
-  DataStorage<SerializedType::Object>&  get_object();
+
+  /**
+   * @brief Mutable access to a container, which is first cloned if it is shared with a copy. The clone shares the
+   * children, so writing to a nested value clones the containers on its path and nothing else. A mutable reference to
+   * a container must not be kept across a copy of its owner, writes through it would show in the copy.
+   */
+  DataStorage<SerializedType::Array>&  get_array();
+  DataStorage<SerializedType::Object>& get_object();
 
   const DataStorage<SerializedType::Bool>&    get_bool() const;
   const DataStorage<SerializedType::Integer>& get_integer() const;
@@ -99,9 +125,13 @@ public:
   static SerializedData integer(int64_t value);
   static SerializedData floating(Float64 value);
   static SerializedData string(const String& value);
+  static SerializedData string(String&& value);
   static SerializedData array(Initializer<SerializedData> value);
   static SerializedData object(Initializer<SerializedData> value);
 
+  static SerializedObjectBuilder object_builder(size_t reserve = 0);
+  static SerializedArrayBuilder  array_builder(size_t reserve = 0);
+
   template<ScalarType T>
   explicit operator T() const;
 
@@ -111,13 +141,62 @@ public:
   template<DeserializerFormat T>
   Void parse(InputStream& stream, const T& deserializer = T{});
 
+  /**
+   * @brief Parse an in-memory input, e.g. the view of a MappedFile. Formats without an overload for spans read it
+   * through a SpanInputStream, which does not copy it either.
+   */
+  template<DeserializerFormat T>
+  Void parse(StringView input, const T& deserializer = T{});
+
   template<Serializable T>
   Void serialize(T& value);
 
   template<Serializable T>
   Void deserialize(T& value);
 
+  /**
+   * @brief RFC 6902 JSON patch turning `from` into `to`, an array of add, remove and replace operations. Subtrees which
+   * are shared or whose hashes match are compared once and skipped, so the cost follows the changed values and not the
+   * size of the documents. Arrays are matched by their common prefix and suffix, the elements in between are diffed
+   * pairwise.
+   */
+  static SerializedData diff(const SerializedData& from, const SerializedData& to);
+
+  /**
+   * @brief RFC 7396 merge patch turning `from` into `to`. Merge patches delete members with null, so a member set to
+   * null in `to` comes out as a deletion and null members nested in added objects are lost.
+   */
+  static SerializedData merge_diff(const SerializedData& from, const SerializedData& to);
+
+  /**
+   * @brief Apply an RFC 6902 JSON patch in place. All six operations are supported, the patch is applied to a copy
+   * which replaces this value once every operation succeeded, so a failing patch leaves it untouched. A malformed
+   * operation throws an InvalidFormatException, a path which does not resolve or a failed test an
+   * InvalidArgumentException.
+   */
+  Void apply_patch(const SerializedData& patch);
+
+  /**
+   * @brief Apply an RFC 7396 merge patch in place. Members the patch does not change are left alone, they stay shared
+   * with copies and keep their cached hashes.
+   */
+  Void apply_merge_patch(const SerializedData& patch);
+
 private:
+  template<SerializedType>
+  friend class DataStorage;
+
+  // Cached hash of the array or object this value holds, null for a scalar
+  const SerializedHash* get_container_hash() const noexcept;
+
+  // Link the array or object this value holds to the container the value is a member of, so that writes to it reset
+  // the cached hashes above, or undo that link once the value lets go of it
+  Void attach() const noexcept;
+  Void detach() const noexcept;
+
+  Void invalidate_parent() const noexcept;
+  Void assign(SerializedVariant&& value) noexcept;
+
   Bool check_object_initializer(const Initializer<SerializedData>& list) const;
   Bool try_compare_object(const SerializedData& other) const;
   Bool try_compare_array(const SerializedData& other) const;
@@ -127,6 +206,9 @@ private:
   Bool try_compare_null(const SerializedData& other) const;
 
   SerializedVariant m_actual;
+
+  // Hash of the container this value is a member of, set by the container and kept when a new value is assigned
+  const SerializedHash* m_parent = nullptr;
 };
 
 
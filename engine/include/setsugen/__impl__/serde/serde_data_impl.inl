@@ -18,7 +18,7 @@ SerializedData::operator[](T&& key)
 
     if (key.get_type() == SerializedType::String)
     {
-      return (*this)[key.get_string().value()];
+      return (*this)[key.get_string().view()];
     }
 
     throw InvalidArgumentException("SerializedData::operator[] do not accept SerializedData with type {}",
@@ -52,7 +52,7 @@ setsugen::SerializedData::operator[](T&& key) const
 
     if (key.get_type() == SerializedType::String)
     {
-      return (*this)[key.get_string().value()];
+      return (*this)[key.get_string().view()];
     }
 
     throw InvalidArgumentException("SerializedData::operator[] do not accept SerializedData with type {}",
@@ -150,7 +150,14 @@ SerializedData::SerializedData(T value, SerializedType type)
 template<SerializedType Type>
 SerializedData::SerializedData(DataStorage<Type>&& data) noexcept
 {
-  m_actual = std::move(data);
+  if constexpr (Type == SerializedType::Array || Type == SerializedType::Object)
+  {
+    m_actual = std::make_shared<DataStorage<Type>>(std::move(data));
+  }
+  else
+  {
+    m_actual = std::move(data);
+  }
 }
 
 template<typename T>
@@ -207,6 +214,29 @@ SerializedData::operator T() const
   }
 }
 
+template<typename... Args>
+SerializedData&
+DataStorage<SerializedType::Array>::emplace_back(Args&&... args)
+{
+  m_hash.invalidate();
+  auto previous = m_arrays.data();
+  m_arrays.emplace_back(std::forward<Args>(args)...);
+  adopt_appended(previous);
+  return m_arrays.back();
+}
+
+template<typename... Args>
+SerializedData&
+DataStorage<SerializedType::Object>::emplace(StringView key, Args&&... args)
+{
+  auto& value = (*this)[key];
+  if constexpr (sizeof...(Args) > 0)
+  {
+    value = SerializedData(std::forward<Args>(args)...);
+  }
+  return value;
+}
+
 template<SerializerFormat T>
 Void
 SerializedData::dumps(OutputStream& stream, const T& serializer) const
@@ -221,17 +251,34 @@ SerializedData::parse(InputStream& stream, const T& deserializer)
   deserializer.deserialize(stream, *this);
 }
 
+template<DeserializerFormat T>
+Void
+SerializedData::parse(StringView input, const T& deserializer)
+{
+  if constexpr (requires { deserializer.deserialize(input, *this); })
+  {
+    deserializer.deserialize(input, *this);
+  }
+  else
+  {
+    SpanInputStream stream{input};
+    deserializer.deserialize(stream, *this);
+  }
+}
+
 template<Serializable T>
 Void
 SerializedData::serialize(T& value)
 {
   *this = object({});
 
-  for (auto& field: Reflection<T>{}.get_fields())
+  auto& fields = Reflection<T>{}.get_fields();
+  auto& object = get_object();
+  object.reserve(fields.size());
+
+  for (auto& field: fields)
   {
-    SerializedData tmp;
-    field.get_value(tmp, value);
-    (*this)[field.get_name()] = std::move(tmp);
+    field.get_value(object.emplace(field.get_name()), value);
   }
 }
 
@@ -262,7 +309,7 @@ template<IterableType T>
 requires ScalarType<typename T::value_type>
 SerializedData::SerializedData(const T& data)
 {
-  m_actual = DataStorage(data);
+  m_actual = std::make_shared<DataStorage<SerializedType::Array>>(data);
 }
 
 } // namespace setsugen
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "serde_fwd.inl"
+
+namespace setsugen
+{
+
+/**
+ * @brief Bump allocator backing a SerializedDocument.
+ * Memory is handed out from large chunks and never given back one allocation at a time, everything is released at
+ * once when the arena is cleared or destroyed. Only trivially destructible data may live in it.
+ */
+class SerializedArena
+{
+public:
+  static constexpr size_t default_chunk_size = 64 * 1024;
+
+  explicit SerializedArena(size_t chunk_size = default_chunk_size) noexcept;
+  SerializedArena(const SerializedArena&) = delete;
+  SerializedArena(SerializedArena&& other) noexcept;
+  ~SerializedArena() noexcept;
+
+  SerializedArena& operator=(const SerializedArena&) = delete;
+  SerializedArena& operator=(SerializedArena&& other) noexcept;
+
+  Void* allocate(size_t size, size_t alignment);
+
+  template<typename T>
+  T* allocate_array(size_t count)
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "Only trivially destructible types can live in the arena");
+    return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /**
+   * @brief Copy a string into the arena, the copy is null terminated.
+   */
+  StringView store(StringView value);
+
+  /**
+   * @brief Release every chunk but the first one, which is kept for the next document.
+   */
+  Void clear() noexcept;
+
+  size_t get_used_bytes() const noexcept;
+  size_t get_reserved_bytes() const noexcept;
+
+private:
+  struct Chunk
+  {
+    Owner<Byte[]> data;
+    size_t        size;
+  };
+
+  Void add_chunk(size_t min_size);
+
+  DArray<Chunk> m_chunks;
+  Byte*         m_cursor;
+  Byte*         m_end;
+  size_t        m_chunk_size;
+  size_t        m_used;
+};
+
+/**
+ * @brief A value of a SerializedDocument.
+ * Every node is 16 bytes: the type, the length of a string or the number of children of a container, and a payload
+ * which is either the scalar itself or a pointer into the arena. The children of a container are stored contiguously,
+ * an object stores a string node for the key followed by the value for every member. Strings borrowed from the input
+ * of a parser point outside of the arena and are not null terminated.
+ */
+struct DocumentNode
+{
+  SerializedType type = SerializedType::Null;
+  UInt32         size = 0;
+
+  union
+  {
+    Bool                boolean;
+    Int64               integer = 0;
+    Float64             floating;
+    const char*         string;
+    const DocumentNode* children;
+  };
+};
+
+static_assert(sizeof(DocumentNode) == 16, "DocumentNode must stay 16 bytes");
+
+class DocumentArrayView;
+class DocumentObjectView;
+
+/**
+ * @brief Read-only handle to a node of a SerializedDocument, as cheap to copy as a pointer.
+ * Mirrors the accessors of SerializedData, but scalars and strings are returned by value and containers as views.
+ * A view is valid as long as the document it points into is neither cleared nor destroyed.
+ */
+class DocumentView
+{
+public:
+  DocumentView() noexcept;
+  explicit DocumentView(const DocumentNode* node) noexcept;
+
+  SerializedType get_type() const noexcept;
+  size_t         size() const;
+
+  Bool               get_bool() const;
+  Int64              get_integer() const;
+  Float64            get_float() const;
+  StringView         get_string() const;
+  DocumentArrayView  get_array() const;
+  DocumentObjectView get_object() const;
+
+  DocumentView operator[](size_t index) const;
+  DocumentView operator[](StringView key) const;
+
+  explicit operator Bool() const noexcept;
+
+  /**
+   * @brief Deep copy of the node into a heap allocated SerializedData.
+   */
+  SerializedData to_serialized() const;
+
+  const DocumentNode* get_node() const noexcept;
+
+private:
+  const DocumentNode* m_node;
+};
+
+class DocumentArrayView
+{
+public:
+  class Iter
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = DocumentView;
+    using difference_type   = PtrDiff;
+    using pointer           = Void;
+    using reference         = DocumentView;
+
+    Iter() noexcept = default;
+    explicit Iter(const DocumentNode* node) noexcept : m_node{node}
+    {}
+
+    DocumentView operator*() const noexcept
+    {
+      return DocumentView{m_node};
+    }
+
+    Iter& operator++() noexcept
+    {
+      ++m_node;
+      return *this;
+    }
+
+    Iter operator++(Int32) noexcept
+    {
+      auto copy = *this;
+      ++m_node;
+      return copy;
+    }
+
+    Bool operator==(const Iter& other) const noexcept = default;
+
+  private:
+    const DocumentNode* m_node = nullptr;
+  };
+
+  explicit DocumentArrayView(const DocumentNode* node) noexcept;
+
+  size_t size() const noexcept;
+  Bool   empty() const noexcept;
+  Iter   begin() const noexcept;
+  Iter   end() const noexcept;
+
+  DocumentView operator[](size_t index) const;
+
+private:
+  const DocumentNode* m_node;
+};
+
+struct DocumentMember
+{
+  StringView   key;
+  DocumentView value;
+};
+
+/**
+ * @brief Members of an object node in the order they were added.
+ * Lookups scan the members linearly, which is what most documents with a handful of keys per object want. Convert
+ * the subtree with `to_serialized` before doing many lookups on a large object.
+ */
+class DocumentObjectView
+{
+public:
+  class Iter
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = DocumentMember;
+    using difference_type   = PtrDiff;
+    using pointer           = Void;
+    using reference         = DocumentMember;
+
+    Iter() noexcept = default;
+    explicit Iter(const DocumentNode* node) noexcept : m_node{node}
+    {}
+
+    DocumentMember operator*() const noexcept
+    {
+      return {StringView{m_node->string, m_node->size}, DocumentView{m_node + 1}};
+    }
+
+    Iter& operator++() noexcept
+    {
+      m_node += 2;
+      return *this;
+    }
+
+    Iter operator++(Int32) noexcept
+    {
+      auto copy = *this;
+      m_node += 2;
+      return copy;
+    }
+
+    Bool operator==(const Iter& other) const noexcept = default;
+
+  private:
+    const DocumentNode* m_node = nullptr;
+  };
+
+  explicit DocumentObjectView(const DocumentNode* node) noexcept;
+
+  size_t size() const noexcept;
+  Bool   empty() const noexcept;
+  Iter   begin() const noexcept;
+  Iter   end() const noexcept;
+
+  Bool                   has_key(StringView key) const noexcept;
+  Optional<DocumentView> find(StringView key) const noexcept;
+
+  /**
+   * @brief Value of the given key, throws an OutOfBoundsException if the object has no such key.
+   */
+  DocumentView operator[](StringView key) const;
+
+private:
+  const DocumentNode* m_node;
+};
+
+/**
+ * @brief Immutable document whose nodes, strings and containers all live in one arena.
+ * Building or parsing a document performs a handful of large allocations instead of one per value, and destroying or
+ * clearing it frees the arena chunks without visiting a single node. Use it for large read-mostly inputs such as level
+ * files, and SerializedData where the tree has to be edited.
+ */
+class SerializedDocument
+{
+public:
+  explicit SerializedDocument(size_t chunk_size = SerializedArena::default_chunk_size) noexcept;
+  SerializedDocument(const SerializedDocument&) = delete;
+  SerializedDocument(SerializedDocument&& other) noexcept;
+  ~SerializedDocument() noexcept;
+
+  SerializedDocument& operator=(const SerializedDocument&) = delete;
+  SerializedDocument& operator=(SerializedDocument&& other) noexcept;
+
+  DocumentView root() const noexcept;
+
+  /**
+   * @brief Drop the content. The views handed out so far dangle afterwards.
+   */
+  Void clear() noexcept;
+
+  SerializedArena&       get_arena() noexcept;
+  const SerializedArena& get_arena() const noexcept;
+
+  template<typename T>
+  Void parse(InputStream& stream, const T& deserializer = T{})
+  {
+    deserializer.deserialize(stream, *this);
+  }
+
+  /**
+   * @brief Parse an in-memory input, formats which support it borrow strings from `input` instead of copying them.
+   */
+  template<typename T>
+  Void parse(StringView input, const T& deserializer = T{})
+  {
+    deserializer.deserialize(input, *this);
+  }
+
+  static SerializedDocument from(const SerializedData& data);
+
+private:
+  friend class DocumentBuilder;
+
+  SerializedArena     m_arena;
+  const DocumentNode* m_root;
+};
+
+/**
+ * @brief Streaming construction of a SerializedDocument, used by the parsers.
+ * Values of the containers which are still open wait on a stack, a container is copied into the arena in one piece
+ * when it is closed, so its children end up contiguous. Inside an object, every value must be preceded by `key`.
+ * Keys are interned: objects sharing a shape, such as the elements of a large array, share the copies of their keys.
+ * Misuse throws an InvalidStateException.
+ */
+class DocumentBuilder
+{
+public:
+  explicit DocumentBuilder(SerializedDocument& document);
+
+  Void null();
+  Void boolean(Bool value);
+  Void integer(Int64 value);
+  Void floating(Float64 value);
+  Void string(StringView value);
+  Void key(StringView key);
+
+  /**
+   * @brief Same as `string` and `key`, but the bytes are referenced instead of copied and must outlive the document.
+   */
+  Void borrowed_string(StringView value);
+  Void borrowed_key(StringView key);
+
+  Void begin_array();
+  Void end_array();
+  Void begin_object();
+  Void end_object();
+
+  /**
+   * @brief Make the single top-level value the root of the document.
+   */
+  Void finish();
+
+private:
+  struct Frame
+  {
+    size_t start;
+    Bool   object;
+  };
+
+  static constexpr size_t key_cache_size    = 256;
+  static constexpr size_t max_interned_size = 64;
+
+  Void       push(const DocumentNode& node);
+  Void       push_key(StringView key);
+  Void       expect_value() const;
+  Void       close(SerializedType type);
+  StringView intern(StringView key);
+
+  SerializedDocument&               m_document;
+  DArray<DocumentNode>              m_stack;
+  DArray<Frame>                     m_frames;
+  Array<StringView, key_cache_size> m_keys;
+};
+
+} // namespace setsugen
@@ -21,6 +21,7 @@ enum class SerializedType : int8_t
 };
 
 class Json;
+class Sbf;
 class Toml;
 class Yaml;
 
@@ -28,5 +29,103 @@ template<SerializedType T>
 class DataStorage;
 class SerializedData;
 class SerializedField;
+class SerializedDocument;
+class SerializedVisitor;
+class SerializedObjectBuilder;
+class SerializedArrayBuilder;
+
+/**
+ * @brief Lazily computed structural hash of a container, zero until it has been computed.
+ * A copy has the same contents and keeps the value, a moved-from container is emptied and loses it. Every container
+ * links its hash to the hash of the container it is a member of, and a write anywhere below a container resets the
+ * hashes on the way up through `invalidate`. The values are atomic so that concurrent readers may compute them at the
+ * same time.
+ */
+class SerializedHash
+{
+public:
+  SerializedHash() noexcept = default;
+
+  SerializedHash(const SerializedHash& other) noexcept : m_value(other.get())
+  {}
+
+  SerializedHash(SerializedHash&& other) noexcept : m_value(other.get())
+  {
+    other.reset();
+  }
+
+  SerializedHash& operator=(const SerializedHash& other) noexcept
+  {
+    store(other.get());
+    return *this;
+  }
+
+  SerializedHash& operator=(SerializedHash&& other) noexcept
+  {
+    store(other.get());
+    other.reset();
+    return *this;
+  }
+
+  UInt64 get() const noexcept
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+  Void store(UInt64 value) const noexcept
+  {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+
+  Void reset() const noexcept
+  {
+    store(0);
+  }
+
+  /**
+   * @brief Reset this hash and the cached hashes of the containers above it.
+   * Computing a hash computes the hashes of the members first, so the walk stops at the first ancestor without a cached
+   * hash, everything above it has been reset already.
+   */
+  Void invalidate() const noexcept
+  {
+    reset();
+    for (auto parent = get_parent(); parent && parent->get(); parent = parent->get_parent())
+    {
+      parent->reset();
+    }
+  }
+
+  const SerializedHash* get_parent() const noexcept
+  {
+    return m_parent.load(std::memory_order_relaxed);
+  }
+
+  Void set_parent(const SerializedHash* parent) const noexcept
+  {
+    m_parent.store(parent, std::memory_order_relaxed);
+  }
+
+  // Unlinks the container from `parent` unless another holder has linked it elsewhere in the meantime
+  Void detach(const SerializedHash* parent) const noexcept
+  {
+    m_parent.compare_exchange_strong(parent, nullptr, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Finalizer of splitmix64, spreads every input bit over the whole hash and never returns zero for a non-zero
+   * input, so combined hashes stay distinguishable from an empty cache.
+   */
+  static constexpr UInt64 mix(UInt64 value) noexcept
+  {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+  }
+
+private:
+  mutable Atomic<UInt64>                m_value{0};
+  mutable Atomic<const SerializedHash*> m_parent{nullptr};
+};
 
 } // namespace setsugen
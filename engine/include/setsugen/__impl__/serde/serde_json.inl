@@ -24,11 +24,29 @@ public:
     } deserializer_config;
   };
 
+  /**
+   * @brief Numbers too small for a 64-bit float are read as a zero of their sign, numbers too large for one are
+   * rejected with `InvalidSyntaxException` since JSON has no infinities to stand for them.
+   */
   Json() noexcept;
   Json(const Configurations& config) noexcept;
 
   Void serialize(OutputStream& stream, const SerializedData& data) const;
   Void deserialize(InputStream& stream, SerializedData& data) const;
+  Void deserialize(StringView input, SerializedData& data) const;
+  Void deserialize(InputStream& stream, SerializedDocument& document) const;
+
+  /**
+   * @brief Parse an in-memory document, e.g. a mapped file. Strings without escapes are not copied but point into
+   * `input`, which has to outlive the document.
+   */
+  Void deserialize(StringView input, SerializedDocument& document) const;
+
+  /**
+   * @brief Stream the values of a document to `visitor` without building it, in memory bounded by the nesting depth.
+   */
+  Void deserialize(InputStream& stream, SerializedVisitor& visitor) const;
+  Void deserialize(StringView input, SerializedVisitor& visitor) const;
 
 private:
   Configurations m_config;
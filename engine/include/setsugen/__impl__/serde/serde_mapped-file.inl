@@ -0,0 +1,54 @@
+#pragma once
+
+#include "serde_fwd.inl"
+
+namespace setsugen
+{
+
+/**
+ * @brief Read-only memory mapping of a whole file, the input of the parsers which read spans.
+ * The pages are mapped on demand and hinted to be read sequentially, nothing is copied into a stream buffer. Strings a
+ * parser borrows from the mapping, e.g. into a SerializedDocument, are valid as long as the file stays mapped. Missing
+ * or unreadable files throw a FileNotFoundException.
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const String& path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  ~MappedFile() noexcept;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  const char* data() const noexcept;
+  size_t      size() const noexcept;
+  StringView  view() const noexcept;
+
+private:
+  Void unmap() noexcept;
+
+  const char* m_data;
+  size_t      m_size;
+};
+
+/**
+ * @brief Input stream reading a span in place, for the formats which only parse streams.
+ */
+class SpanInputStream : public InputStream
+{
+public:
+  explicit SpanInputStream(StringView input);
+
+private:
+  class Buffer : public std::streambuf
+  {
+  public:
+    explicit Buffer(StringView input);
+  };
+
+  Buffer m_buffer;
+};
+
+} // namespace setsugen
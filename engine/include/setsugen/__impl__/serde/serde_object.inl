@@ -5,12 +5,21 @@
 namespace setsugen
 {
 
+/**
+ * @brief Members of an object, kept in insertion order.
+ * The members live in one contiguous array which small objects scan linearly, so a 3 field object costs a single
+ * allocation and no hashing. Past `index_threshold` members an open addressing table of member positions is built next
+ * to the array and lookups hash the key instead. Keys must not be modified through the iterators.
+ */
 template<>
 class DataStorage<SerializedType::Object>
 {
 public:
-  using Iter  = UnorderedMap<String, SerializedData>::iterator;
-  using CIter = UnorderedMap<String, SerializedData>::const_iterator;
+  using Entry = std::pair<String, SerializedData>;
+  using Iter  = DArray<Entry>::iterator;
+  using CIter = DArray<Entry>::const_iterator;
+
+  static constexpr size_t index_threshold = 8;
 
   DataStorage();
   DataStorage(const DataStorage& other);
@@ -20,19 +29,84 @@ public:
   DataStorage& operator=(const DataStorage& other);
   DataStorage& operator=(DataStorage&& other) noexcept;
 
-  SerializedData&       operator[](const String& key);
-  const SerializedData& operator[](const String& key) const;
+  /**
+   * @brief Value of the given key, a null value is appended if the object has no such key.
+   */
+  SerializedData& operator[](StringView key);
+
+  /**
+   * @brief Value of the given key, throws an OutOfBoundsException if the object has no such key.
+   */
+  const SerializedData& operator[](StringView key) const;
+
+  /**
+   * @brief Set the value of `key` to a SerializedData constructed from `args` and return it. Passing a SerializedData
+   * rvalue moves the subtree in, with no arguments the value is null and can be filled in place.
+   */
+  template<typename... Args>
+  SerializedData& emplace(StringView key, Args&&... args);
+
+  Bool                  has_key(StringView key) const;
+  SerializedData*       find(StringView key);
+  const SerializedData* find(StringView key) const;
+
+  /**
+   * @brief Lookup with a hash computed beforehand by `key_hash`, so that keys looked up repeatedly are hashed once.
+   */
+  SerializedData*       find(StringView key, UInt32 hash);
+  const SerializedData* find(StringView key, UInt32 hash) const;
+
+  static UInt32 key_hash(StringView key);
 
-  Bool has_key(const String& key) const;
+  DataStorage& erase(StringView key);
+  DataStorage& clear();
+  DataStorage& reserve(size_t size);
 
+  Bool   empty() const;
   size_t size() const;
   Iter   begin();
   Iter   end();
   CIter  begin() const;
   CIter  end() const;
 
+  /**
+   * @brief Structural hash of the members which does not depend on their order, cached until the object is next
+   * accessed mutably.
+   */
+  UInt64 hash() const;
+
+  /**
+   * @brief Two objects are equal when they have the same keys with equal values, in any order. Objects whose hashes are
+   * both cached and differ are unequal without a traversal.
+   */
+  Bool operator==(const DataStorage& other) const;
+
 private:
-  UnorderedMap<String, SerializedData> m_map;
+  friend class SerializedData;
+
+  // A slot holds the position of a member plus one, zero marks an empty slot, and the low bits of the key hash so that
+  // neither probing nor growing the table has to look at the keys
+  struct Slot
+  {
+    UInt32 position = 0;
+    UInt32 hash     = 0;
+  };
+
+  size_t find_position(StringView key) const;
+  size_t find_position(StringView key, UInt32 hash) const;
+  size_t find_indexed(StringView key, UInt32 hash) const;
+  Void   rebuild_index();
+  Void   resize_index(size_t capacity);
+  Void   insert_index(size_t position, UInt32 hash);
+
+  // Every value points at the hash of its object, redone whenever the members move in memory
+  Void adopt(SerializedData& data) noexcept;
+  Void adopt() noexcept;
+  Void adopt_appended(const Entry* previous) noexcept;
+
+  DArray<Entry>  m_entries;
+  DArray<Slot>   m_index;
+  SerializedHash m_hash;
 };
 
 } // namespace setsugen
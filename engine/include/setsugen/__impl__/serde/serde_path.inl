@@ -0,0 +1,145 @@
+#pragma once
+
+#include "serde_data.inl"
+
+namespace setsugen
+{
+
+/**
+ * @brief Location of values inside a SerializedData tree, compiled once and resolved without allocating.
+ * A path is parsed either from an RFC 6901 JSON pointer (`/items/0/id`, `~1` escapes `/` and `~0` escapes `~`) or from
+ * a dotted path (`items[0].id`, `window.width`). In a dotted path `*` or `[*]` matches every member or element of a
+ * container, such paths can only be evaluated with `for_each` or `select`. The keys are hashed when the path is
+ * compiled, so looking them up in objects large enough to be indexed does not hash them again.
+ */
+class SerializedPath
+{
+public:
+  static constexpr size_t no_index = static_cast<size_t>(-1);
+
+  struct Segment
+  {
+    String key;
+    UInt32 hash     = 0;
+    size_t index    = no_index; // Set when the key is a valid array index as well
+    Bool   wildcard = false;
+  };
+
+  SerializedPath() = default;
+
+  /**
+   * @brief Compile a JSON pointer if `path` is empty or starts with `/`, a dotted path otherwise.
+   */
+  SerializedPath(StringView path);
+  SerializedPath(const char* path);
+  SerializedPath(const String& path);
+
+  static SerializedPath pointer(StringView pointer);
+  static SerializedPath dotted(StringView path);
+
+  /**
+   * @brief The value at this path, or nullptr if it does not exist. Throws an InvalidOperationException for a path
+   * with wildcards.
+   */
+  SerializedData*       resolve(SerializedData& root) const;
+  const SerializedData* resolve(const SerializedData& root) const;
+
+  /**
+   * @brief Call `visitor` with every value matched by this path, in document order.
+   */
+  template<typename F>
+  Void for_each(SerializedData& root, F&& visitor) const;
+
+  template<typename F>
+  Void for_each(const SerializedData& root, F&& visitor) const;
+
+  DArray<const SerializedData*> select(const SerializedData& root) const;
+
+  Bool                   empty() const noexcept;
+  size_t                 size() const noexcept;
+  Bool                   has_wildcard() const noexcept;
+  const DArray<Segment>& get_segments() const noexcept;
+
+  String to_pointer() const;
+
+private:
+  SerializedPath& append(String&& key, Bool wildcard);
+
+  template<typename Data>
+  static Data* step(Data& node, const Segment& segment);
+
+  template<typename Data, typename F>
+  static Void visit(Data& node, const Segment* segment, const Segment* end, F& visitor);
+
+  DArray<Segment> m_segments;
+  Bool            m_wildcard = false;
+};
+
+template<typename Data>
+Data*
+SerializedPath::step(Data& node, const Segment& segment)
+{
+  if (node.get_type() == SerializedType::Object)
+  {
+    return node.get_object().find(segment.key, segment.hash);
+  }
+
+  if (node.get_type() == SerializedType::Array && segment.index < node.get_array().size())
+  {
+    return &node.get_array()[segment.index];
+  }
+
+  return nullptr;
+}
+
+template<typename Data, typename F>
+Void
+SerializedPath::visit(Data& node, const Segment* segment, const Segment* end, F& visitor)
+{
+  Data* current = &node;
+  for (; segment != end && !segment->wildcard; ++segment)
+  {
+    current = step(*current, *segment);
+    if (!current)
+    {
+      return;
+    }
+  }
+
+  if (segment == end)
+  {
+    visitor(*current);
+    return;
+  }
+
+  if (current->get_type() == SerializedType::Object)
+  {
+    for (auto& [key, value]: current->get_object())
+    {
+      visit(value, segment + 1, end, visitor);
+    }
+  }
+  else if (current->get_type() == SerializedType::Array)
+  {
+    for (auto& value: current->get_array())
+    {
+      visit(value, segment + 1, end, visitor);
+    }
+  }
+}
+
+template<typename F>
+Void
+SerializedPath::for_each(SerializedData& root, F&& visitor) const
+{
+  visit(root, m_segments.data(), m_segments.data() + m_segments.size(), visitor);
+}
+
+template<typename F>
+Void
+SerializedPath::for_each(const SerializedData& root, F&& visitor) const
+{
+  visit(root, m_segments.data(), m_segments.data() + m_segments.size(), visitor);
+}
+
+} // namespace setsugen
@@ -5,11 +5,210 @@
 namespace setsugen
 {
 
+/**
+ * @brief SBF, the setsugen binary format.
+ * A buffer is a header, a table of the distinct strings and the root value. Fixed width fields are little endian,
+ * varints are LEB128.
+ * - Header: the magic `SBF` and the version byte.
+ * - String table: the varint count and byte size of the strings, one 32-bit offset per string, the ids in string order,
+ *   then every string as its varint length and its bytes. Keys and string values are stored once, ids follow the order
+ *   they are first met in and a string is found by binary search over the ids in string order.
+ * - Value: a tag byte and its payload. Integers are zigzag varints, floats 4 bytes when they are exact as 32-bit floats
+ *   and 8 otherwise, strings the varint id of their table entry. Arrays and objects are their varint element count and
+ *   the varint byte size of the rest of the container, so that a reader skips a subtree without decoding it, then their
+ *   elements. An object member is the varint id of its key followed by the value.
+ * - Index: indexed containers have their own tags and start with one 32-bit offset per element, relative to the first
+ *   element. Objects store the key id before each offset and sort the entries by key id, so a member is found by
+ *   binary search.
+ * Malformed input throws an InvalidFormatException.
+ */
 class Sbf
 {
 public:
-  Void serialize(OutputStream& stream, const SerializedData& data);
-  Void deserialize(InputStream& stream, SerializedData& data);
+  struct Configurations
+  {
+    /**
+     * @brief Write the offset index for containers of 8 elements or more, which makes them randomly accessible for 4
+     * bytes per array element and 8 per object member. Smaller containers are scanned as fast as they are searched.
+     */
+    Bool indexed = false;
+  };
+
+  Sbf() noexcept;
+  Sbf(const Configurations& config) noexcept;
+
+  Void serialize(OutputStream& stream, const SerializedData& data) const;
+  Void deserialize(InputStream& stream, SerializedData& data) const;
+
+  /**
+   * @brief Decode an in-memory buffer, e.g. the view of a MappedFile.
+   */
+  Void deserialize(StringView input, SerializedData& data) const;
+
+private:
+  Configurations m_config;
+};
+
+class SbfArrayView;
+class SbfObjectView;
+
+/**
+ * @brief Read-only handle to a value of an SBF buffer, navigated in place without decoding the buffer.
+ * Mirrors DocumentView: scalars are read when they are asked for, strings point into the string table of the buffer and
+ * containers are views. Indexed containers are accessed in constant time by index and in logarithmic time by key, the
+ * others skip from one element to the next by their byte sizes. A view is valid as long as its buffer, e.g. the view of
+ * a MappedFile, is alive. Malformed data throws an InvalidFormatException when it is reached.
+ */
+class SbfView
+{
+public:
+  SbfView() noexcept;
+
+  /**
+   * @brief View of the root value of `buffer`, whose header and string table are checked.
+   */
+  explicit SbfView(StringView buffer);
+  SbfView(const char* table, const char* end, const char* value) noexcept;
+
+  SerializedType get_type() const;
+  size_t         size() const;
+
+  Bool          get_bool() const;
+  Int64         get_integer() const;
+  Float64       get_float() const;
+  StringView    get_string() const;
+  SbfArrayView  get_array() const;
+  SbfObjectView get_object() const;
+
+  SbfView operator[](size_t index) const;
+  SbfView operator[](StringView key) const;
+
+  explicit operator Bool() const;
+
+  /**
+   * @brief Deep copy of the value into a heap allocated SerializedData.
+   */
+  SerializedData to_serialized() const;
+
+private:
+  UInt8 get_tag() const;
+
+  const char* m_table;
+  const char* m_end;
+  const char* m_value;
+};
+
+class SbfArrayView
+{
+public:
+  class Iter
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = SbfView;
+    using difference_type   = PtrDiff;
+    using pointer           = Void;
+    using reference         = SbfView;
+
+    Iter() noexcept = default;
+    Iter(const char* table, const char* end, const char* position, const char* last) noexcept;
+
+    SbfView operator*() const noexcept;
+    Iter&   operator++();
+    Iter    operator++(Int32);
+
+    Bool operator==(const Iter& other) const noexcept = default;
+
+  private:
+    const char* m_table    = nullptr;
+    const char* m_end      = nullptr;
+    const char* m_position = nullptr;
+    const char* m_last     = nullptr;
+  };
+
+  SbfArrayView(const char* table, const char* end, const char* value);
+
+  size_t size() const noexcept;
+  Bool   empty() const noexcept;
+  Iter   begin() const noexcept;
+  Iter   end() const noexcept;
+
+  /**
+   * @brief Element at `index`, read from the offset index when the array has one and reached by skipping the elements
+   * before it otherwise.
+   */
+  SbfView operator[](size_t index) const;
+
+private:
+  const char* m_table;
+  const char* m_end;
+  const char* m_index;
+  const char* m_first;
+  const char* m_last;
+  size_t      m_count;
+};
+
+struct SbfMember
+{
+  StringView key;
+  SbfView    value;
+};
+
+/**
+ * @brief Members of an object value in the order they were written.
+ * A key is looked up once in the string table, then found by binary search in the offset index or by comparing string
+ * ids member by member.
+ */
+class SbfObjectView
+{
+public:
+  class Iter
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = SbfMember;
+    using difference_type   = PtrDiff;
+    using pointer           = Void;
+    using reference         = SbfMember;
+
+    Iter() noexcept = default;
+    Iter(const char* table, const char* end, const char* position, const char* last) noexcept;
+
+    SbfMember operator*() const;
+    Iter&     operator++();
+    Iter      operator++(Int32);
+
+    Bool operator==(const Iter& other) const noexcept = default;
+
+  private:
+    const char* m_table    = nullptr;
+    const char* m_end      = nullptr;
+    const char* m_position = nullptr;
+    const char* m_last     = nullptr;
+  };
+
+  SbfObjectView(const char* table, const char* end, const char* value);
+
+  size_t size() const noexcept;
+  Bool   empty() const noexcept;
+  Iter   begin() const noexcept;
+  Iter   end() const noexcept;
+
+  Bool              has_key(StringView key) const;
+  Optional<SbfView> find(StringView key) const;
+
+  /**
+   * @brief Value of the given key, throws an OutOfBoundsException if the object has no such key.
+   */
+  SbfView operator[](StringView key) const;
+
+private:
+  const char* m_table;
+  const char* m_end;
+  const char* m_index;
+  const char* m_first;
+  const char* m_last;
+  size_t      m_count;
 };
 
 } // namespace setsugen
@@ -28,7 +28,12 @@ public:
 
   Bool operator!=(const DataStorage& other) const;
 
-  String value() const noexcept;
+  const String& value() const noexcept;
+
+  /**
+   * @brief The string without copying it, valid until the value is modified or destroyed.
+   */
+  StringView view() const noexcept;
 
 private:
   String m_value;
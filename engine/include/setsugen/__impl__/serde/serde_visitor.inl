@@ -0,0 +1,51 @@
+#pragma once
+
+#include "serde_fwd.inl"
+
+namespace setsugen
+{
+
+/**
+ * @brief Receives the values of a document as a parser reads them, without anything being materialized.
+ * Events arrive in document order. A container is reported by its begin event, then its values, each preceded by
+ * `on_key` inside an object, and then its end event. Strings and keys point into the parser buffers and are only valid
+ * during the call. Every handler does nothing by default, so a visitor only overrides the events it is interested in,
+ * and an exception thrown by a handler aborts the parse.
+ */
+class SerializedVisitor
+{
+public:
+  virtual ~SerializedVisitor() = default;
+
+  virtual Void on_null()
+  {}
+
+  virtual Void on_bool(Bool /*value*/)
+  {}
+
+  virtual Void on_int(Int64 /*value*/)
+  {}
+
+  virtual Void on_float(Float64 /*value*/)
+  {}
+
+  virtual Void on_string(StringView /*value*/)
+  {}
+
+  virtual Void on_key(StringView /*key*/)
+  {}
+
+  virtual Void on_object_begin()
+  {}
+
+  virtual Void on_object_end()
+  {}
+
+  virtual Void on_array_begin()
+  {}
+
+  virtual Void on_array_end()
+  {}
+};
+
+} // namespace setsugen
@@ -0,0 +1,11 @@
+#pragma once
+
+// IWYU pragma: begin_exports
+
+#include "./__impl__/async/async_fwd.inl"
+
+#include "./__impl__/async/async_task.inl"
+#include "./__impl__/async/async_future.inl"
+#include "./__impl__/async/async_when.inl"
+
+// IWYU pragma: end_exports
@@ -4,6 +4,7 @@
 
 // Setsugen headers
 #include <setsugen/application.h>
+#include <setsugen/async.h>
 #include <setsugen/camera.h>
 #include <setsugen/chrono.h>
 #include <setsugen/component.h>
@@ -2,16 +2,207 @@
 
 #include <setsugen/pch.h>
 
+#include <coroutine>
+#include <stop_token>
+#include <utility>
+
 #include "setsugen/exception.h"
 
+#include "./__impl__/executor/executor_stats.inl"
+
 namespace setsugen
 {
 
+/**
+ * @brief Move-only callable wrapper with small buffer optimization
+ * Callables which fit in `Capacity` bytes and are nothrow move constructible are stored inline, so wrapping a small
+ * lambda does not allocate. Bigger callables fall back to a single heap allocation.
+ * Unlike `Fn`, the wrapped callable does not need to be copyable, which lets tasks own promises and other move-only
+ * state.
+ *
+ * @tparam Signature
+ * @tparam Capacity
+ */
+template<typename Signature, size_t Capacity = 64>
+class InplaceFn;
+
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFn<R(Args...), Capacity>
+{
+public:
+  InplaceFn() noexcept = default;
+
+  InplaceFn(std::nullptr_t) noexcept
+  {}
+
+  template<typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, InplaceFn> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  InplaceFn(F&& func)
+  {
+    using Callable = std::decay_t<F>;
+
+    if constexpr (stored_inline<Callable>)
+    {
+      new (m_storage) Callable(std::forward<F>(func));
+    }
+    else
+    {
+      new (m_storage) Callable*(new Callable(std::forward<F>(func)));
+    }
+
+    m_vtable = &vtable_for<Callable>;
+  }
+
+  InplaceFn(InplaceFn&& other) noexcept
+  {
+    move_from(other);
+  }
+
+  InplaceFn(const InplaceFn&) = delete;
+
+  ~InplaceFn()
+  {
+    reset();
+  }
+
+  InplaceFn& operator=(InplaceFn&& other) noexcept
+  {
+    if (this != &other)
+    {
+      reset();
+      move_from(other);
+    }
+    return *this;
+  }
+
+  InplaceFn& operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  InplaceFn& operator=(const InplaceFn&) = delete;
+
+  R operator()(Args... args)
+  {
+    return m_vtable->invoke(m_storage, std::forward<Args>(args)...);
+  }
+
+  explicit operator Bool() const noexcept
+  {
+    return m_vtable != nullptr;
+  }
+
+  Bool operator==(std::nullptr_t) const noexcept
+  {
+    return m_vtable == nullptr;
+  }
+
+  template<typename F>
+  static constexpr Bool stored_inline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+private:
+  struct VTable
+  {
+    R (*invoke)(Void* storage, Args&&... args);
+    Void (*move)(Void* dst, Void* src) noexcept;
+    Void (*destroy)(Void* storage) noexcept;
+  };
+
+  template<typename F>
+  static F& target(Void* storage) noexcept
+  {
+    if constexpr (stored_inline<F>)
+    {
+      return *std::launder(reinterpret_cast<F*>(storage));
+    }
+    else
+    {
+      return **std::launder(reinterpret_cast<F**>(storage));
+    }
+  }
+
+  template<typename F>
+  static constexpr VTable vtable_for = {
+      .invoke = [](Void* storage, Args&&... args) -> R
+      { return std::invoke(target<F>(storage), std::forward<Args>(args)...); },
+      .move =
+          [](Void* dst, Void* src) noexcept
+      {
+        if constexpr (stored_inline<F>)
+        {
+          new (dst) F(std::move(target<F>(src)));
+          target<F>(src).~F();
+        }
+        else
+        {
+          new (dst) F*(&target<F>(src));
+        }
+      },
+      .destroy =
+          [](Void* storage) noexcept
+      {
+        if constexpr (stored_inline<F>)
+        {
+          target<F>(storage).~F();
+        }
+        else
+        {
+          delete &target<F>(storage);
+        }
+      },
+  };
+
+  Void move_from(InplaceFn& other) noexcept
+  {
+    if (other.m_vtable)
+    {
+      other.m_vtable->move(m_storage, other.m_storage);
+      m_vtable = std::exchange(other.m_vtable, nullptr);
+    }
+  }
+
+  Void reset() noexcept
+  {
+    if (m_vtable)
+    {
+      std::exchange(m_vtable, nullptr)->destroy(m_storage);
+    }
+  }
+
+  alignas(std::max_align_t) Byte m_storage[Capacity];
+  const VTable*                  m_vtable = nullptr;
+};
+
+/**
+ * @brief Scheduling lane of a task.
+ * Workers always drain higher lanes first: a critical task overtakes every queued normal and background task, and a
+ * background task only runs when nothing else is queued. Tasks within a lane run in submission order.
+ */
+enum class TaskPriority
+{
+  Critical,
+  Normal,
+  Background,
+};
+
+inline constexpr size_t task_priority_count = 3;
+
+/**
+ * @brief Point in time a task should be finished by.
+ * A task which finishes after its deadline is counted as late, see `Executor::get_late_tasks`.
+ */
+using TaskDeadline = std::chrono::steady_clock::time_point;
+
 /**
  * @brief Executors class
  * Call static method `create` to create an instance of the executor.
- * Supported executors are FixedThreadPoolExecutor, SingleThreadExecutor, and CachedThreadPoolExecutor.
+ * Supported executors are FixedThreadPoolExecutor, WorkStealingExecutor, SingleThreadExecutor, and
+ * CachedThreadPoolExecutor.
  *  - FixedThreadPoolExecutor: A fixed-size thread pool executor.
+ *  - WorkStealingExecutor: A fixed-size thread pool executor where each worker owns a task deque and idle workers
+ * steal from busy ones.
  *  - SingleThreadExecutor: A single thread executor. It executes tasks in a single thread.
  *  - CachedThreadPoolExecutor: A thread pool executor that creates new threads as needed, but will reuse previously
  * constructed threads when they are available.
@@ -22,34 +213,242 @@ template<class ExecutorTarget>
 class Executor
 {
 public:
-  using ExecutorTask = Fn<Void(Bool)>;
+  using ExecutorTask = InplaceFn<Void(Bool)>;
 
   virtual ~Executor() = default;
 
+  /**
+   * @brief Submit a task and get a future to its result.
+   * The callable and its arguments are moved into the task, so small tasks are stored inline and the only allocations
+   * on this path are made by the promise backing the returned future.
+   * If the executor is stopped before the task runs, the future receives an InvalidStateException.
+   */
   template<typename F, typename... Args>
-    requires CallableType<F>
+    requires CallableType<F, Args...>
   auto submit(F&& func, Args&&... args)
+  {
+    return submit(TaskPriority::Normal, std::forward<F>(func), std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Submit a task to the given lane and get a future to its result.
+   */
+  template<typename F, typename... Args>
+    requires CallableType<F, Args...>
+  auto submit(TaskPriority priority, F&& func, Args&&... args)
   {
     using ReturnType = std::invoke_result_t<F, Args...>;
 
-    std::function<ReturnType()> binder = std::bind(std::forward<F>(func), std::forward<Args>(args)...);
+    std::promise<ReturnType> promise;
+    auto                     future = promise.get_future();
 
-    auto ptask = std::make_shared<std::packaged_task<ReturnType(Bool)>>(
-        [binder](auto stopped)
-        {
-          if (stopped)
-          {
-            throw InvalidStateException{"Executor is stopped"};
-          }
+    enqueue(instrument([promise = std::move(promise), func = std::forward<F>(func),
+                        ... args = std::forward<Args>(args)](Bool stopped) mutable
+                       {
+                         if (stopped)
+                         {
+                           promise.set_exception(std::make_exception_ptr(InvalidStateException{"Executor is stopped"}));
+                           return;
+                         }
+
+                         try
+                         {
+                           if constexpr (std::is_void_v<ReturnType>)
+                           {
+                             std::invoke(std::move(func), std::move(args)...);
+                             promise.set_value();
+                           }
+                           else
+                           {
+                             promise.set_value(std::invoke(std::move(func), std::move(args)...));
+                           }
+                         }
+                         catch (...)
+                         {
+                           promise.set_exception(std::current_exception());
+                         }
+                       }),
+            priority);
+
+    return future;
+  }
+
+  /**
+   * @brief Submit a task to the given lane which should be finished by `deadline`.
+   * The deadline does not reorder tasks, it is checked when the task finishes and a task finishing late is counted in
+   * `get_late_tasks`. Frame work usually goes to the critical lane with the end of the frame as its deadline.
+   */
+  template<typename F, typename... Args>
+    requires CallableType<F, Args...>
+  auto submit(TaskPriority priority, TaskDeadline deadline, F&& func, Args&&... args)
+  {
+    return submit(priority, with_deadline(deadline, std::forward<F>(func)), std::forward<Args>(args)...);
+  }
 
-          return binder();
-        });
+  /**
+   * @brief Submit a task without a future.
+   * This is the cheapest way to run work on the executor: a task whose captures fit in the inline buffer does not
+   * allocate at all. Tasks which are still queued when the executor stops are dropped without running.
+   * Exceptions escaping the task are discarded, use `submit` if the caller needs to observe them.
+   */
+  template<typename F, typename... Args>
+    requires CallableType<F, Args...>
+  Void submit_detached(F&& func, Args&&... args)
+  {
+    submit_detached(TaskPriority::Normal, std::forward<F>(func), std::forward<Args>(args)...);
+  }
 
-    auto future = ptask->get_future();
+  template<typename F, typename... Args>
+    requires CallableType<F, Args...>
+  Void submit_detached(TaskPriority priority, F&& func, Args&&... args)
+  {
+    enqueue(instrument([func = std::forward<F>(func), ... args = std::forward<Args>(args)](Bool stopped) mutable
+                       {
+                         if (stopped)
+                         {
+                           return;
+                         }
 
-    enqueue([ptask](Bool stopped) { (*ptask)(stopped); });
+                         try
+                         {
+                           std::invoke(std::move(func), std::move(args)...);
+                         }
+                         catch (...)
+                         {}
+                       }),
+            priority);
+  }
 
-    return future;
+  template<typename F, typename... Args>
+    requires CallableType<F, Args...>
+  Void submit_detached(TaskPriority priority, TaskDeadline deadline, F&& func, Args&&... args)
+  {
+    submit_detached(priority, with_deadline(deadline, std::forward<F>(func)), std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Number of tasks submitted with a deadline which finished after it.
+   */
+  UInt64 get_late_tasks() const
+  {
+    return m_late_tasks.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Snapshot of the counters and histograms of the executor.
+   * Cheap enough to call once per frame: it copies a few kilobytes of relaxed atomics and never blocks the workers.
+   * Counters accumulate over restarts until `reset_stats` is called.
+   */
+  ExecutorStats stats() const
+  {
+    auto stats       = m_metrics.snapshot();
+    stats.late_tasks = get_late_tasks();
+    return stats;
+  }
+
+  Void reset_stats() noexcept
+  {
+    m_metrics.reset();
+    m_late_tasks.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Switch the wait time, run time and idle time histograms on or off, they are on by default.
+   * Each of them reads the clock on the task path, turning them off leaves only counters to pay for.
+   */
+  Void set_timing_enabled(Bool enabled) noexcept
+  {
+    m_metrics.set_timing(enabled);
+  }
+
+  Bool is_timing_enabled() const noexcept
+  {
+    return m_metrics.is_timing();
+  }
+
+  /**
+   * @brief Token which is signalled by `force_stop`.
+   * Long running tasks poll it to give up early instead of keeping `join` waiting. A new token is handed out after the
+   * executor is started again.
+   */
+  std::stop_token get_stop_token() const noexcept
+  {
+    return m_stop_source.get_token();
+  }
+
+  /**
+   * @brief Let the queued tasks run for up to `timeout`, then stop the executor.
+   * If the queue drains in time the executor is stopped with `stop`, otherwise with `force_stop`, which cancels the
+   * remaining tasks and signals the stop token to the running ones. Returns whether the queue drained. Tasks submitted
+   * while draining are accepted and have to fit in the same timeout. Call `join` afterwards to wait for the running
+   * tasks.
+   */
+  Bool drain_and_stop(std::chrono::milliseconds timeout)
+  {
+    m_drain_waiters.fetch_add(1, std::memory_order_seq_cst);
+    wait_for_drain(std::chrono::steady_clock::now() + timeout);
+    m_drain_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+    if (is_queue_empty())
+    {
+      stop();
+      return true;
+    }
+
+    force_stop();
+    return false;
+  }
+
+  /**
+   * @brief Awaitable returned by `schedule`.
+   */
+  class ScheduleOperation
+  {
+  public:
+    ScheduleOperation(Executor& executor, TaskPriority priority) noexcept
+        : m_executor{&executor}, m_priority{priority}, m_cancelled{false}
+    {}
+
+    Bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    Void await_suspend(std::coroutine_handle<> handle)
+    {
+      // The coroutine may be resumed, and even destroyed, before enqueue returns, so nothing is touched afterwards
+      m_executor->enqueue(m_executor->instrument(
+                              [this, handle](Bool stopped)
+                              {
+                                m_cancelled = stopped;
+                                handle.resume();
+                              }),
+                          m_priority);
+    }
+
+    Void await_resume() const
+    {
+      if (m_cancelled)
+      {
+        throw InvalidStateException("Executor is stopped");
+      }
+    }
+
+  private:
+    Executor*    m_executor;
+    TaskPriority m_priority;
+    Bool         m_cancelled;
+  };
+
+  /**
+   * @brief Move the awaiting coroutine onto the executor.
+   * `co_await executor.schedule()` suspends the coroutine and resumes it on one of the executor's threads, no thread
+   * is blocked in between. If the executor is stopped before the coroutine gets resumed, the `co_await` expression
+   * throws an InvalidStateException. The rest of the coroutine is queued on the given lane.
+   */
+  ScheduleOperation schedule(TaskPriority priority = TaskPriority::Normal) noexcept
+  {
+    return ScheduleOperation{*this, priority};
   }
 
   template<typename... Args>
@@ -76,10 +475,10 @@ public:
 
   /**
    * @brief Force stop the executor.
-   * This method can be called anywhere in the code. It will trigger the executor to stop executing tasks.
-   * If there are tasks are being executed, their future may cause infinite waiting due to the force stop.
+   * This method can be called anywhere in the code. It does everything `stop` does and additionally signals the stop
+   * token, so tasks which are being executed and poll `get_stop_token` return early. Threads are never killed, a task
+   * which ignores the token still runs to completion.
    * If there are tasks in the queue, executor will throw an exception to their futures.
-   * If the executor is already stopped, this method will do nothing.
    */
   virtual Void force_stop() = 0;
 
@@ -102,17 +501,240 @@ public:
    * This method can be called anywhere in the code. It will return true if the queue is empty.
    * Otherwise, it will return false.
    */
-  virtual Bool is_queue_empty() const = 0;
+  Bool is_queue_empty() const
+  {
+    return m_pending.load(std::memory_order_acquire) == 0;
+  }
 
 protected:
-  virtual Void         enqueue(ExecutorTask&& task) = 0;
-  virtual ExecutorTask dequeue()                    = 0;
+  virtual Void         enqueue(ExecutorTask&& task, TaskPriority priority) = 0;
+  virtual ExecutorTask dequeue()                                           = 0;
+
+  /**
+   * @brief Count a task which is about to be pushed.
+   * Executors call it before the push and `release_pending` once a task is taken, so the count never drops below the
+   * number of queued tasks and a drain cannot finish while a task submitted before it is still queued.
+   */
+  Void reserve_pending() noexcept
+  {
+    record_queue_depth(m_pending.fetch_add(1, std::memory_order_seq_cst) + 1);
+  }
+
+  Void release_pending()
+  {
+    if (m_pending.fetch_sub(1, std::memory_order_seq_cst) == 1 && is_draining())
+    {
+      Lock lock(m_park_mutex);
+      m_park_cond.notify_all();
+    }
+  }
+
+  Bool has_pending() const noexcept
+  {
+    return m_pending.load(std::memory_order_seq_cst) > 0;
+  }
+
+  /**
+   * @brief Block the calling worker until a task is counted or the executor is stopped.
+   */
+  Void park()
+  {
+    auto parked = now_for_stats();
+
+    ULock lock(m_park_mutex);
+    m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+    m_park_cond.wait(lock, [this] { return is_stopped() || has_pending(); });
+    m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    lock.unlock();
+
+    record_idle(parked);
+  }
+
+  /**
+   * @brief Wake one parked worker, or every waiting thread once the executor is stopped or being drained.
+   */
+  Void notify()
+  {
+    {
+      // Taking the lock orders the notification after a worker that is about to park has entered its wait
+      Lock lock(m_park_mutex);
+    }
+
+    // A thread in `drain_and_stop` waits on the same condition, it must not take the wakeup meant for a worker
+    if (is_stopped() || is_draining())
+    {
+      m_park_cond.notify_all();
+    }
+    else
+    {
+      m_park_cond.notify_one();
+    }
+  }
+
+  // Called after a push, the lock is only taken when a worker is parked
+  Void notify_parked()
+  {
+    if (m_sleeping.load(std::memory_order_seq_cst) > 0)
+    {
+      notify();
+    }
+  }
+
+  Void cancel_pending()
+  {
+    while (auto task = dequeue())
+    {
+      std::invoke(task, true);
+    }
+  }
+
+  /**
+   * @brief Block until the queue is empty, the executor is stopped or `deadline` has passed.
+   * The waiter shares the condition variable workers park on, `release_pending` notifies it when the last queued task
+   * is taken while `is_draining` is true.
+   */
+  Void wait_for_drain(std::chrono::steady_clock::time_point deadline)
+  {
+    ULock lock(m_park_mutex);
+    m_park_cond.wait_until(lock, deadline, [this] { return is_stopped() || !has_pending(); });
+  }
+
+  Bool is_draining() const noexcept
+  {
+    return m_drain_waiters.load(std::memory_order_seq_cst) > 0;
+  }
+
+  Void request_stop() noexcept
+  {
+    m_stop_source.request_stop();
+  }
+
+  // Hooks for the executors, called with the number of queued tasks after a push, on a successful steal and with the
+  // value of `now_for_stats` taken before a worker parked
+  Void record_queue_depth(Int64 depth) noexcept
+  {
+    m_metrics.record_queue_depth(depth);
+  }
+
+  Void record_steal() noexcept
+  {
+    m_metrics.record_steal();
+  }
+
+  Void record_idle(Int64 parked) noexcept
+  {
+    m_metrics.record_idle(parked);
+  }
+
+  Int64 now_for_stats() const noexcept
+  {
+    return m_metrics.now();
+  }
+
+  // Called by `start`, tasks of the next run must not see the stop request of the previous one
+  Void reset_stop_token()
+  {
+    if (m_stop_source.stop_requested())
+    {
+      m_stop_source = std::stop_source{};
+    }
+  }
+
+private:
+  // Task graphs enqueue their nodes directly, a node which is cancelled still has to release the thread in `run`
+  friend class TaskGraph;
+
+  // Wraps a task so that its wait and run time are recorded. A cancellation is counted before the task runs, once the
+  // promise is broken its owner may go on to destroy the executor
+  template<typename F>
+  ExecutorTask instrument(F&& task)
+  {
+    m_metrics.record_submit();
+    return ExecutorTask{[metrics = &m_metrics, submitted = m_metrics.now(), task = std::forward<F>(task)](
+                            Bool stopped) mutable
+                        {
+                          if (stopped)
+                          {
+                            metrics->record_cancel();
+                            task(true);
+                            return;
+                          }
+
+                          auto started = metrics->record_start(submitted);
+                          task(false);
+                          metrics->record_finish(started);
+                        }};
+  }
+
+  // Wraps a callable so that the executor counts it as late when it finishes after the deadline, even by throwing
+  template<typename F>
+  auto with_deadline(TaskDeadline deadline, F&& func)
+  {
+    return [this, deadline, func = std::forward<F>(func)](auto&&... args) mutable -> decltype(auto)
+    {
+      struct DeadlineCheck
+      {
+        ~DeadlineCheck()
+        {
+          if (std::chrono::steady_clock::now() > deadline)
+          {
+            late_tasks.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+
+        TaskDeadline    deadline;
+        Atomic<UInt64>& late_tasks;
+      } check{deadline, m_late_tasks};
+
+      return std::invoke(std::move(func), std::forward<decltype(args)>(args)...);
+    };
+  }
+
+  Atomic<UInt64>      m_late_tasks    = 0;
+  Atomic<Int32>       m_drain_waiters = 0;
+  Atomic<Int64>       m_pending       = 0;
+  Atomic<Int32>       m_sleeping      = 0;
+  Mutex               m_park_mutex;
+  ConditionalVariable m_park_cond;
+  std::stop_source    m_stop_source;
+  ExecutorMetrics     m_metrics;
+};
+
+/**
+ * @brief Thread setup of a pool executor.
+ * `num_threads` of 0 uses one thread per CPU the pool may run on. Workers are named `<thread_name>-<index>` when a
+ * name is given, Linux keeps the first 15 characters. `cpus` restricts the pool to the listed CPU ids, and with
+ * `pin_threads` every worker is bound to a single CPU of that set. With `numa_aware` the workers are split into one
+ * sub-pool per NUMA node, each restricted to the CPUs of its node; a pool that supports it also keeps its queues per
+ * node so that tasks stay close to the memory they were submitted from.
+ */
+struct ExecutorOptions
+{
+  size_t        num_threads = 0;
+  String        thread_name = {};
+  DArray<Int32> cpus        = {};
+  Bool          pin_threads = false;
+  Bool          numa_aware  = false;
 };
 
+template<typename T>
+class PriorityTaskQueue;
+struct ThreadLayout;
+
+/**
+ * @brief Fixed-size thread pool executor
+ * Every worker pops from one shared set of lock-free priority lanes. Workers with nothing to do park on a condition
+ * variable, a submission wakes one of them.
+ */
 class FixedThreadPoolExecutor : public Executor<FixedThreadPoolExecutor>
 {
 public:
   explicit FixedThreadPoolExecutor(size_t num_threads = 0);
+
+  /**
+   * @brief Create a pool from options, all workers share one queue even when `numa_aware` is set.
+   */
+  explicit FixedThreadPoolExecutor(const ExecutorOptions& options);
   ~FixedThreadPoolExecutor() override;
 
   Void start() override;
@@ -120,20 +742,80 @@ public:
   Void force_stop() override;
   Void join() override;
   Bool is_stopped() const override;
-  Bool is_queue_empty() const override;
 
 protected:
-  Void         enqueue(ExecutorTask&& task) override;
+  Void         enqueue(ExecutorTask&& task, TaskPriority priority) override;
+  ExecutorTask dequeue() override;
+
+private:
+  Void worker_loop(size_t index);
+
+  DArray<Owner<Thread>>                  m_threads;
+  Owner<PriorityTaskQueue<ExecutorTask>> m_tasks;
+  Atomic<Bool>                           m_stopped;
+  size_t                                 m_num_threads;
+  String                                 m_thread_name;
+  Owner<ThreadLayout>                    m_layout;
+};
+
+/**
+ * @brief Work-stealing thread pool executor
+ * Every worker owns a Chase-Lev deque. Normal tasks submitted from a worker thread are pushed to that worker's deque,
+ * every other task goes to the shared injection queue of its lane. An idle worker first takes critical tasks, then
+ * drains its own deque, then the normal injection lane, then tries to steal from the other workers, and only then
+ * runs background tasks. Workers with nothing to do park on a condition variable instead of polling, so a freshly
+ * submitted task wakes a worker immediately.
+ *
+ * With `ExecutorOptions::numa_aware` every NUMA node gets its own injection queues. Tasks submitted from outside the
+ * pool go to the node of the submitting CPU, and workers prefer their own node both for injected tasks and as
+ * stealing victims before they reach across nodes.
+ */
+class WorkStealingExecutor : public Executor<WorkStealingExecutor>
+{
+public:
+  explicit WorkStealingExecutor(size_t num_threads = 0);
+  explicit WorkStealingExecutor(const ExecutorOptions& options);
+  ~WorkStealingExecutor() override;
+
+  Void start() override;
+  Void stop() override;
+  Void force_stop() override;
+  Void join() override;
+  Bool is_stopped() const override;
+
+  size_t get_num_threads() const;
+  size_t get_num_nodes() const;
+
+protected:
+  Void         enqueue(ExecutorTask&& task, TaskPriority priority) override;
   ExecutorTask dequeue() override;
 
 private:
-  DArray<Owner<Thread>> m_threads;
-  Queue<ExecutorTask>   m_tasks;
-  mutable Mutex         m_queue_mutex;
-  Atomic<Bool>          m_stopped;
-  Int32                 m_num_threads;
+  struct Worker;
+
+  Void          worker_loop(size_t index);
+  ExecutorTask* find_task(size_t index);
+  ExecutorTask* steal_task(size_t thief, Bool same_node);
+  ExecutorTask* pop_injected(size_t node, TaskPriority priority, Bool same_node);
+  size_t        current_node() const;
+  ExecutorTask* acquire_node(ExecutorTask&& task);
+  Void          release_node(ExecutorTask* node);
+
+  DArray<Owner<Worker>>                          m_workers;
+  DArray<Owner<PriorityTaskQueue<ExecutorTask>>> m_injection;
+  DArray<ExecutorTask*>                          m_free_nodes;
+  Mutex                                          m_node_mutex;
+  Atomic<Bool>                                   m_stopped;
+  size_t                                         m_num_threads;
+  String                                         m_thread_name;
+  Owner<ThreadLayout>                            m_layout;
 };
 
+/**
+ * @brief Single thread executor
+ * Tasks run one at a time and in submission order within a lane, on a thread owned by the executor. Submitting is
+ * safe from any thread, the lanes are the same lock-free queues the thread pools use.
+ */
 class SingleThreadExecutor : public Executor<SingleThreadExecutor>
 {
 public:
@@ -145,28 +827,71 @@ public:
   Void force_stop() override;
   Void join() override;
   Bool is_stopped() const override;
-  Bool is_queue_empty() const override;
 
 protected:
-  Void         enqueue(ExecutorTask&& task) override;
+  Void         enqueue(ExecutorTask&& task, TaskPriority priority) override;
   ExecutorTask dequeue() override;
 
 private:
-  Owner<Thread>       m_thread;
-  Queue<ExecutorTask> m_tasks;
-  Bool                m_stopped;
+  Void worker_loop();
+
+  Owner<Thread>                          m_thread;
+  Owner<PriorityTaskQueue<ExecutorTask>> m_tasks;
+  Atomic<Bool>                           m_stopped;
 };
 
+/**
+ * @brief Elastic thread pool executor
+ * Threads are spawned on demand: a submitted task is handed to an idle thread if there is one, otherwise a new thread
+ * is started as long as fewer than `max_threads` are alive. A thread which stays idle for `idle_timeout` exits, so
+ * the pool shrinks back to zero threads between bursts. Every priority lane is a lock-free queue, the same one the
+ * work-stealing pool uses for injected tasks. Intended for blocking work such as asset loading and file I/O.
+ */
 class CachedThreadPoolExecutor : public Executor<CachedThreadPoolExecutor>
 {
 public:
-  CachedThreadPoolExecutor();
-  ~CachedThreadPoolExecutor();
+  /**
+   * @param max_threads Upper bound of live threads, 0 means four threads per hardware thread
+   * @param idle_timeout How long a thread waits for a new task before it exits
+   */
+  explicit CachedThreadPoolExecutor(size_t                    max_threads  = 0,
+                                    std::chrono::milliseconds idle_timeout = std::chrono::seconds(60));
+  ~CachedThreadPoolExecutor() override;
+
+  Void start() override;
+  Void stop() override;
+  Void force_stop() override;
+  Void join() override;
+  Bool is_stopped() const override;
+
+  size_t get_max_threads() const;
+  size_t get_live_threads() const;
+  size_t get_idle_threads() const;
+  size_t get_peak_threads() const;
+
+protected:
+  Void         enqueue(ExecutorTask&& task, TaskPriority priority) override;
+  ExecutorTask dequeue() override;
 
 private:
-  DArray<Owner<Thread>> m_threads;
-  Queue<ExecutorTask>   m_tasks;
-  Mutex                 m_queue_mutex;
+  Void spawn_thread();
+  Void worker_loop();
+  Bool wait_for_task();
+
+  Owner<PriorityTaskQueue<ExecutorTask>> m_tasks;
+  mutable Mutex                          m_mutex;
+  ConditionalVariable                    m_idle_cond;
+  ConditionalVariable                    m_exit_cond;
+  size_t                                 m_live;
+  size_t                                 m_idle;
+  size_t                                 m_peak;
+  size_t                                 m_wakeups;
+  Atomic<Bool>                           m_stopped;
+  size_t                                 m_max_threads;
+  std::chrono::milliseconds              m_idle_timeout;
 };
 
 } // namespace setsugen
+
+#include "./__impl__/executor/executor_parallel.inl"
+#include "./__impl__/executor/executor_task-graph.inl"
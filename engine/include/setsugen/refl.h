@@ -7,7 +7,11 @@
 #include "./__impl__/refl/refl_base_decl.inl"
 #include "./__impl__/refl/refl_base_impl.inl"
 
+#include "./__impl__/refl/refl_reader_decl.inl"
+
 #include "./__impl__/refl/refl_field_decl.inl"
 #include "./__impl__/refl/refl_field_impl.inl"
 
+#include "./__impl__/refl/refl_reader_impl.inl"
+
 // IWYU pragma: end_exports
@@ -14,6 +14,10 @@
 
 #include "./__impl__/serde/serde_array_impl.inl"
 
+#include "./__impl__/serde/serde_document.inl"
+#include "./__impl__/serde/serde_mapped-file.inl"
+#include "./__impl__/serde/serde_visitor.inl"
+
 #include "./__impl__/serde/serde_json.inl"
 #include "./__impl__/serde/serde_sbf.inl"
 #include "./__impl__/serde/serde_toml.inl"
@@ -23,6 +27,8 @@
 #include "./__impl__/serde/serde_helper.inl"
 
 #include "./__impl__/serde/serde_data_impl.inl"
+#include "./__impl__/serde/serde_builder.inl"
+#include "./__impl__/serde/serde_path.inl"
 
 #include "./__impl__/serde/serde_deduction-guide.inl"
 
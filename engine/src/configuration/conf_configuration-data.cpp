@@ -24,7 +24,7 @@ Configuration(const SerializedData& data)
 Configuration::~Configuration() = default;
 
 String
-Configuration::get_string(const String& key, Optional<String> default_value) const
+Configuration::get_string(const SerializedPath& key, Optional<String> default_value) const
 {
   auto data = dive(key);
   if (data && data->get_type() == SerializedType::String)
@@ -37,11 +37,11 @@ Configuration::get_string(const String& key, Optional<String> default_value) con
     return default_value.value();
   }
 
-  throw InvalidArgumentException("Cannot find key {}", {key});
+  throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
 }
 
 Int32
-Configuration::get_int(const String& key, Optional<Int32> default_value) const
+Configuration::get_int(const SerializedPath& key, Optional<Int32> default_value) const
 {
   auto data = dive(key);
   if (data && data->get_type() == SerializedType::Integer)
@@ -54,11 +54,11 @@ Configuration::get_int(const String& key, Optional<Int32> default_value) const
     return default_value.value();
   }
 
-  throw InvalidArgumentException("Cannot find key {}", {key});
+  throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
 }
 
 Int64
-Configuration::get_long(const String& key, Optional<Int64> default_value) const
+Configuration::get_long(const SerializedPath& key, Optional<Int64> default_value) const
 {
   auto data = dive(key);
   if (data && data->get_type() == SerializedType::Integer)
@@ -71,11 +71,11 @@ Configuration::get_long(const String& key, Optional<Int64> default_value) const
     return default_value.value();
   }
 
-  throw InvalidArgumentException("Cannot find key {}", {key});
+  throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
 }
 
 Float32
-Configuration::get_float(const String& key, Optional<Float32> default_value) const
+Configuration::get_float(const SerializedPath& key, Optional<Float32> default_value) const
 {
   auto data = dive(key);
   if (data && data->get_type() == SerializedType::Float)
@@ -88,11 +88,11 @@ Configuration::get_float(const String& key, Optional<Float32> default_value) con
     return default_value.value();
   }
 
-  throw InvalidArgumentException("Cannot find key {}", {key});
+  throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
 }
 
 Float64
-Configuration::get_double(const String& key, Optional<Float64> default_value) const
+Configuration::get_double(const SerializedPath& key, Optional<Float64> default_value) const
 {
   auto data = dive(key);
   if (data && data->get_type() == SerializedType::Float)
@@ -105,68 +105,58 @@ Configuration::get_double(const String& key, Optional<Float64> default_value) co
     return default_value.value();
   }
 
-  throw InvalidArgumentException("Cannot find key {}", {key});
+  throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
 }
 
 Configuration
-Configuration::get_child(const String& key) const
+Configuration::get_child(const SerializedPath& key) const
 {
-  return Configuration{*dive(key)};
+  auto data = dive(key);
+  if (!data)
+  {
+    throw InvalidArgumentException("Cannot find key {}", {key.to_pointer()});
+  }
+
+  return Configuration{*data};
 }
 
 
-SerializedData*
-Configuration::dive(const String& key) const
+const SerializedData*
+Configuration::dive(const SerializedPath& key) const
 {
-  auto key_view = key | std::views::split('.') |
-                  std::views::transform(
-                      [](auto&& sv) {
-                        return String{sv.begin(), sv.end()};
-                      }) |
-                  std::views::common;
-
-  auto* current = &m_data;
-  for (const auto& key: key_view)
-  {
-    if (current->get_type() != SerializedType::Object)
-    {
-      return nullptr;
-    }
-
-    current = &(*current)[key];
-  }
-
-  return current;
+  // Reads go through the const overload, which neither inserts missing keys nor resets cached hashes
+  return key.resolve(static_cast<const SerializedData&>(m_data));
 }
 
 SerializedData*
-Configuration::dive_insert(const String& key) const
+Configuration::dive_insert(const SerializedPath& key) const
 {
-  auto key_view = key | std::views::split('.') |
-                  std::views::transform(
-                      [](auto&& sv) {
-                        return String{sv.begin(), sv.end()};
-                      }) |
-                  std::views::common;
-
-  auto* current   = &m_data;
-  auto  key_depth = static_cast<UInt32>(std::distance(key_view.begin(), key_view.end()));
-  auto  index     = 0;
+  if (key.has_wildcard())
+  {
+    throw InvalidArgumentException("Invalid key {}", {key.to_pointer()});
+  }
 
-  for (const auto& keystr: key_view)
+  auto*       current  = &m_data;
+  const auto& segments = key.get_segments();
+  for (size_t i = 0; i < segments.size(); ++i)
   {
     if (current->get_type() != SerializedType::Object)
     {
-      throw InvalidArgumentException("Invalid key {}", {key});
+      throw InvalidArgumentException("Invalid key {}", {key.to_pointer()});
     }
 
-    if (index != key_depth - 1 && !current->get_object().has_key(keystr))
+    auto& object = current->get_object();
+    auto  next   = object.find(segments[i].key, segments[i].hash);
+    if (!next)
     {
-      (*current)[keystr] = SerializedData::object({});
+      next = &object[segments[i].key];
+      if (i != segments.size() - 1)
+      {
+        *next = SerializedData::object({});
+      }
     }
 
-    current = &(*current)[keystr];
-    ++index;
+    current = next;
   }
 
   return current;
@@ -180,10 +170,8 @@ Configuration::merge(const SerializedData& other)
     throw InvalidArgumentException("Cannot merge a non-object SerializedData into a Configuration");
   }
 
-  for (const auto& [key, value]: other.get_object())
-  {
-    m_data[key] = value;
-  }
+  // Sources are layered member by member, a nested object only overrides the keys it sets and null removes a key
+  m_data.apply_merge_patch(other);
 }
 
 Void
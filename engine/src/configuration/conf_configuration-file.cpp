@@ -31,20 +31,15 @@ FileConfigurationSource::FileConfigurationSource(const String& path, Format form
 SerializedData
 FileConfigurationSource::load()
 {
-  SerializedData  data;
-  FileInputStream file(m_path);
-
-  if (!file.good())
-  {
-    throw FileNotFoundException("Cannot open configuration file {}", {m_path});
-  }
+  SerializedData data;
+  MappedFile     file(m_path);
 
   switch (m_format)
   {
     case Format::Json:
     {
       auto conf = Json::Configurations{.deserializer_config = {.allow_c_comments = true, .allow_yaml_comments = false}};
-      data.parse(file, Json{conf});
+      data.parse(file.view(), Json{conf});
     }
     break;
 
@@ -49,7 +49,7 @@ ConfigurationLoader::load()
 
   for (const auto& [key, value]: m_overrides)
   {
-    *config.dive(key) = value;
+    *config.dive_insert(key) = value;
   }
 
   return config;
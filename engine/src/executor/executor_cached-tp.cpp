@@ -0,0 +1,237 @@
+#include <setsugen/executor.h>
+
+#include "executor_mpmc-queue.h"
+
+namespace setsugen
+{
+
+// Set on the pool threads, join() must not wait for the thread it is called from
+static thread_local CachedThreadPoolExecutor* current_executor = nullptr;
+
+CachedThreadPoolExecutor::CachedThreadPoolExecutor(size_t max_threads, std::chrono::milliseconds idle_timeout)
+    : m_tasks(std::make_unique<PriorityTaskQueue<ExecutorTask>>()), m_live(0), m_idle(0), m_peak(0), m_wakeups(0),
+      m_stopped(true), m_max_threads(max_threads), m_idle_timeout(idle_timeout)
+{
+  if (m_max_threads == 0)
+  {
+    m_max_threads = std::thread::hardware_concurrency() * 4;
+  }
+
+  if (m_max_threads == 0)
+  {
+    m_max_threads = 1;
+  }
+}
+
+CachedThreadPoolExecutor::~CachedThreadPoolExecutor()
+{
+  stop();
+  join();
+}
+
+Void
+CachedThreadPoolExecutor::start()
+{
+  // Threads are spawned lazily by enqueue
+  reset_stop_token();
+  m_stopped = false;
+}
+
+Void
+CachedThreadPoolExecutor::stop()
+{
+  {
+    Lock lock(m_mutex);
+    if (m_stopped.exchange(true))
+    {
+      return;
+    }
+
+    m_idle_cond.notify_all();
+  }
+
+  // Pool threads wait on the idle condition, the park condition only has drain waiters
+  notify();
+  cancel_pending();
+}
+
+Void
+CachedThreadPoolExecutor::force_stop()
+{
+  // Idle threads leave as soon as they are woken up, running tasks see the stop request on their token
+  request_stop();
+  stop();
+}
+
+Void
+CachedThreadPoolExecutor::join()
+{
+  if (current_executor != this)
+  {
+    ULock lock(m_mutex);
+    m_exit_cond.wait(lock, [this] { return m_live == 0; });
+  }
+
+  if (m_stopped)
+  {
+    cancel_pending();
+  }
+}
+
+Bool
+CachedThreadPoolExecutor::is_stopped() const
+{
+  return m_stopped;
+}
+
+size_t
+CachedThreadPoolExecutor::get_max_threads() const
+{
+  return m_max_threads;
+}
+
+size_t
+CachedThreadPoolExecutor::get_live_threads() const
+{
+  Lock lock(m_mutex);
+  return m_live;
+}
+
+size_t
+CachedThreadPoolExecutor::get_idle_threads() const
+{
+  Lock lock(m_mutex);
+  return m_idle;
+}
+
+size_t
+CachedThreadPoolExecutor::get_peak_threads() const
+{
+  Lock lock(m_mutex);
+  return m_peak;
+}
+
+Void
+CachedThreadPoolExecutor::enqueue(ExecutorTask&& task, TaskPriority priority)
+{
+  if (m_stopped)
+  {
+    std::invoke(task, true);
+    return;
+  }
+
+  reserve_pending();
+  m_tasks->push(std::move(task), priority);
+
+  {
+    Lock lock(m_mutex);
+    if (m_idle > 0)
+    {
+      // Hand the task to one idle thread, the wakeup is claimed so the next submission does not count it as idle
+      --m_idle;
+      ++m_wakeups;
+      m_idle_cond.notify_one();
+      return;
+    }
+
+    if (m_live >= m_max_threads)
+    {
+      // Every thread is busy, the task is picked up by the first one that finishes
+      return;
+    }
+
+    ++m_live;
+    m_peak = std::max(m_peak, m_live);
+  }
+
+  spawn_thread();
+}
+
+CachedThreadPoolExecutor::ExecutorTask
+CachedThreadPoolExecutor::dequeue()
+{
+  ExecutorTask task;
+  if (!m_tasks->try_pop(task))
+  {
+    return nullptr;
+  }
+
+  release_pending();
+  return task;
+}
+
+Void
+CachedThreadPoolExecutor::spawn_thread()
+{
+  try
+  {
+    Thread([this] { worker_loop(); }).detach();
+  }
+  catch (...)
+  {
+    // The thread was already counted as live, the tasks in the queue are still picked up by the other threads
+    Lock lock(m_mutex);
+    --m_live;
+    m_exit_cond.notify_all();
+    throw;
+  }
+}
+
+Void
+CachedThreadPoolExecutor::worker_loop()
+{
+  current_executor = this;
+
+  while (!m_stopped)
+  {
+    if (auto task = dequeue())
+    {
+      std::invoke(task, false);
+      continue;
+    }
+
+    if (!wait_for_task())
+    {
+      break;
+    }
+  }
+
+  current_executor = nullptr;
+
+  // Threads are detached, the counter is what join() waits on. Nothing touches the executor after the lock is released
+  Lock lock(m_mutex);
+  --m_live;
+  m_exit_cond.notify_all();
+}
+
+Bool
+CachedThreadPoolExecutor::wait_for_task()
+{
+  ULock lock(m_mutex);
+
+  // The submitter bumps the pending counter before it takes the lock, so a task pushed after our last dequeue is seen
+  // here instead of being left for a thread that is about to go idle
+  if (has_pending())
+  {
+    lock.unlock();
+    std::this_thread::yield();
+    return true;
+  }
+
+  ++m_idle;
+  auto parked = now_for_stats();
+  m_idle_cond.wait_for(lock, m_idle_timeout, [this] { return m_stopped || m_wakeups > 0; });
+  record_idle(parked);
+
+  if (m_wakeups > 0)
+  {
+    // Whoever posted the wakeup already took this thread off the idle count
+    --m_wakeups;
+    return !m_stopped;
+  }
+
+  --m_idle;
+  return false;
+}
+
+} // namespace setsugen
@@ -1,52 +1,65 @@
 #include <setsugen/executor.h>
 
+#include "executor_mpmc-queue.h"
 #include "executor_platform-utilities.h"
 
 namespace setsugen
 {
 
-FixedThreadPoolExecutor::FixedThreadPoolExecutor(size_t num_threads) : m_stopped(true), m_num_threads(num_threads)
+FixedThreadPoolExecutor::FixedThreadPoolExecutor(size_t num_threads)
+    : FixedThreadPoolExecutor(ExecutorOptions{.num_threads = num_threads})
+{}
+
+FixedThreadPoolExecutor::FixedThreadPoolExecutor(const ExecutorOptions& options)
+    : m_tasks(std::make_unique<PriorityTaskQueue<ExecutorTask>>()), m_stopped(true),
+      m_num_threads(options.num_threads), m_thread_name(options.thread_name)
 {
   if (m_num_threads == 0)
   {
-    m_num_threads = std::thread::hardware_concurrency();
+    m_num_threads = options.cpus.empty() ? std::thread::hardware_concurrency() : options.cpus.size();
   }
 
   if (m_num_threads == 0)
   {
     m_num_threads = 1;
   }
+
+  m_layout = std::make_unique<ThreadLayout>(plan_thread_layout(options, m_num_threads));
 }
 
 FixedThreadPoolExecutor::~FixedThreadPoolExecutor()
 {
-  std::unique_lock<std::mutex> lock(m_queue_mutex);
-  m_stopped = true;
-  m_threads.clear();
+  stop();
+  join();
 }
 
 Void
-FixedThreadPoolExecutor::enqueue(ExecutorTask&& task)
+FixedThreadPoolExecutor::enqueue(ExecutorTask&& task, TaskPriority priority)
 {
-  std::unique_lock<std::mutex> lock(m_queue_mutex);
-  m_tasks.push(task);
+  if (m_stopped)
+  {
+    std::invoke(task, true);
+    return;
+  }
+
+  reserve_pending();
+  m_tasks->push(std::move(task), priority);
+  notify_parked();
 }
 
 FixedThreadPoolExecutor::ExecutorTask
 FixedThreadPoolExecutor::dequeue()
 {
-  std::unique_lock<std::mutex> lock(m_queue_mutex);
-  if (m_tasks.empty())
+  ExecutorTask task;
+  if (!m_tasks->try_pop(task))
   {
     return nullptr;
   }
 
-  auto task = m_tasks.front();
-  m_tasks.pop();
+  release_pending();
   return task;
 }
 
-
 Void
 FixedThreadPoolExecutor::start()
 {
@@ -55,72 +68,35 @@ FixedThreadPoolExecutor::start()
     return;
   }
 
-  m_stopped = false;
+  join();
+  m_threads.clear();
+  reset_stop_token();
 
-  if (!m_threads.empty())
-  {
-    m_threads.clear();
-  }
+  m_stopped = false;
 
   for (size_t i = 0; i < m_num_threads; ++i)
   {
-    m_threads.emplace_back(std::make_unique<std::thread>(
-        [this]
-        {
-          while (true)
-          {
-            if (m_stopped)
-            {
-              break;
-            }
-
-            if (is_queue_empty())
-            {
-              std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-
-            auto task = dequeue();
-            if (task)
-            {
-              std::invoke(task, false);
-            }
-          }
-        }));
+    m_threads.emplace_back(std::make_unique<std::thread>([this, i] { worker_loop(i); }));
   }
 }
 
 Void
 FixedThreadPoolExecutor::stop()
 {
-  m_stopped = true;
-  while (!is_queue_empty())
+  if (m_stopped.exchange(true))
   {
-    auto task = dequeue();
-    if (task)
-    {
-      std::invoke(task, true);
-    }
+    return;
   }
+
+  notify();
+  cancel_pending();
 }
 
 Void
 FixedThreadPoolExecutor::force_stop()
 {
-  m_stopped = true;
-  for (auto& thread: m_threads)
-  {
-    terminate_thread(*thread);
-  }
-
-  m_stopped = true;
-  while (!is_queue_empty())
-  {
-    auto task = dequeue();
-    if (task)
-    {
-      std::invoke(task, true);
-    }
-  }
+  request_stop();
+  stop();
 }
 
 Void
@@ -128,7 +104,16 @@ FixedThreadPoolExecutor::join()
 {
   for (auto& thread: m_threads)
   {
-    thread->join();
+    if (thread->joinable() && thread->get_id() != std::this_thread::get_id())
+    {
+      thread->join();
+    }
+  }
+
+  // A task submitted while the executor was stopping may have slipped into the queue after it was cancelled
+  if (m_stopped)
+  {
+    cancel_pending();
   }
 }
 
@@ -138,11 +123,34 @@ FixedThreadPoolExecutor::is_stopped() const
   return m_stopped;
 }
 
-Bool
-FixedThreadPoolExecutor::is_queue_empty() const
+Void
+FixedThreadPoolExecutor::worker_loop(size_t index)
 {
-  std::lock_guard<std::mutex> lock(m_queue_mutex);
-  return m_tasks.empty();
+  constexpr Int32 spin_rounds = 64;
+
+  configure_current_thread(m_thread_name.empty() ? m_thread_name : m_thread_name + "-" + std::to_string(index),
+                           m_layout->threads[index].cpus);
+
+  while (!m_stopped)
+  {
+    ExecutorTask task;
+    for (Int32 i = 0; i < spin_rounds && !task && !m_stopped; ++i)
+    {
+      task = dequeue();
+      if (!task)
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    if (!task)
+    {
+      park();
+      continue;
+    }
+
+    std::invoke(task, false);
+  }
 }
 
 } // namespace setsugen
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <bit>
+
+namespace setsugen
+{
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue.
+ * Every cell carries a sequence number which tells producers and consumers whose turn it is, so values are stored
+ * in place and a push or pop is a single CAS on the uncontended path.
+ *
+ * Reference: D. Vyukov, "Bounded MPMC queue", 1024cores.net.
+ *
+ * @tparam T
+ */
+template<typename T>
+class BoundedMpmcQueue
+{
+public:
+  explicit BoundedMpmcQueue(size_t capacity = 1024)
+      : m_mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1}, m_cells{new Cell[m_mask + 1]}, m_enqueue_pos{0},
+        m_dequeue_pos{0}
+  {
+    for (size_t i = 0; i <= m_mask; ++i)
+    {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~BoundedMpmcQueue()
+  {
+    T value;
+    while (try_pop(value))
+    {}
+  }
+
+  BoundedMpmcQueue(const BoundedMpmcQueue&)            = delete;
+  BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+  Bool try_push(T&& value)
+  {
+    Cell* cell;
+    auto  pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell          = &m_cells[pos & m_mask];
+      auto sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff     = static_cast<PtrDiff>(sequence) - static_cast<PtrDiff>(pos);
+
+      if (diff == 0)
+      {
+        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (cell->storage) T(std::move(value));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  Bool try_pop(T& value)
+  {
+    Cell* cell;
+    auto  pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell          = &m_cells[pos & m_mask];
+      auto sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff     = static_cast<PtrDiff>(sequence) - static_cast<PtrDiff>(pos + 1);
+
+      if (diff == 0)
+      {
+        if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    auto slot = std::launder(reinterpret_cast<T*>(cell->storage));
+    value     = std::move(*slot);
+    slot->~T();
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  struct alignas(64) Cell
+  {
+    Atomic<size_t>  sequence;
+    alignas(T) Byte storage[sizeof(T)];
+  };
+
+  size_t                     m_mask;
+  Owner<Cell[]>              m_cells;
+  alignas(64) Atomic<size_t> m_enqueue_pos;
+  alignas(64) Atomic<size_t> m_dequeue_pos;
+};
+
+/**
+ * @brief Unbounded task queue shared by the thread pools.
+ * Pushes and pops go through a lock-free ring. When a burst fills the ring, the remaining values spill into a
+ * mutex-protected overflow deque which consumers drain once the ring is empty. Ordering is FIFO as long as the ring
+ * does not overflow.
+ *
+ * @tparam T
+ */
+template<typename T>
+class TaskQueue
+{
+public:
+  explicit TaskQueue(size_t capacity = 1024) : m_ring{capacity}, m_overflow_size{0}
+  {}
+
+  Void push(T&& value)
+  {
+    if (m_overflow_size.load(std::memory_order_acquire) == 0 && m_ring.try_push(std::move(value)))
+    {
+      return;
+    }
+
+    Lock lock(m_overflow_mutex);
+    m_overflow.push_back(std::move(value));
+    m_overflow_size.fetch_add(1, std::memory_order_release);
+  }
+
+  Bool try_pop(T& value)
+  {
+    if (m_ring.try_pop(value))
+    {
+      return true;
+    }
+
+    if (m_overflow_size.load(std::memory_order_acquire) == 0)
+    {
+      return false;
+    }
+
+    Lock lock(m_overflow_mutex);
+    if (m_overflow.empty())
+    {
+      return false;
+    }
+
+    value = std::move(m_overflow.front());
+    m_overflow.pop_front();
+    m_overflow_size.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  BoundedMpmcQueue<T> m_ring;
+  Mutex               m_overflow_mutex;
+  Deque<T>            m_overflow;
+  Atomic<size_t>      m_overflow_size;
+};
+
+/**
+ * @brief One TaskQueue per priority lane.
+ * `try_pop` always drains higher lanes first.
+ *
+ * @tparam T
+ */
+template<typename T>
+class PriorityTaskQueue
+{
+public:
+  Void push(T&& value, TaskPriority priority)
+  {
+    m_lanes[static_cast<size_t>(priority)].push(std::move(value));
+  }
+
+  Bool try_pop(T& value)
+  {
+    for (auto& lane: m_lanes)
+    {
+      if (lane.try_pop(value))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  Bool try_pop(T& value, TaskPriority priority)
+  {
+    return m_lanes[static_cast<size_t>(priority)].try_pop(value);
+  }
+
+private:
+  Array<TaskQueue<T>, task_priority_count> m_lanes;
+};
+
+} // namespace setsugen
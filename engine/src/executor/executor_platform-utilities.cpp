@@ -1,22 +1,251 @@
+#include <setsugen/executor.h>
+
 #include "executor_platform-utilities.h"
 
+#include <numeric>
+
 #ifdef SETSUGENE_WINDOWS
 #include <Windows.h>
 #endif
 
+#ifdef SETSUGENE_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace setsugen
 {
 
+#ifdef SETSUGENE_LINUX
+// Parses a kernel CPU or node list such as "0-3,8-11"
+static DArray<Int32>
+parse_cpu_list(const String& list)
+{
+  DArray<Int32> cpus;
+  StringStream  stream(list);
+  String        range;
+  while (std::getline(stream, range, ','))
+  {
+    if (range.empty() || range == "\n")
+    {
+      continue;
+    }
+
+    auto dash  = range.find('-');
+    auto first = std::stoi(range.substr(0, dash));
+    auto last  = dash == String::npos ? first : std::stoi(range.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu)
+    {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+#endif
+
+DArray<DArray<Int32>>
+get_numa_nodes()
+{
+  DArray<DArray<Int32>> nodes;
+
+#if defined(SETSUGENE_LINUX)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  auto has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+  // Node numbers may have gaps, e.g. with offline nodes, so only the nodes listed as online are read
+  String        online;
+  std::ifstream online_file("/sys/devices/system/node/online");
+  std::getline(online_file, online);
+
+  for (auto node: parse_cpu_list(online))
+  {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file)
+    {
+      continue;
+    }
+
+    String list;
+    std::getline(file, list);
+
+    DArray<Int32> cpus;
+    for (auto cpu: parse_cpu_list(list))
+    {
+      if (!has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+
+    if (!cpus.empty())
+    {
+      nodes.emplace_back(std::move(cpus));
+    }
+  }
+#elif defined(SETSUGENE_WINDOWS)
+  ULONG highest = 0;
+  if (GetNumaHighestNodeNumber(&highest))
+  {
+    for (ULONG node = 0; node <= highest; ++node)
+    {
+      ULONGLONG mask = 0;
+      if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask))
+      {
+        continue;
+      }
+
+      DArray<Int32> cpus;
+      for (Int32 cpu = 0; cpu < 64; ++cpu)
+      {
+        if (mask & (1ull << cpu))
+        {
+          cpus.push_back(cpu);
+        }
+      }
+
+      if (!cpus.empty())
+      {
+        nodes.emplace_back(std::move(cpus));
+      }
+    }
+  }
+#endif
+
+  if (nodes.empty())
+  {
+    DArray<Int32> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+    std::iota(cpus.begin(), cpus.end(), 0);
+    nodes.emplace_back(std::move(cpus));
+  }
+
+  return nodes;
+}
+
+Int32
+get_current_cpu()
+{
+#if defined(SETSUGENE_LINUX)
+  return sched_getcpu();
+#elif defined(SETSUGENE_WINDOWS)
+  return static_cast<Int32>(GetCurrentProcessorNumber());
+#else
+  return -1;
+#endif
+}
+
+ThreadLayout
+plan_thread_layout(const ExecutorOptions& options, size_t num_threads)
+{
+  auto nodes = get_numa_nodes();
+
+  if (!options.cpus.empty())
+  {
+    for (auto cpu: options.cpus)
+    {
+      auto found = std::ranges::any_of(nodes, [cpu](const auto& node) { return std::ranges::count(node, cpu) > 0; });
+      if (!found)
+      {
+        throw InvalidArgumentException("CPU {} is not available to the process", {cpu});
+      }
+    }
+
+    for (auto& node: nodes)
+    {
+      std::erase_if(node, [&options](Int32 cpu) { return std::ranges::count(options.cpus, cpu) == 0; });
+    }
+    std::erase_if(nodes, [](const auto& node) { return node.empty(); });
+  }
+
+  if (!options.numa_aware && nodes.size() > 1)
+  {
+    for (size_t i = 1; i < nodes.size(); ++i)
+    {
+      nodes[0].insert(nodes[0].end(), nodes[i].begin(), nodes[i].end());
+    }
+    nodes.resize(1);
+  }
+
+  // Threads are spread over the nodes in contiguous blocks, so neighbouring workers share a node
+  ThreadLayout layout;
+  layout.num_nodes = std::min(nodes.size(), std::max<size_t>(num_threads, 1));
+  for (auto& node: nodes)
+  {
+    for (auto cpu: node)
+    {
+      if (cpu >= static_cast<Int32>(layout.cpu_nodes.size()))
+      {
+        layout.cpu_nodes.resize(cpu + 1, -1);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_threads; ++i)
+  {
+    auto  node  = i * layout.num_nodes / num_threads;
+    auto  first = (node * num_threads + layout.num_nodes - 1) / layout.num_nodes;
+    auto& cpus  = nodes[node];
+
+    ThreadPlacement placement{node, {}};
+    if (options.pin_threads)
+    {
+      placement.cpus.push_back(cpus[(i - first) % cpus.size()]);
+    }
+    else if (options.numa_aware || !options.cpus.empty())
+    {
+      placement.cpus = cpus;
+    }
+
+    layout.threads.emplace_back(std::move(placement));
+  }
+
+  for (size_t node = 0; node < layout.num_nodes; ++node)
+  {
+    for (auto cpu: nodes[node])
+    {
+      layout.cpu_nodes[cpu] = static_cast<Int32>(node);
+    }
+  }
+
+  return layout;
+}
+
 Void
-terminate_thread(std::thread& thread)
+configure_current_thread(const String& name, const DArray<Int32>& cpus)
 {
-  auto handle = thread.native_handle();
-#if defined(__GNUC__)
-  pthread_kill(handle, SIGINT);
-#elif defined(_WIN32)
-  TerminateThread(handle, 0);
-#elif
-  pthread_cancel(handle);
+#if defined(SETSUGENE_LINUX)
+  if (!name.empty())
+  {
+    // The kernel keeps at most 15 characters
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+  }
+
+  if (!cpus.empty())
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu: cpus)
+    {
+      CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+#elif defined(SETSUGENE_WINDOWS)
+  if (!name.empty())
+  {
+    SetThreadDescription(GetCurrentThread(), WString(name.begin(), name.end()).c_str());
+  }
+
+  if (!cpus.empty())
+  {
+    DWORD_PTR mask = 0;
+    for (auto cpu: cpus)
+    {
+      mask |= DWORD_PTR{1} << cpu;
+    }
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+  }
 #endif
 }
 
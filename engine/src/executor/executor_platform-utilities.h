@@ -3,6 +3,48 @@
 namespace setsugen
 {
 
-Void terminate_thread(std::thread& thread);
+/**
+ * @brief Where a pool thread runs.
+ * `node` is the index of the NUMA node inside the pool, not the id the OS uses. An empty CPU list leaves the thread
+ * unpinned.
+ */
+struct ThreadPlacement
+{
+  size_t        node;
+  DArray<Int32> cpus;
+};
+
+/**
+ * @brief Placement of every thread of a pool, computed once from its ExecutorOptions.
+ */
+struct ThreadLayout
+{
+  DArray<ThreadPlacement> threads;
+  DArray<Int32>           cpu_nodes; // Pool node of every CPU id, -1 for CPUs the pool does not use
+  size_t                  num_nodes;
+};
+
+/**
+ * @brief CPUs of every online NUMA node which the process is allowed to run on.
+ * Falls back to a single node holding every hardware thread when the platform does not expose its topology.
+ */
+DArray<DArray<Int32>> get_numa_nodes();
+
+/**
+ * @brief CPU the calling thread is running on, -1 if unknown.
+ */
+Int32 get_current_cpu();
+
+/**
+ * @brief Spread `num_threads` threads over the CPUs selected by the options.
+ * Throws an InvalidArgumentException if the options name a CPU the process cannot run on.
+ */
+ThreadLayout plan_thread_layout(const ExecutorOptions& options, size_t num_threads);
+
+/**
+ * @brief Name the calling thread and restrict it to the given CPUs.
+ * Both are hints for profilers and the scheduler, failures are ignored.
+ */
+Void configure_current_thread(const String& name, const DArray<Int32>& cpus);
 
 } // namespace setsugen
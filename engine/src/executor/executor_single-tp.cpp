@@ -1,14 +1,19 @@
 #include <setsugen/executor.h>
 
-#include "executor_platform-utilities.h"
+#include "executor_mpmc-queue.h"
 
 namespace setsugen
 {
 
-SingleThreadExecutor::SingleThreadExecutor() : m_stopped(true)
+SingleThreadExecutor::SingleThreadExecutor()
+    : m_tasks(std::make_unique<PriorityTaskQueue<ExecutorTask>>()), m_stopped(true)
 {}
 
-SingleThreadExecutor::~SingleThreadExecutor() = default;
+SingleThreadExecutor::~SingleThreadExecutor()
+{
+  stop();
+  join();
+}
 
 Void
 SingleThreadExecutor::start()
@@ -18,63 +23,45 @@ SingleThreadExecutor::start()
     return;
   }
 
-  m_stopped = false;
+  join();
+  reset_stop_token();
 
-  m_thread = std::make_unique<std::thread>(
-      [this]
-      {
-        while (true)
-        {
-          if (m_stopped)
-          {
-            break;
-          }
-
-          if (m_tasks.empty())
-          {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-          }
-
-          auto task = dequeue();
-          if (task)
-          {
-            std::invoke(task, m_stopped);
-          }
-        }
-      });
+  m_stopped = false;
+  m_thread  = std::make_unique<Thread>([this] { worker_loop(); });
 }
 
 Void
 SingleThreadExecutor::stop()
 {
-  if (m_stopped)
+  if (m_stopped.exchange(true))
   {
     return;
   }
 
-  m_stopped = true;
+  notify();
+  cancel_pending();
 }
 
 Void
 SingleThreadExecutor::force_stop()
 {
-  if (m_stopped)
-  {
-    return;
-  }
-
-  m_stopped = true;
-  terminate_thread(*m_thread);
+  request_stop();
+  stop();
 }
 
 Void
 SingleThreadExecutor::join()
 {
-  if (m_thread && m_thread->joinable())
+  if (m_thread && m_thread->joinable() && m_thread->get_id() != std::this_thread::get_id())
   {
     m_thread->join();
   }
+
+  // A task submitted while the executor was stopping may have slipped into the queue after it was cancelled
+  if (m_stopped)
+  {
+    cancel_pending();
+  }
 }
 
 Bool
@@ -83,29 +70,46 @@ SingleThreadExecutor::is_stopped() const
   return m_stopped;
 }
 
-Bool
-SingleThreadExecutor::is_queue_empty() const
-{
-  return m_tasks.empty();
-}
-
 Void
-SingleThreadExecutor::enqueue(ExecutorTask&& task)
+SingleThreadExecutor::enqueue(ExecutorTask&& task, TaskPriority priority)
 {
-  m_tasks.push(task);
+  if (m_stopped)
+  {
+    std::invoke(task, true);
+    return;
+  }
+
+  reserve_pending();
+  m_tasks->push(std::move(task), priority);
+  notify_parked();
 }
 
 SingleThreadExecutor::ExecutorTask
 SingleThreadExecutor::dequeue()
 {
-  if (m_tasks.empty())
+  ExecutorTask task;
+  if (!m_tasks->try_pop(task))
   {
     return nullptr;
   }
 
-  auto task = m_tasks.front();
-  m_tasks.pop();
+  release_pending();
   return task;
 }
 
+Void
+SingleThreadExecutor::worker_loop()
+{
+  while (!m_stopped)
+  {
+    if (auto task = dequeue())
+    {
+      std::invoke(task, false);
+      continue;
+    }
+
+    park();
+  }
+}
+
 } // namespace setsugen
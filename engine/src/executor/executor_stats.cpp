@@ -0,0 +1,124 @@
+#include <setsugen/executor.h>
+#include <setsugen/logger.h>
+
+namespace setsugen
+{
+
+Float64
+HistogramSnapshot::mean() const
+{
+  return count == 0 ? 0.0 : static_cast<Float64>(sum) / static_cast<Float64>(count);
+}
+
+UInt64
+HistogramSnapshot::percentile(Float64 percentile) const
+{
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  auto rank  = std::max<UInt64>(static_cast<UInt64>(std::ceil(percentile / 100.0 * static_cast<Float64>(count))), 1);
+
+  UInt64 seen = 0;
+  for (size_t bucket = 0; bucket < buckets.size(); ++bucket)
+  {
+    seen += buckets[bucket];
+    if (seen >= rank)
+    {
+      return std::clamp(ExecutorHistogram::bucket_upper_bound(bucket), min, max);
+    }
+  }
+
+  return max;
+}
+
+ExecutorHistogram::ExecutorHistogram() noexcept
+{
+  reset();
+}
+
+HistogramSnapshot
+ExecutorHistogram::snapshot() const
+{
+  HistogramSnapshot snapshot;
+  snapshot.buckets.resize(bucket_count);
+  for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+  {
+    snapshot.buckets[bucket] = m_buckets[bucket].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[bucket];
+  }
+
+  snapshot.sum = m_sum.load(std::memory_order_relaxed);
+  if (snapshot.count != 0)
+  {
+    snapshot.min = m_min.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+  }
+
+  return snapshot;
+}
+
+Void
+ExecutorHistogram::reset() noexcept
+{
+  for (auto& bucket: m_buckets)
+  {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+
+  m_sum.store(0, std::memory_order_relaxed);
+  m_min.store(max_value, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+ExecutorStats
+ExecutorMetrics::snapshot() const
+{
+  ExecutorStats stats;
+  stats.submitted   = m_submitted.load(std::memory_order_relaxed);
+  stats.completed   = m_completed.load(std::memory_order_relaxed);
+  stats.cancelled   = m_cancelled.load(std::memory_order_relaxed);
+  stats.steals      = m_steals.load(std::memory_order_relaxed);
+  stats.in_flight   = static_cast<Int64>(stats.submitted - stats.completed - stats.cancelled);
+  stats.wait_time   = m_wait_time.snapshot();
+  stats.run_time    = m_run_time.snapshot();
+  stats.queue_depth = m_queue_depth.snapshot();
+  stats.idle_time   = m_idle_time.snapshot();
+  return stats;
+}
+
+Void
+ExecutorMetrics::reset() noexcept
+{
+  m_submitted.store(0, std::memory_order_relaxed);
+  m_completed.store(0, std::memory_order_relaxed);
+  m_cancelled.store(0, std::memory_order_relaxed);
+  m_steals.store(0, std::memory_order_relaxed);
+  m_wait_time.reset();
+  m_run_time.reset();
+  m_queue_depth.reset();
+  m_idle_time.reset();
+}
+
+static Void
+log_histogram(Logger& logger, const String& name, const char* label, const HistogramSnapshot& histogram)
+{
+  logger.info("{} {}: n={} mean={} p50={} p90={} p99={} max={}",
+              {name, label, histogram.count, static_cast<UInt64>(histogram.mean()), histogram.percentile(50),
+               histogram.percentile(90), histogram.percentile(99), histogram.max});
+}
+
+Void
+ExecutorStats::log(Logger& logger, const String& name) const
+{
+  logger.info("{}: submitted={} completed={} cancelled={} late={} steals={} in_flight={}",
+              {name, submitted, completed, cancelled, late_tasks, steals, in_flight});
+  log_histogram(logger, name, "wait ns", wait_time);
+  log_histogram(logger, name, "run ns", run_time);
+  log_histogram(logger, name, "queue depth", queue_depth);
+  log_histogram(logger, name, "idle ns", idle_time);
+}
+
+} // namespace setsugen
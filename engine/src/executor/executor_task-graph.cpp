@@ -0,0 +1,243 @@
+#include <setsugen/executor.h>
+
+namespace setsugen
+{
+
+TaskGraph::TaskGraph() : m_compiled(false), m_remaining(0), m_finished(true), m_failed(false)
+{}
+
+TaskGraph::~TaskGraph() = default;
+
+TaskGraph::NodeId
+TaskGraph::add(const String& name, InplaceFn<Void()>&& work)
+{
+  auto node  = std::make_unique<Node>();
+  node->name = name;
+  node->work = std::move(work);
+
+  m_nodes.emplace_back(std::move(node));
+  m_compiled = false;
+  return m_nodes.size() - 1;
+}
+
+TaskGraph&
+TaskGraph::precede(NodeId before, NodeId after)
+{
+  if (before >= m_nodes.size() || after >= m_nodes.size())
+  {
+    throw OutOfBoundsException("Task graph node index out of range");
+  }
+
+  if (before == after)
+  {
+    throw InvalidArgumentException("Task graph node {} cannot depend on itself", {m_nodes[before]->name});
+  }
+
+  m_nodes[before]->successors.push_back(after);
+  m_nodes[after]->predecessors.push_back(before);
+  m_compiled = false;
+  return *this;
+}
+
+Void
+TaskGraph::compile()
+{
+  // Kahn's algorithm, also yields the topological order used to compute the critical path
+  DArray<size_t> in_degree(m_nodes.size());
+  m_roots.clear();
+  m_order.clear();
+  m_order.reserve(m_nodes.size());
+
+  for (NodeId i = 0; i < m_nodes.size(); ++i)
+  {
+    in_degree[i] = m_nodes[i]->predecessors.size();
+    if (in_degree[i] == 0)
+    {
+      m_roots.push_back(i);
+      m_order.push_back(i);
+    }
+  }
+
+  for (size_t head = 0; head < m_order.size(); ++head)
+  {
+    for (auto successor: m_nodes[m_order[head]]->successors)
+    {
+      if (--in_degree[successor] == 0)
+      {
+        m_order.push_back(successor);
+      }
+    }
+  }
+
+  if (m_order.size() != m_nodes.size())
+  {
+    throw InvalidStateException("Task graph contains a cycle");
+  }
+
+  m_compiled = true;
+}
+
+size_t
+TaskGraph::size() const
+{
+  return m_nodes.size();
+}
+
+const String&
+TaskGraph::get_name(NodeId node) const
+{
+  return m_nodes.at(node)->name;
+}
+
+const TaskGraphReport&
+TaskGraph::last_report() const
+{
+  return m_report;
+}
+
+Void
+TaskGraph::begin_run()
+{
+  if (!m_compiled)
+  {
+    compile();
+  }
+
+  for (auto& node: m_nodes)
+  {
+    node->pending.store(static_cast<Int32>(node->predecessors.size()), std::memory_order_relaxed);
+    node->start    = 0;
+    node->duration = 0;
+  }
+
+  m_error = nullptr;
+  m_failed.store(false, std::memory_order_relaxed);
+  m_remaining.store(m_nodes.size(), std::memory_order_release);
+  m_finished  = m_nodes.empty();
+  m_run_start = std::chrono::steady_clock::now();
+}
+
+Void
+TaskGraph::execute(NodeId index)
+{
+  using Milliseconds = std::chrono::duration<Float64, std::milli>;
+
+  auto& node  = *m_nodes[index];
+  auto  start = std::chrono::steady_clock::now();
+
+  // Once a task failed the rest of the graph is only walked to release the waiting thread
+  if (!m_failed.load(std::memory_order_relaxed))
+  {
+    try
+    {
+      node.work();
+    }
+    catch (...)
+    {
+      if (!m_failed.exchange(true))
+      {
+        m_error = std::current_exception();
+      }
+    }
+  }
+
+  auto end      = std::chrono::steady_clock::now();
+  node.start    = Milliseconds(start - m_run_start).count();
+  node.duration = Milliseconds(end - start).count();
+}
+
+Void
+TaskGraph::cancel(NodeId node)
+{
+  if (!m_failed.exchange(true))
+  {
+    m_error = std::make_exception_ptr(InvalidStateException("Executor is stopped"));
+  }
+
+  // The successors which were waiting only for this node will never be submitted either, they are counted down here
+  DArray<NodeId> skipped{node};
+  while (!skipped.empty())
+  {
+    auto index = skipped.back();
+    skipped.pop_back();
+
+    for (auto successor: m_nodes[index]->successors)
+    {
+      if (m_nodes[successor]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        skipped.push_back(successor);
+      }
+    }
+
+    finish_node();
+  }
+}
+
+Void
+TaskGraph::finish_node()
+{
+  if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    // The flag is set under the lock so the waiting thread cannot return, and possibly destroy the graph, before the
+    // last task is done touching it
+    Lock lock(m_finished_mutex);
+    m_finished = true;
+    m_finished_cond.notify_all();
+  }
+}
+
+Void
+TaskGraph::end_run()
+{
+  {
+    ULock lock(m_finished_mutex);
+    m_finished_cond.wait(lock, [this] { return m_finished; });
+  }
+
+  auto wall = std::chrono::steady_clock::now() - m_run_start;
+
+  // Longest path through the graph, weighted by the measured duration of every task
+  DArray<Float64> finish(m_nodes.size(), 0);
+  DArray<NodeId>  parent(m_nodes.size(), m_nodes.size());
+  NodeId          last = m_nodes.size();
+  for (auto index: m_order)
+  {
+    auto& node = *m_nodes[index];
+    for (auto predecessor: node.predecessors)
+    {
+      if (parent[index] == m_nodes.size() || finish[predecessor] > finish[index])
+      {
+        finish[index] = finish[predecessor];
+        parent[index] = predecessor;
+      }
+    }
+
+    finish[index] += node.duration;
+    if (last == m_nodes.size() || finish[index] > finish[last])
+    {
+      last = index;
+    }
+  }
+
+  m_report.wall_time     = std::chrono::duration<Float64, std::milli>(wall).count();
+  m_report.critical_time = last == m_nodes.size() ? 0 : finish[last];
+  m_report.critical_path.clear();
+  for (auto index = last; index != m_nodes.size(); index = parent[index])
+  {
+    m_report.critical_path.push_back(index);
+  }
+  std::reverse(m_report.critical_path.begin(), m_report.critical_path.end());
+
+  m_report.nodes.resize(m_nodes.size());
+  for (NodeId i = 0; i < m_nodes.size(); ++i)
+  {
+    m_report.nodes[i] = {m_nodes[i]->name, m_nodes[i]->start, m_nodes[i]->duration};
+  }
+
+  if (m_error)
+  {
+    std::rethrow_exception(m_error);
+  }
+}
+
+} // namespace setsugen
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <bit>
+
+namespace setsugen
+{
+
+/**
+ * @brief Chase-Lev work-stealing deque.
+ * The owner thread pushes and takes at the bottom, any other thread may steal from the top.
+ * Only trivially copyable values (usually pointers) are stored so that slots can be atomics.
+ * Retired ring buffers are kept alive until the deque is destroyed, since a thief may still be
+ * reading from one after the owner has grown the deque.
+ *
+ * Reference: N.M. Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+ *
+ * @tparam T
+ */
+template<typename T>
+  requires std::is_trivially_copyable_v<T>
+class WorkStealingDeque
+{
+public:
+  explicit WorkStealingDeque(Int64 capacity = 256) : m_top{0}, m_bottom{0}
+  {
+    m_buffers.emplace_back(std::make_unique<Buffer>(std::bit_ceil(static_cast<UInt64>(capacity))));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&)            = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  /**
+   * @brief Push a value at the bottom of the deque.
+   * Must only be called by the owner thread.
+   */
+  Void push(T value)
+  {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top    = m_top.load(std::memory_order_acquire);
+    auto buffer = m_buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > buffer->capacity() - 1)
+    {
+      buffer = grow(buffer, top, bottom);
+    }
+
+    buffer->put(bottom, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Take a value from the bottom of the deque.
+   * Must only be called by the owner thread.
+   */
+  Optional<T> take()
+  {
+    auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto buffer = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    Optional<T> value = buffer->get(bottom);
+    if (top == bottom)
+    {
+      // Last element, race against thieves for it
+      if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        value = std::nullopt;
+      }
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return value;
+  }
+
+  /**
+   * @brief Steal a value from the top of the deque.
+   * Can be called from any thread. Returns an empty optional if the deque is empty or if the steal lost a race.
+   */
+  Optional<T> steal()
+  {
+    auto top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+      return std::nullopt;
+    }
+
+    auto buffer = m_buffer.load(std::memory_order_acquire);
+    T    value  = buffer->get(top);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+      return std::nullopt;
+    }
+
+    return value;
+  }
+
+  Bool empty() const
+  {
+    return size() == 0;
+  }
+
+  Int64 size() const
+  {
+    auto bottom = m_bottom.load(std::memory_order_relaxed);
+    auto top    = m_top.load(std::memory_order_relaxed);
+    return bottom > top ? bottom - top : 0;
+  }
+
+private:
+  class Buffer
+  {
+  public:
+    explicit Buffer(UInt64 capacity) : m_mask{static_cast<Int64>(capacity) - 1}, m_slots(capacity)
+    {}
+
+    Int64 capacity() const
+    {
+      return m_mask + 1;
+    }
+
+    T get(Int64 index) const
+    {
+      return m_slots[index & m_mask].load(std::memory_order_relaxed);
+    }
+
+    Void put(Int64 index, T value)
+    {
+      m_slots[index & m_mask].store(value, std::memory_order_relaxed);
+    }
+
+  private:
+    Int64             m_mask;
+    DArray<Atomic<T>> m_slots;
+  };
+
+  Buffer* grow(Buffer* buffer, Int64 top, Int64 bottom)
+  {
+    auto grown = std::make_unique<Buffer>(static_cast<UInt64>(buffer->capacity()) * 2);
+    for (auto i = top; i < bottom; ++i)
+    {
+      grown->put(i, buffer->get(i));
+    }
+
+    auto result = grown.get();
+    m_buffers.emplace_back(std::move(grown));
+    m_buffer.store(result, std::memory_order_release);
+    return result;
+  }
+
+  alignas(64) Atomic<Int64> m_top;
+  alignas(64) Atomic<Int64> m_bottom;
+  Atomic<Buffer*>           m_buffer;
+  DArray<Owner<Buffer>>     m_buffers;
+};
+
+} // namespace setsugen
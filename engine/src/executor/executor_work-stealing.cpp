@@ -0,0 +1,409 @@
+#include <setsugen/executor.h>
+
+#include "executor_mpmc-queue.h"
+#include "executor_platform-utilities.h"
+#include "executor_work-stealing-deque.h"
+
+namespace setsugen
+{
+
+struct WorkStealingExecutor::Worker
+{
+  ~Worker()
+  {
+    for (auto node: free_nodes)
+    {
+      delete node;
+    }
+  }
+
+  WorkStealingDeque<ExecutorTask*> deque;
+  Owner<Thread>                    thread;
+  UInt64                           seed;
+  size_t                           node;
+  DArray<ExecutorTask*>            free_nodes;
+};
+
+// Task nodes are recycled instead of freed, a worker keeps up to this many nodes in its own cache and hands the rest
+// back to the shared free list, where workers with an empty cache pick them up.
+static constexpr size_t worker_node_cache = 256;
+
+// The worker the current thread belongs to, used to route submissions from inside a task to the local deque
+static thread_local WorkStealingExecutor* current_executor = nullptr;
+static thread_local size_t                current_worker   = 0;
+
+WorkStealingExecutor::WorkStealingExecutor(size_t num_threads)
+    : WorkStealingExecutor(ExecutorOptions{.num_threads = num_threads})
+{}
+
+WorkStealingExecutor::WorkStealingExecutor(const ExecutorOptions& options)
+    : m_stopped(true), m_num_threads(options.num_threads), m_thread_name(options.thread_name)
+{
+  if (m_num_threads == 0)
+  {
+    m_num_threads = options.cpus.empty() ? std::thread::hardware_concurrency() : options.cpus.size();
+  }
+
+  if (m_num_threads == 0)
+  {
+    m_num_threads = 1;
+  }
+
+  m_layout = std::make_unique<ThreadLayout>(plan_thread_layout(options, m_num_threads));
+  for (size_t i = 0; i < m_layout->num_nodes; ++i)
+  {
+    m_injection.emplace_back(std::make_unique<PriorityTaskQueue<ExecutorTask>>());
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+  stop();
+  join();
+
+  for (auto node: m_free_nodes)
+  {
+    delete node;
+  }
+}
+
+Void
+WorkStealingExecutor::start()
+{
+  if (!m_stopped)
+  {
+    return;
+  }
+
+  join();
+
+  m_workers.clear();
+  for (size_t i = 0; i < m_num_threads; ++i)
+  {
+    auto worker  = std::make_unique<Worker>();
+    worker->seed = i * 0x9E3779B97F4A7C15ull + 1;
+    worker->node = m_layout->threads[i].node;
+    worker->free_nodes.reserve(worker_node_cache * 2 + 1);
+    m_workers.emplace_back(std::move(worker));
+  }
+
+  reset_stop_token();
+  m_stopped = false;
+
+  for (size_t i = 0; i < m_num_threads; ++i)
+  {
+    m_workers[i]->thread = std::make_unique<Thread>([this, i] { worker_loop(i); });
+  }
+}
+
+Void
+WorkStealingExecutor::stop()
+{
+  if (m_stopped.exchange(true))
+  {
+    return;
+  }
+
+  notify();
+  cancel_pending();
+}
+
+Void
+WorkStealingExecutor::force_stop()
+{
+  // Workers never block inside the executor itself, so waking them up is enough to make them leave.
+  // Tasks which are already running see the stop request on their token.
+  request_stop();
+  stop();
+}
+
+Void
+WorkStealingExecutor::join()
+{
+  for (auto& worker: m_workers)
+  {
+    if (worker->thread && worker->thread->joinable() && worker->thread->get_id() != std::this_thread::get_id())
+    {
+      worker->thread->join();
+    }
+  }
+
+  // A task that was running while the executor stopped may still have pushed work to its local deque
+  if (m_stopped)
+  {
+    cancel_pending();
+  }
+}
+
+Bool
+WorkStealingExecutor::is_stopped() const
+{
+  return m_stopped;
+}
+
+size_t
+WorkStealingExecutor::get_num_threads() const
+{
+  return m_num_threads;
+}
+
+size_t
+WorkStealingExecutor::get_num_nodes() const
+{
+  return m_layout->num_nodes;
+}
+
+Void
+WorkStealingExecutor::enqueue(ExecutorTask&& task, TaskPriority priority)
+{
+  if (m_stopped)
+  {
+    std::invoke(task, true);
+    return;
+  }
+
+  reserve_pending();
+
+  // Only normal tasks go to the local deque, critical and background tasks must be visible to every worker so that
+  // the lanes are honoured across the whole pool
+  if (current_executor == this && priority == TaskPriority::Normal)
+  {
+    m_workers[current_worker]->deque.push(acquire_node(std::move(task)));
+  }
+  else
+  {
+    auto node = current_executor == this ? m_workers[current_worker]->node : current_node();
+    m_injection[node]->push(std::move(task), priority);
+  }
+
+  notify_parked();
+}
+
+WorkStealingExecutor::ExecutorTask
+WorkStealingExecutor::dequeue()
+{
+  ExecutorTask task;
+  for (auto& injection: m_injection)
+  {
+    if (injection->try_pop(task))
+    {
+      release_pending();
+      return task;
+    }
+  }
+
+  ExecutorTask* ptask = nullptr;
+  for (size_t i = 0; i < m_workers.size() && !ptask; ++i)
+  {
+    ptask = m_workers[i]->deque.steal().value_or(nullptr);
+  }
+
+  if (!ptask)
+  {
+    return nullptr;
+  }
+
+  release_pending();
+  task = std::move(*ptask);
+  release_node(ptask);
+  return task;
+}
+
+Void
+WorkStealingExecutor::worker_loop(size_t index)
+{
+  constexpr Int32 spin_rounds = 64;
+
+  current_executor = this;
+  current_worker   = index;
+
+  configure_current_thread(m_thread_name.empty() ? m_thread_name : m_thread_name + "-" + std::to_string(index),
+                           m_layout->threads[index].cpus);
+
+  while (!m_stopped)
+  {
+    ExecutorTask* ptask = nullptr;
+    for (Int32 i = 0; i < spin_rounds && !ptask && !m_stopped; ++i)
+    {
+      ptask = find_task(index);
+      if (!ptask)
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    if (!ptask)
+    {
+      park();
+      continue;
+    }
+
+    std::invoke(*ptask, false);
+    release_node(ptask);
+  }
+
+  current_executor = nullptr;
+}
+
+WorkStealingExecutor::ExecutorTask*
+WorkStealingExecutor::find_task(size_t index)
+{
+  // Within each lane the own node is tried before reaching into the memory of another node
+  auto node = m_workers[index]->node;
+  auto task = pop_injected(node, TaskPriority::Critical, false);
+
+  if (!task)
+  {
+    task = m_workers[index]->deque.take().value_or(nullptr);
+  }
+
+  if (!task)
+  {
+    task = pop_injected(node, TaskPriority::Normal, true);
+  }
+
+  if (!task)
+  {
+    task = steal_task(index, true);
+  }
+
+  if (!task)
+  {
+    task = pop_injected(node, TaskPriority::Normal, false);
+  }
+
+  if (!task)
+  {
+    task = steal_task(index, false);
+  }
+
+  if (!task)
+  {
+    task = pop_injected(node, TaskPriority::Background, false);
+  }
+
+  if (task)
+  {
+    release_pending();
+  }
+
+  return task;
+}
+
+WorkStealingExecutor::ExecutorTask*
+WorkStealingExecutor::steal_task(size_t thief, Bool same_node)
+{
+  auto count = m_workers.size();
+  if (count < 2)
+  {
+    return nullptr;
+  }
+
+  // xorshift to pick a random first victim, so thieves do not all hammer the same worker
+  auto& seed = m_workers[thief]->seed;
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+
+  auto start = static_cast<size_t>(seed % count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto victim = (start + i) % count;
+    if (victim == thief || (m_workers[victim]->node == m_workers[thief]->node) != same_node)
+    {
+      continue;
+    }
+
+    if (auto task = m_workers[victim]->deque.steal())
+    {
+      record_steal();
+      return *task;
+    }
+  }
+
+  return nullptr;
+}
+
+WorkStealingExecutor::ExecutorTask*
+WorkStealingExecutor::pop_injected(size_t node, TaskPriority priority, Bool same_node)
+{
+  auto count = same_node ? 1 : m_injection.size();
+  for (size_t i = 0; i < count; ++i)
+  {
+    ExecutorTask task;
+    if (m_injection[(node + i) % m_injection.size()]->try_pop(task, priority))
+    {
+      return acquire_node(std::move(task));
+    }
+  }
+
+  return nullptr;
+}
+
+size_t
+WorkStealingExecutor::current_node() const
+{
+  if (m_layout->num_nodes == 1)
+  {
+    return 0;
+  }
+
+  auto  cpu   = get_current_cpu();
+  auto& nodes = m_layout->cpu_nodes;
+  if (cpu < 0 || cpu >= static_cast<Int32>(nodes.size()) || nodes[cpu] < 0)
+  {
+    return 0;
+  }
+
+  return static_cast<size_t>(nodes[cpu]);
+}
+
+WorkStealingExecutor::ExecutorTask*
+WorkStealingExecutor::acquire_node(ExecutorTask&& task)
+{
+  // Only worker threads wrap tasks into nodes, external submitters go through the injection queue by value
+  auto& cache = m_workers[current_worker]->free_nodes;
+
+  if (cache.empty())
+  {
+    Lock lock(m_node_mutex);
+    auto count = std::min(m_free_nodes.size(), worker_node_cache);
+    cache.insert(cache.end(), m_free_nodes.end() - static_cast<PtrDiff>(count), m_free_nodes.end());
+    m_free_nodes.resize(m_free_nodes.size() - count);
+  }
+
+  if (cache.empty())
+  {
+    return new ExecutorTask(std::move(task));
+  }
+
+  auto node = cache.back();
+  cache.pop_back();
+  *node = std::move(task);
+  return node;
+}
+
+Void
+WorkStealingExecutor::release_node(ExecutorTask* node)
+{
+  *node = nullptr;
+
+  if (current_executor != this)
+  {
+    Lock lock(m_node_mutex);
+    m_free_nodes.push_back(node);
+    return;
+  }
+
+  auto& cache = m_workers[current_worker]->free_nodes;
+  cache.push_back(node);
+
+  if (cache.size() > worker_node_cache * 2)
+  {
+    Lock lock(m_node_mutex);
+    m_free_nodes.insert(m_free_nodes.end(), cache.begin() + worker_node_cache, cache.end());
+    cache.resize(worker_node_cache);
+  }
+}
+
+} // namespace setsugen
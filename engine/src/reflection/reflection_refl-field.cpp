@@ -8,4 +8,10 @@ ReflectionField::get_name() const
   return m_name;
 }
 
+ReflectionSlot
+ReflectionField::get_slot(Void* target) const
+{
+  return {m_address(target), &m_reader()};
+}
+
 }
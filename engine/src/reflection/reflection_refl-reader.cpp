@@ -0,0 +1,176 @@
+#include <setsugen/refl.h>
+
+#include <utility>
+
+namespace setsugen
+{
+
+ReflectionValueReader::ReflectionValueReader(const char* expected) : m_expected(expected)
+{}
+
+Void
+ReflectionValueReader::on_null(Void* /*target*/) const
+{
+  unexpected("null");
+}
+
+Void
+ReflectionValueReader::on_bool(Void* /*target*/, Bool /*value*/) const
+{
+  unexpected("boolean");
+}
+
+Void
+ReflectionValueReader::on_int(Void* /*target*/, Int64 /*value*/) const
+{
+  unexpected("integer");
+}
+
+Void
+ReflectionValueReader::on_float(Void* /*target*/, Float64 /*value*/) const
+{
+  unexpected("float");
+}
+
+Void
+ReflectionValueReader::on_string(Void* /*target*/, StringView /*value*/) const
+{
+  unexpected("string");
+}
+
+Void
+ReflectionValueReader::begin_object(Void* /*target*/) const
+{
+  unexpected("object");
+}
+
+ReflectionSlot
+ReflectionValueReader::member(Void* /*target*/, StringView /*key*/) const
+{
+  unexpected("object");
+}
+
+Void
+ReflectionValueReader::begin_array(Void* /*target*/) const
+{
+  unexpected("array");
+}
+
+ReflectionSlot
+ReflectionValueReader::element(Void* /*target*/, size_t /*index*/) const
+{
+  unexpected("array");
+}
+
+Void
+ReflectionValueReader::unexpected(const char* found) const
+{
+  throw InvalidFormatException("Expected {}, found {}", {m_expected, found});
+}
+
+ReflectionSlot
+ReflectionReader::next_slot()
+{
+  if (m_stack.empty() || m_stack.back().object)
+  {
+    return std::exchange(m_slot, {});
+  }
+
+  auto& frame = m_stack.back();
+  if (!frame.slot.reader)
+  {
+    return {};
+  }
+
+  return frame.slot.reader->element(frame.slot.target, frame.index++);
+}
+
+Void
+ReflectionReader::on_null()
+{
+  if (auto slot = next_slot(); slot.reader)
+  {
+    slot.reader->on_null(slot.target);
+  }
+}
+
+Void
+ReflectionReader::on_bool(Bool value)
+{
+  if (auto slot = next_slot(); slot.reader)
+  {
+    slot.reader->on_bool(slot.target, value);
+  }
+}
+
+Void
+ReflectionReader::on_int(Int64 value)
+{
+  if (auto slot = next_slot(); slot.reader)
+  {
+    slot.reader->on_int(slot.target, value);
+  }
+}
+
+Void
+ReflectionReader::on_float(Float64 value)
+{
+  if (auto slot = next_slot(); slot.reader)
+  {
+    slot.reader->on_float(slot.target, value);
+  }
+}
+
+Void
+ReflectionReader::on_string(StringView value)
+{
+  if (auto slot = next_slot(); slot.reader)
+  {
+    slot.reader->on_string(slot.target, value);
+  }
+}
+
+Void
+ReflectionReader::on_key(StringView key)
+{
+  const auto& frame = m_stack.back();
+  m_slot            = frame.slot.reader ? frame.slot.reader->member(frame.slot.target, key) : ReflectionSlot{};
+}
+
+Void
+ReflectionReader::on_object_begin()
+{
+  auto slot = next_slot();
+  if (slot.reader)
+  {
+    slot.reader->begin_object(slot.target);
+  }
+
+  m_stack.push_back({slot, 0, true});
+}
+
+Void
+ReflectionReader::on_object_end()
+{
+  m_stack.pop_back();
+}
+
+Void
+ReflectionReader::on_array_begin()
+{
+  auto slot = next_slot();
+  if (slot.reader)
+  {
+    slot.reader->begin_array(slot.target);
+  }
+
+  m_stack.push_back({slot, 0, false});
+}
+
+Void
+ReflectionReader::on_array_end()
+{
+  m_stack.pop_back();
+}
+
+} // namespace setsugen
@@ -24,4 +24,41 @@ Json::deserialize(InputStream& stream, SerializedData& data) const
   parser::JsonParser parser(stream, data);
   parser.parse();
 }
+
+Void
+Json::deserialize(StringView input, SerializedData& data) const
+{
+  parser::JsonParser parser(input, data);
+  parser.parse();
+}
+
+Void
+Json::deserialize(InputStream& stream, SerializedDocument& document) const
+{
+  document.clear();
+  parser::JsonDocumentParser parser(stream, document);
+  parser.parse();
+}
+
+Void
+Json::deserialize(StringView input, SerializedDocument& document) const
+{
+  document.clear();
+  parser::JsonDocumentParser parser(input, document);
+  parser.parse();
+}
+
+Void
+Json::deserialize(InputStream& stream, SerializedVisitor& visitor) const
+{
+  parser::JsonEventParser<SerializedVisitor> parser(visitor);
+  parser.parse(stream);
+}
+
+Void
+Json::deserialize(StringView input, SerializedVisitor& visitor) const
+{
+  parser::JsonEventParser<SerializedVisitor> parser(visitor);
+  parser.parse(input);
+}
 }
\ No newline at end of file
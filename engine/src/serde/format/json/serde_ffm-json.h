@@ -3,70 +3,244 @@
 #include <setsugen/exception.h>
 #include <setsugen/serde.h>
 
-extern "C"
-{
-#include <json.h>
-}
-
 namespace setsugen::parser
 {
-struct JsonNode
+/**
+ * @brief Finds the structural characters of a JSON text, simdjson's stage 1.
+ * The input is classified 64 bytes at a time into bitmasks, escapes and string interiors are resolved with bit
+ * arithmetic carried from one block to the next, and the positions of the remaining brackets, colons, commas and value
+ * starts are written out a window at a time so that the index stays small whatever the size of the input. A stream is
+ * read into a buffer a window at a time as well, which only keeps the text from the next structural character on.
+ */
+class JsonStructuralIndexer
 {
-  SerializedData*       value;
-  JsonNode*             parent = nullptr;
-  DArray<JsonNode> children;
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  explicit JsonStructuralIndexer(StringView input);
+  explicit JsonStructuralIndexer(InputStream& stream);
+
+  /**
+   * @brief Position of the next structural character in `input()`, npos once the input is exhausted.
+   * A position is only handed out once the one after it is indexed too, so the value it starts is whole in `input()`.
+   */
+  size_t next()
+  {
+    while (m_cursor + 1 >= m_count)
+    {
+      if (m_scanned == m_input.size() && !m_stream)
+      {
+        break;
+      }
+      scan_window();
+    }
+
+    return m_cursor < m_count ? m_indices[m_cursor++] : npos;
+  }
+
+  /**
+   * @brief The text the positions refer to, which moves whenever `next` reads more of a stream.
+   */
+  StringView input() const
+  {
+    return m_input;
+  }
+
+  /**
+   * @brief Offset of `input()` in the whole text.
+   */
+  size_t offset() const
+  {
+    return m_offset;
+  }
+
+private:
+  static constexpr size_t block_size    = 64;
+  static constexpr size_t window_blocks = 256;
+  static constexpr size_t window_size   = window_blocks * block_size;
+
+  Void scan_window();
+  Void scan_block(const char* block, size_t position);
+  Void refill();
+
+  InputStream*   m_stream; // Null for an in-memory text and once the stream is exhausted
+  String         m_buffer;
+  StringView     m_input;
+  size_t         m_offset;
+  size_t         m_scanned;
+  DArray<size_t> m_indices;
+  size_t         m_count;
+  size_t         m_cursor;
+  UInt64         m_prev_in_string;
+  UInt64         m_prev_escaped;
+  UInt64         m_prev_scalar;
+};
+
+/**
+ * @brief Drives a visitor with the events of a JSON parse, simdjson's stage 2.
+ * The text is walked along the structural index and validated against the JSON grammar on the way. Strings without
+ * escapes are reported as views into the input, numbers are converted in place with `from_chars` and integers which do
+ * not fit in 64 bits are reported as floats. Visitor is either SerializedVisitor or a final parser, whose handlers are
+ * then called directly.
+ */
+template<typename Visitor>
+class JsonEventParser
+{
+public:
+  explicit JsonEventParser(Visitor& visitor);
+
+  /**
+   * @brief Parse a stream, of which only the value being read is buffered at a time.
+   */
+  Void parse(InputStream& stream);
+
+  /**
+   * @brief Parse an in-memory text, strings without escapes are reported as views into it.
+   */
+  Void parse(StringView input);
+
+private:
+  Void       parse(JsonStructuralIndexer& indexer);
+  size_t     next(JsonStructuralIndexer& indexer);
+  size_t     read_key(JsonStructuralIndexer& indexer, size_t position);
+  StringView read_string(size_t position);
+  Void       read_number(size_t position);
+  Void       read_literal(size_t position);
+  Void       expect_end(size_t position);
+
+  [[noreturn]] Void unexpected(size_t position, const char* expected) const;
+
+  Visitor&     m_visitor;
+  StringView   m_input;
+  size_t       m_offset; // Of m_input in the whole text, for error messages
+  String       m_scratch;
+  DArray<char> m_stack; // Closing character of each open container
 };
 
-class JsonParser
+/**
+ * @brief Parses a JSON stream into a SerializedData.
+ * Open containers are owned by a stack and moved into their parent when they are closed, so nothing is copied and no
+ * pointer into a growing container is ever kept.
+ */
+class JsonParser final : public SerializedVisitor
 {
 public:
   JsonParser(InputStream& stream, SerializedData& data);
-  ~JsonParser();
+  JsonParser(StringView input, SerializedData& data);
 
   Void parse();
 
-  static Int32 json_event_callback(Void* userdata, Int32 type, const char* data, uint32_t len);
+  Void on_null() override;
+  Void on_bool(Bool value) override;
+  Void on_int(Int64 value) override;
+  Void on_float(Float64 value) override;
+  Void on_string(StringView value) override;
+  Void on_key(StringView key) override;
+  Void on_object_begin() override;
+  Void on_object_end() override;
+  Void on_array_begin() override;
+  Void on_array_end() override;
 
 private:
-  Void handle_new_object();
-  Void handle_end_object();
-  Void handle_new_array();
-  Void handle_end_array();
-  Void handle_key(const char* data, uint32_t len);
-  Void handle_new_string(const char* data, uint32_t len);
-  Void handle_new_int(const char* data, uint32_t len);
-  Void handle_new_float(const char* data, uint32_t len);
-  Void handle_new_bool(Bool b);
-  Void handle_new_null();
-
-  InputStream&   m_stream;
+  Void begin_container(SerializedData&& container);
+  Void end_container();
+  Void add_value(SerializedData&& value);
+
+  struct Frame
+  {
+    SerializedData value;
+    String         key; // Key of the container in its parent object
+  };
+
+  InputStream*    m_stream;
+  StringView      m_input;
   SerializedData& m_data;
-  json_parser     m_parser;
 
-  JsonNode                   m_root;
-  JsonNode*                  m_current;
-  std::optional<String> m_key;
+  DArray<Frame> m_stack;
+  String        m_key;
 };
+
+/**
+ * @brief Parses JSON straight into the arena of a SerializedDocument.
+ * When constructed over an in-memory input, strings and keys without escape sequences are borrowed from the input
+ * instead of being copied, the input then has to outlive the document.
+ */
+class JsonDocumentParser final : public SerializedVisitor
+{
+public:
+  JsonDocumentParser(InputStream& stream, SerializedDocument& document);
+  JsonDocumentParser(StringView input, SerializedDocument& document);
+
+  Void parse();
+
+  Void on_null() override;
+  Void on_bool(Bool value) override;
+  Void on_int(Int64 value) override;
+  Void on_float(Float64 value) override;
+  Void on_string(StringView value) override;
+  Void on_key(StringView key) override;
+  Void on_object_begin() override;
+  Void on_object_end() override;
+  Void on_array_begin() override;
+  Void on_array_end() override;
+
+private:
+  Optional<StringView> borrow(StringView value);
+
+  InputStream*    m_stream;
+  StringView      m_input;
+  DocumentBuilder m_builder;
+};
+
+/**
+ * @brief First quote, backslash or control character in [begin, end), `end` if there is none. These are the characters
+ * which end a run of a string that can be copied as is, both when parsing and when emitting.
+ */
+const char* find_string_special(const char* begin, const char* end);
+
+extern template class JsonEventParser<SerializedVisitor>;
+extern template class JsonEventParser<JsonParser>;
+extern template class JsonEventParser<JsonDocumentParser>;
 }
 
 namespace setsugen::emitter
 {
+/**
+ * @brief Writes a SerializedData as JSON text into a contiguous buffer, which is handed to the stream whenever it is
+ * full and once at the end. Numbers are formatted with `to_chars`, floats in their shortest form which parses back to
+ * the same value, and strings are copied a run at a time between the characters which have to be escaped. Pretty and
+ * compact output are separate instantiations, so neither checks the configuration per value.
+ */
 class JsonEmitter
 {
 public:
-  JsonEmitter(OutputStream& stream, const SerializedData& data, const Json::Configurations& conf) noexcept;
-  ~JsonEmitter() noexcept;
+  JsonEmitter(OutputStream& stream, const SerializedData& data, const Json::Configurations& conf);
 
   Void emit();
-  Void emit(const SerializedData& data);
-
-  static Int32 json_event_callback(Void* userdata, const char* s, uint32_t length);
 
 private:
+  static constexpr size_t chunk_size = 64 * 1024;
+
+  template<Bool Pretty>
+  Void write_value(const SerializedData& data, size_t depth);
+
+  Void write_string(StringView value);
+  Void write_integer(Int64 value);
+  Void write_float(Float64 value);
+  Void write_indent(size_t depth);
+  Void write(const char* data, size_t length);
+  Void put(char c);
+
+  /**
+   * @brief Room for at least `length` more characters at the end of the buffer, flushing or growing it as needed.
+   */
+  char* reserve(size_t length);
+  Void  flush();
+
   OutputStream&               m_stream;
   const SerializedData&       m_data;
-  json_printer                m_printer;
-  String                 m_indent_str;
   const Json::Configurations& m_config;
+  DArray<char>                m_buffer;
+  size_t                      m_size;
 };
 }
@@ -8,116 +8,139 @@
 
 #include "serde_ffm-json.h"
 
+#include <charconv>
+
 namespace setsugen::emitter
 {
-inline Void
-json_print_element(json_printer* p, Int32 el, const char* data, std::size_t len, Bool pretty)
+JsonEmitter::JsonEmitter(OutputStream& stream, const SerializedData& data, const Json::Configurations& conf)
+  : m_stream(stream),
+    m_data(data),
+    m_config(conf),
+    m_buffer(chunk_size),
+    m_size(0)
+{}
+
+Void
+JsonEmitter::emit()
 {
-  if (pretty)
+  if (m_config.serializer_config.pretty_print)
   {
-    json_print_pretty(p, el, data, len);
+    write_value<true>(m_data, 0);
   }
   else
   {
-    json_print_raw(p, el, data, len);
-  }
-}
-
-JsonEmitter::JsonEmitter(OutputStream& stream, const SerializedData& data, const Json::Configurations& conf) noexcept
-  : m_stream(stream),
-    m_data(data),
-    m_config(conf)
-{
-  StringStream ss;
-  for (Int32 i = 0; i < conf.serializer_config.indent; ++i)
-  {
-    ss << conf.serializer_config.indent_char;
+    write_value<false>(m_data, 0);
   }
-  m_indent_str = ss.str();
-
-  std::memset(&m_printer, 0, sizeof(m_printer));
-  json_print_init(&m_printer, JsonEmitter::json_event_callback, this);
-  m_printer.indentstr = m_indent_str.data();
-}
 
-JsonEmitter::~JsonEmitter() noexcept
-{
-  json_print_free(&m_printer);
+  flush();
 }
 
+template<Bool Pretty>
 Void
-JsonEmitter::emit()
-{
-  this->emit(m_data);
-}
-
-Void
-JsonEmitter::emit(const SerializedData& data)
+JsonEmitter::write_value(const SerializedData& data, size_t depth)
 {
   switch (data.get_type())
   {
     case SerializedType::Integer:
     {
-      auto str = std::to_string(data.get_integer().value());
-      json_print_element(&m_printer, JSON_INT, str.c_str(), str.size(),
-                         m_config.serializer_config.pretty_print);
+      write_integer(data.get_integer().value());
     }
     break;
 
     case SerializedType::Float:
     {
-      auto str = std::to_string(data.get_float().value());
-      json_print_element(&m_printer, JSON_FLOAT, str.c_str(), str.size(),
-                         m_config.serializer_config.pretty_print);
+      write_float(data.get_float().value());
     }
+    break;
 
     case SerializedType::String:
     {
-      json_print_element(&m_printer, JSON_STRING, data.get_string().value().c_str(), data.get_string().value().size(),
-                         m_config.serializer_config.pretty_print);
+      write_string(data.get_string().view());
     }
     break;
 
     case SerializedType::Bool:
     {
-      json_print_element(&m_printer, data.get_bool().value() ? JSON_TRUE : JSON_FALSE, nullptr, 0,
-                         m_config.serializer_config.pretty_print);
+      if (data.get_bool().value())
+      {
+        write("true", 4);
+      }
+      else
+      {
+        write("false", 5);
+      }
     }
     break;
 
     case SerializedType::Null:
     {
-      json_print_element(&m_printer, JSON_NULL, nullptr, 0,
-                         m_config.serializer_config.pretty_print);
+      write("null", 4);
     }
     break;
 
     case SerializedType::Array:
     {
-      if (m_config.serializer_config.pretty_print)
-      {
-        json_print_pretty(&m_printer, JSON_ARRAY_BEGIN, nullptr, 0);
-      }
-      for (const auto& elem: data.get_array())
+      const auto& array = data.get_array();
+      put('[');
+      for (size_t i = 0; i < array.size(); ++i)
       {
-        this->emit(elem);
+        if (i != 0)
+        {
+          put(',');
+        }
+
+        if constexpr (Pretty)
+        {
+          write_indent(depth + 1);
+        }
+        write_value<Pretty>(array[i], depth + 1);
       }
-      if (m_config.serializer_config.pretty_print)
+
+      if constexpr (Pretty)
       {
-        json_print_pretty(&m_printer, JSON_ARRAY_END, nullptr, 0);
+        if (array.size() != 0)
+        {
+          write_indent(depth);
+        }
       }
+      put(']');
     }
     break;
 
     case SerializedType::Object:
     {
-      json_print_pretty(&m_printer, JSON_OBJECT_BEGIN, nullptr, 0);
+      Bool first = true;
+      put('{');
       for (const auto& [key, value]: data.get_object())
       {
-        json_print_pretty(&m_printer, JSON_KEY, key.c_str(), key.size());
-        this->emit(value);
+        if (!first)
+        {
+          put(',');
+        }
+
+        if constexpr (Pretty)
+        {
+          write_indent(depth + 1);
+          write_string(key);
+          write(": ", 2);
+        }
+        else
+        {
+          write_string(key);
+          put(':');
+        }
+        write_value<Pretty>(value, depth + 1);
+        first = false;
       }
-      json_print_pretty(&m_printer, JSON_OBJECT_END, nullptr, 0);
+
+      if constexpr (Pretty)
+      {
+        if (!first)
+        {
+          write_indent(depth);
+        }
+      }
+      put('}');
     }
     break;
 
@@ -128,11 +151,117 @@ JsonEmitter::emit(const SerializedData& data)
   }
 }
 
-Int32
-JsonEmitter::json_event_callback(Void* userdata, const char* s, uint32_t length)
+Void
+JsonEmitter::write_string(StringView value)
+{
+  static constexpr char hex[] = "0123456789abcdef";
+
+  auto cursor = value.data();
+  auto end    = cursor + value.size();
+
+  put('"');
+  while (true)
+  {
+    auto special = parser::find_string_special(cursor, end);
+    write(cursor, special - cursor);
+    if (special == end)
+    {
+      break;
+    }
+
+    auto c = static_cast<unsigned char>(*special);
+    switch (c)
+    {
+      case '"': write("\\\"", 2); break;
+      case '\\': write("\\\\", 2); break;
+      case '\b': write("\\b", 2); break;
+      case '\f': write("\\f", 2); break;
+      case '\n': write("\\n", 2); break;
+      case '\r': write("\\r", 2); break;
+      case '\t': write("\\t", 2); break;
+      default:
+      {
+        const char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+        write(escape, sizeof(escape));
+      }
+    }
+
+    cursor = special + 1;
+  }
+  put('"');
+}
+
+Void
+JsonEmitter::write_integer(Int64 value)
+{
+  auto out       = reserve(24);
+  auto [last, _] = std::to_chars(out, out + 24, value);
+  m_size += last - out;
+}
+
+Void
+JsonEmitter::write_float(Float64 value)
+{
+  if (!std::isfinite(value))
+  {
+    throw InvalidArgumentException("Cannot write the non-finite number {} as JSON", {std::to_string(value)});
+  }
+
+  auto out       = reserve(32);
+  auto [last, _] = std::to_chars(out, out + 32, value);
+
+  // A float written without a fraction or exponent would be read back as an integer
+  if (std::find_if(out, last, [](char c) { return c == '.' || c == 'e'; }) == last)
+  {
+    *last++ = '.';
+    *last++ = '0';
+  }
+  m_size += last - out;
+}
+
+Void
+JsonEmitter::write_indent(size_t depth)
+{
+  auto width = depth * static_cast<size_t>(m_config.serializer_config.indent);
+  auto out   = reserve(width + 1);
+  out[0]     = '\n';
+  std::memset(out + 1, m_config.serializer_config.indent_char, width);
+  m_size += width + 1;
+}
+
+Void
+JsonEmitter::write(const char* data, size_t length)
+{
+  std::memcpy(reserve(length), data, length);
+  m_size += length;
+}
+
+Void
+JsonEmitter::put(char c)
+{
+  *reserve(1) = c;
+  ++m_size;
+}
+
+char*
+JsonEmitter::reserve(size_t length)
+{
+  if (m_buffer.size() - m_size < length)
+  {
+    flush();
+    if (m_buffer.size() < length)
+    {
+      m_buffer.resize(length);
+    }
+  }
+
+  return m_buffer.data() + m_size;
+}
+
+Void
+JsonEmitter::flush()
 {
-  auto* emitter = static_cast<JsonEmitter*>(userdata);
-  emitter->m_stream.write(s, length);
-  return 0;
+  m_stream.write(m_buffer.data(), m_size);
+  m_size = 0;
 }
 }
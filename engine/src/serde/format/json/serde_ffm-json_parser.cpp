@@ -1,382 +1,1004 @@
 #include "serde_ffm-json.h"
-#include "json.h"
 #include "setsugen/exception.h"
 #include "setsugen/serde.h"
+
+#include <bit>
+#include <charconv>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SETSUGEN_JSON_SSE2
+#endif
+
 namespace setsugen::parser
 {
-JsonParser::JsonParser(InputStream& stream, SerializedData& data)
-  : m_stream(stream),
-    m_data(data)
+
+// Classes of the bytes of a 64 byte block, one bit per byte
+struct BlockMasks
 {
-  std::memset(&m_parser, 0, sizeof(m_parser));
-  json_parser_init(&m_parser, nullptr, JsonParser::json_event_callback, static_cast<Void*>(this));
+  UInt64 whitespace = 0;
+  UInt64 op         = 0; // { } [ ] : ,
+  UInt64 quote      = 0;
+  UInt64 backslash  = 0;
+};
+
+static BlockMasks
+classify_block(const char* block)
+{
+  BlockMasks masks;
+
+#ifdef SETSUGEN_JSON_SSE2
+  for (size_t i = 0; i < 4; ++i)
+  {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+    auto is    = [&chunk](char c) { return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)); };
+
+    // Setting bit 5 turns [ and ] into { and }, no other byte becomes a brace
+    auto lower  = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    auto braces = _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}')));
+
+    auto whitespace = _mm_or_si128(_mm_or_si128(is(' '), is('\t')), _mm_or_si128(is('\n'), is('\r')));
+    auto op         = _mm_or_si128(braces, _mm_or_si128(is(':'), is(',')));
+    auto bits       = [i](__m128i mask)
+    { return static_cast<UInt64>(static_cast<UInt16>(_mm_movemask_epi8(mask))) << (i * 16); };
+
+    masks.whitespace |= bits(whitespace);
+    masks.op |= bits(op);
+    masks.quote |= bits(is('"'));
+    masks.backslash |= bits(is('\\'));
+  }
+#else
+  for (size_t i = 0; i < 64; ++i)
+  {
+    auto bit = UInt64{1} << i;
+    switch (block[i])
+    {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r': masks.whitespace |= bit; break;
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',': masks.op |= bit; break;
+      case '"': masks.quote |= bit; break;
+      case '\\': masks.backslash |= bit; break;
+      default: break;
+    }
+  }
+#endif
+
+  return masks;
 }
 
-JsonParser::~JsonParser()
+// Bit i of the result is the parity of the bits 0 to i of `bits`
+static UInt64
+prefix_xor(UInt64 bits)
 {
-  json_parser_free(&m_parser);
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
 }
 
-Void
-JsonParser::parse()
+// Characters escaped by a backslash, `carry` is set when the last byte of the block escapes the first of the next one.
+// Backslashes are rare outside of a few strings, so they are walked one by one rather than with carry arithmetic
+static UInt64
+find_escaped(UInt64 backslash, UInt64& carry)
 {
-  constexpr const std::size_t buffer_size = 1024;
-  char                        buffer[buffer_size];
-  m_key     = std::nullopt;
-  m_current = nullptr;
+  UInt64 escaped = carry;
+  backslash &= ~carry;
+  carry = 0;
 
-  while (m_stream.good())
+  while (backslash)
   {
-    m_stream.read(buffer, sizeof(buffer));
-
-    if (m_stream.gcount() == 0)
+    auto bit = std::countr_zero(backslash);
+    if (bit == 63)
     {
+      carry = 1;
       break;
     }
 
-    Int32 ret = json_parser_string(&m_parser, buffer, m_stream.gcount(), nullptr);
-    if (!ret)
+    escaped |= UInt64{2} << bit;
+    backslash &= ~(UInt64{3} << bit);
+  }
+
+  return escaped;
+}
+
+JsonStructuralIndexer::JsonStructuralIndexer(StringView input)
+  : m_stream(nullptr),
+    m_input(input),
+    m_offset(0),
+    m_scanned(0),
+    m_indices(window_size + 5),
+    m_count(0),
+    m_cursor(0),
+    m_prev_in_string(0),
+    m_prev_escaped(0),
+    m_prev_scalar(0)
+{}
+
+JsonStructuralIndexer::JsonStructuralIndexer(InputStream& stream)
+  : m_stream(&stream),
+    m_buffer(4 * window_size, '\0'),
+    m_offset(0),
+    m_scanned(0),
+    m_indices(window_size + 5),
+    m_count(0),
+    m_cursor(0),
+    m_prev_in_string(0),
+    m_prev_escaped(0),
+    m_prev_scalar(0)
+{}
+
+Void
+JsonStructuralIndexer::scan_window()
+{
+  if (m_stream && m_input.size() - m_scanned < window_size)
+  {
+    refill();
+  }
+
+  // The position held back by `next` moves to the front, the slack after the window absorbs it and the extra writes
+  auto held = m_count - m_cursor;
+  if (held)
+  {
+    m_indices[0] = m_indices[m_cursor];
+  }
+  m_count  = held;
+  m_cursor = 0;
+
+  auto end = std::min(m_input.size(), m_scanned + window_size);
+  for (; m_scanned + block_size <= end; m_scanned += block_size)
+  {
+    scan_block(m_input.data() + m_scanned, m_scanned);
+  }
+
+  // The tail of the input is padded with whitespace, which never starts anything. A stream always has a whole window
+  // left until it is exhausted, so only its last block is ever padded
+  if (m_scanned < end)
+  {
+    char padded[block_size];
+    std::memset(padded, ' ', block_size);
+    std::memcpy(padded, m_input.data() + m_scanned, end - m_scanned);
+    scan_block(padded, m_scanned);
+    m_scanned = end;
+  }
+}
+
+Void
+JsonStructuralIndexer::refill()
+{
+  // The text before the position held back by `next` has been parsed, or before the scan if there is none
+  auto keep = m_cursor < m_count ? m_indices[m_cursor] : m_scanned;
+  auto size = m_input.size() - keep;
+  std::memmove(m_buffer.data(), m_buffer.data() + keep, size);
+
+  if (m_cursor < m_count)
+  {
+    m_indices[m_cursor] -= keep;
+  }
+  m_scanned -= keep;
+  m_offset  += keep;
+
+  // Only a value longer than the buffer makes it grow
+  if (m_buffer.size() - size < window_size)
+  {
+    m_buffer.resize(std::max(2 * m_buffer.size(), size + window_size));
+  }
+
+  m_stream->read(m_buffer.data() + size, static_cast<std::streamsize>(m_buffer.size() - size));
+  size += static_cast<size_t>(m_stream->gcount());
+  if (!*m_stream)
+  {
+    m_stream = nullptr;
+  }
+
+  m_input = StringView{m_buffer.data(), size};
+}
+
+Void
+JsonStructuralIndexer::scan_block(const char* block, size_t position)
+{
+  auto masks   = classify_block(block);
+  auto escaped = find_escaped(masks.backslash, m_prev_escaped);
+  auto quote   = masks.quote & ~escaped;
+
+  // Set from an opening quote up to the character before the closing one
+  auto in_string   = prefix_xor(quote) ^ m_prev_in_string;
+  m_prev_in_string = static_cast<UInt64>(static_cast<Int64>(in_string) >> 63);
+
+  // Any other value starts at a character which does not follow one of a number or literal, so that `1 2` has two
+  // starts and `"a"b` reports b, both of which the grammar then rejects
+  auto scalar          = ~(masks.op | masks.whitespace);
+  auto nonquote_scalar = scalar & ~quote;
+  auto follows_scalar  = (nonquote_scalar << 1) | m_prev_scalar;
+  m_prev_scalar        = nonquote_scalar >> 63;
+
+  // Everything inside a string and its closing quote is masked out, its opening quote is where the string starts
+  auto string_tail = in_string ^ quote;
+  auto structurals = (masks.op | (scalar & ~follows_scalar)) & ~string_tail;
+
+  // Written four at a time regardless of the count, the slack at the end of the index absorbs the extra writes
+  auto count = static_cast<size_t>(std::popcount(structurals));
+  auto out   = m_indices.data() + m_count;
+  for (size_t i = 0; i < count; i += 4)
+  {
+    out[i]     = position + static_cast<size_t>(std::countr_zero(structurals));
+    structurals &= structurals - 1;
+    out[i + 1] = position + static_cast<size_t>(std::countr_zero(structurals));
+    structurals &= structurals - 1;
+    out[i + 2] = position + static_cast<size_t>(std::countr_zero(structurals));
+    structurals &= structurals - 1;
+    out[i + 3] = position + static_cast<size_t>(std::countr_zero(structurals));
+    structurals &= structurals - 1;
+  }
+  m_count += count;
+}
+
+// First quote, backslash or control character in [begin, end), `end` if there is none
+const char*
+find_string_special(const char* begin, const char* end)
+{
+#ifdef SETSUGEN_JSON_SSE2
+  for (; end - begin >= 16; begin += 16)
+  {
+    auto chunk   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    auto quote   = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    auto escape  = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    auto control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk);
+    auto mask    = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(quote, escape), control));
+    if (mask)
     {
-      continue;
+      return begin + std::countr_zero(static_cast<UInt32>(mask));
     }
+  }
+#endif
 
-    switch (ret)
+  for (; begin != end; ++begin)
+  {
+    if (*begin == '"' || *begin == '\\' || static_cast<unsigned char>(*begin) < 0x20)
     {
-      case JSON_ERROR_BAD_CHAR: throw InvalidSyntaxException("Bad character in JSON stream");
+      return begin;
+    }
+  }
+
+  return end;
+}
+
+static UInt32
+read_hex4(const char* begin, const char* end)
+{
+  UInt32 code = 0;
+  if (end - begin < 4)
+  {
+    throw InvalidSyntaxException("Unterminated unicode escape in JSON string");
+  }
+
+  auto [last, error] = std::from_chars(begin, begin + 4, code, 16);
+  if (error != std::errc{} || last != begin + 4)
+  {
+    throw InvalidSyntaxException("Invalid unicode escape in JSON string");
+  }
+
+  return code;
+}
+
+static Void
+append_utf8(String& out, UInt32 code)
+{
+  if (code < 0x80)
+  {
+    out.push_back(static_cast<char>(code));
+  }
+  else if (code < 0x800)
+  {
+    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  }
+  else if (code < 0x10000)
+  {
+    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  }
+  else
+  {
+    out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+  }
+}
 
-      case JSON_ERROR_NESTING_LIMIT: throw InvalidSyntaxException("Nesting limit reached in JSON stream");
+// Decodes the escape sequence following a backslash into `out` and returns the position after it
+static const char*
+decode_escape(const char* cursor, const char* end, String& out)
+{
+  if (cursor == end)
+  {
+    throw InvalidSyntaxException("Unterminated string in JSON document");
+  }
 
-      case JSON_ERROR_NO_MEMORY: throw OutOfMemoryException("Out of memory while parsing JSON stream");
+  switch (*cursor)
+  {
+    case '"': out.push_back('"'); return cursor + 1;
+    case '\\': out.push_back('\\'); return cursor + 1;
+    case '/': out.push_back('/'); return cursor + 1;
+    case 'b': out.push_back('\b'); return cursor + 1;
+    case 'f': out.push_back('\f'); return cursor + 1;
+    case 'n': out.push_back('\n'); return cursor + 1;
+    case 'r': out.push_back('\r'); return cursor + 1;
+    case 't': out.push_back('\t'); return cursor + 1;
+    case 'u': break;
+    default: throw InvalidSyntaxException("Invalid escape sequence \\{} in JSON string", {String(1, *cursor)});
+  }
 
-      case JSON_ERROR_COMMENT_NOT_ALLOWED: throw InvalidSyntaxException("Comments are not allowed in JSON stream");
+  auto code = read_hex4(cursor + 1, end);
+  cursor += 5;
 
-      case JSON_ERROR_DATA_LIMIT: throw OutOfMemoryException("Data limit reached in JSON stream");
+  if (code >= 0xD800 && code < 0xDC00)
+  {
+    if (end - cursor < 6 || cursor[0] != '\\' || cursor[1] != 'u')
+    {
+      throw InvalidSyntaxException("Unpaired surrogate in JSON string");
+    }
 
-      default: throw InvalidSyntaxException("Unknown error while parsing JSON stream");
+    auto low = read_hex4(cursor + 2, end);
+    if (low < 0xDC00 || low >= 0xE000)
+    {
+      throw InvalidSyntaxException("Unpaired surrogate in JSON string");
     }
+
+    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    cursor += 6;
+  }
+  else if (code >= 0xDC00 && code < 0xE000)
+  {
+    throw InvalidSyntaxException("Unpaired surrogate in JSON string");
   }
+
+  append_utf8(out, code);
+  return cursor;
 }
 
-Int32
-JsonParser::json_event_callback(Void* userdata, Int32 type, const char* data, uint32_t len)
+// A number as the JSON grammar spells it, with its digits accumulated on the way
+struct JsonNumber
+{
+  size_t length   = 0; // Zero when the text is not a number
+  UInt64 mantissa = 0; // All the digits, only exact while there are at most 19 of them
+  Int32  digits   = 0;
+  Int32  exponent = 0; // Power of ten applied to the mantissa
+  Bool   negative = false;
+  Bool   integral = true;
+};
+
+static Bool
+is_digit(const char* cursor, const char* end)
 {
-  auto parser = static_cast<JsonParser*>(userdata);
+  return cursor != end && *cursor >= '0' && *cursor <= '9';
+}
 
-  switch (type)
+static const char*
+scan_digits(const char* cursor, const char* end, JsonNumber& number)
+{
+  for (; is_digit(cursor, end); ++cursor)
   {
-    case JSON_OBJECT_BEGIN:
+    number.mantissa = number.mantissa * 10 + static_cast<UInt64>(*cursor - '0');
+    ++number.digits;
+  }
+
+  return cursor;
+}
+
+static JsonNumber
+scan_number(const char* begin, const char* end)
+{
+  JsonNumber number;
+  auto       cursor = begin;
+
+  number.negative = cursor != end && *cursor == '-';
+  cursor += number.negative ? 1 : 0;
+
+  if (!is_digit(cursor, end))
+  {
+    return number;
+  }
+  cursor = *cursor == '0' ? scan_digits(cursor, cursor + 1, number) : scan_digits(cursor, end, number);
+
+  if (cursor != end && *cursor == '.')
+  {
+    auto fraction = ++cursor;
+    if (!is_digit(cursor, end))
     {
-      parser->handle_new_object();
+      return number;
     }
-    break;
-    case JSON_ARRAY_BEGIN:
+
+    cursor = scan_digits(cursor, end, number);
+    number.exponent -= static_cast<Int32>(cursor - fraction);
+    number.integral = false;
+  }
+
+  if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+  {
+    ++cursor;
+    auto negative = cursor != end && *cursor == '-';
+    cursor += cursor != end && (*cursor == '+' || *cursor == '-') ? 1 : 0;
+    if (!is_digit(cursor, end))
     {
-      parser->handle_new_array();
+      return number;
     }
-    break;
-    case JSON_OBJECT_END:
+
+    // Anything past the range of a double is as good as any larger exponent
+    Int32 exponent = 0;
+    for (; is_digit(cursor, end); ++cursor)
     {
-      parser->handle_end_object();
+      exponent = std::min(exponent * 10 + (*cursor - '0'), 100000);
     }
-    break;
-    case JSON_ARRAY_END:
+
+    number.exponent += negative ? -exponent : exponent;
+    number.integral = false;
+  }
+
+  number.length = static_cast<size_t>(cursor - begin);
+  return number;
+}
+
+// Whether a number out of the range of a double is below one, the leading zeros of its digits not adding to its size
+static Bool
+is_underflow(const char* begin, const JsonNumber& number)
+{
+  Int32 zeros = 0;
+  for (auto cursor = begin + (number.negative ? 1 : 0); *cursor == '0' || *cursor == '.'; ++cursor)
+  {
+    zeros += *cursor == '0' ? 1 : 0;
+  }
+
+  return number.digits - zeros + number.exponent <= 0;
+}
+
+// Clinger's fast path: a mantissa below 2^53 and a power of ten up to 10^22 are both exact doubles, so their product or
+// quotient is correctly rounded
+static Bool
+exact_double(const JsonNumber& number, Float64& value)
+{
+  static constexpr Float64 powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  if (number.digits > 15 || number.exponent < -22 || number.exponent > 22)
+  {
+    return false;
+  }
+
+  value = static_cast<Float64>(number.mantissa);
+  value = number.exponent < 0 ? value / powers[-number.exponent] : value * powers[number.exponent];
+  value = number.negative ? -value : value;
+  return true;
+}
+
+template<typename Visitor>
+JsonEventParser<Visitor>::JsonEventParser(Visitor& visitor)
+  : m_visitor(visitor),
+    m_offset(0)
+{}
+
+template<typename Visitor>
+Void
+JsonEventParser<Visitor>::parse(InputStream& stream)
+{
+  JsonStructuralIndexer indexer{stream};
+  parse(indexer);
+}
+
+template<typename Visitor>
+Void
+JsonEventParser<Visitor>::parse(StringView input)
+{
+  JsonStructuralIndexer indexer{input};
+  parse(indexer);
+}
+
+template<typename Visitor>
+Void
+JsonEventParser<Visitor>::parse(JsonStructuralIndexer& indexer)
+{
+  m_stack.clear();
+
+  auto position = next(indexer);
+
+  while (true)
+  {
+    if (position == JsonStructuralIndexer::npos)
     {
-      parser->handle_end_array();
+      unexpected(position, "a value");
     }
-    break;
-    case JSON_KEY:
+
+    auto c = m_input[position];
+    if (c == '{' || c == '[')
     {
-      parser->handle_key(data, len);
+      auto object = c == '{';
+      auto close  = object ? '}' : ']';
+      object ? m_visitor.on_object_begin() : m_visitor.on_array_begin();
+
+      position = next(indexer);
+      if (position == JsonStructuralIndexer::npos || m_input[position] != close)
+      {
+        m_stack.push_back(close);
+        position = object ? read_key(indexer, position) : position;
+        continue;
+      }
+
+      object ? m_visitor.on_object_end() : m_visitor.on_array_end();
     }
-    break;
-    case JSON_STRING:
+    else if (c == '"')
     {
-      parser->handle_new_string(data, len);
+      m_visitor.on_string(read_string(position));
     }
-    break;
-    case JSON_INT:
+    else if (c == 't' || c == 'f' || c == 'n')
     {
-      parser->handle_new_int(data, len);
+      read_literal(position);
     }
-    break;
-    case JSON_FLOAT:
+    else
     {
-      parser->handle_new_float(data, len);
+      read_number(position);
     }
-    break;
-    case JSON_NULL:
+
+    // Close the containers the value was the last of, then move on to the next value
+    while (true)
     {
-      parser->handle_new_null();
+      position = next(indexer);
+      if (m_stack.empty())
+      {
+        if (position != JsonStructuralIndexer::npos)
+        {
+          throw InvalidSyntaxException("Unexpected value after the end of the JSON document at offset {}",
+                                       {m_offset + position});
+        }
+        return;
+      }
+
+      auto object = m_stack.back() == '}';
+      if (position != JsonStructuralIndexer::npos && m_input[position] == ',')
+      {
+        position = next(indexer);
+        position = object ? read_key(indexer, position) : position;
+        break;
+      }
+
+      if (position == JsonStructuralIndexer::npos || m_input[position] != m_stack.back())
+      {
+        unexpected(position, object ? ", or }" : ", or ]");
+      }
+
+      m_stack.pop_back();
+      object ? m_visitor.on_object_end() : m_visitor.on_array_end();
     }
-    break;
-    case JSON_TRUE:
+  }
+}
+
+template<typename Visitor>
+size_t
+JsonEventParser<Visitor>::next(JsonStructuralIndexer& indexer)
+{
+  auto position = indexer.next();
+  m_input       = indexer.input();
+  m_offset      = indexer.offset();
+  return position;
+}
+
+template<typename Visitor>
+size_t
+JsonEventParser<Visitor>::read_key(JsonStructuralIndexer& indexer, size_t position)
+{
+  if (position == JsonStructuralIndexer::npos || m_input[position] != '"')
+  {
+    unexpected(position, "a key");
+  }
+  m_visitor.on_key(read_string(position));
+
+  position = next(indexer);
+  if (position == JsonStructuralIndexer::npos || m_input[position] != ':')
+  {
+    unexpected(position, ":");
+  }
+
+  return next(indexer);
+}
+
+template<typename Visitor>
+StringView
+JsonEventParser<Visitor>::read_string(size_t position)
+{
+  auto begin  = m_input.data() + position + 1;
+  auto end    = m_input.data() + m_input.size();
+  auto cursor = find_string_special(begin, end);
+  if (cursor != end && *cursor == '"')
+  {
+    return {begin, static_cast<size_t>(cursor - begin)};
+  }
+
+  // Only strings with escapes are copied, into a buffer which is reused from one string to the next
+  m_scratch.assign(begin, cursor);
+  while (true)
+  {
+    if (cursor == end)
     {
-      parser->handle_new_bool(true);
+      throw InvalidSyntaxException("Unterminated string in JSON document at offset {}", {m_offset + position});
     }
-    break;
-    case JSON_FALSE:
+
+    if (*cursor == '"')
     {
-      parser->handle_new_bool(false);
+      return m_scratch;
     }
-    break;
-    default:
+
+    if (*cursor != '\\')
     {
-      throw InvalidSyntaxException("Unknown JSON event type");
+      throw InvalidSyntaxException("Unescaped control character in JSON string at offset {}", {m_offset + position});
     }
-    break;
-  }
 
-  return 0;
+    cursor   = decode_escape(cursor + 1, end, m_scratch);
+    auto run = find_string_special(cursor, end);
+    m_scratch.append(cursor, run);
+    cursor = run;
+  }
 }
 
+template<typename Visitor>
 Void
-JsonParser::handle_new_object()
+JsonEventParser<Visitor>::read_number(size_t position)
 {
-  // If current node is the root (no parent)
-  if (m_current == nullptr)
+  auto begin  = m_input.data() + position;
+  auto number = scan_number(begin, m_input.data() + m_input.size());
+  if (number.length == 0)
   {
-    m_data = SerializedData::object({});
-    m_root = {
-      .value = &m_data,
-      .parent = nullptr,
-    };
-    m_current = &m_root;
-    return;
+    unexpected(position, "a value");
   }
+  expect_end(position + number.length);
 
-  // If current node is a child of an object
-  if (m_current->value->get_type() == SerializedType::Object)
+  // Up to 18 digits always fit in 64 bits, longer integers go through from_chars and become floats past 64 bits
+  if (number.integral && number.digits <= 18)
   {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
-
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::object({});
-
-    // Record the new object as the current node
-    m_current->children.push_back({&obj[key], m_current});
-    m_current = &m_current->children.back();
+    auto value = static_cast<Int64>(number.mantissa);
+    m_visitor.on_int(number.negative ? -value : value);
     return;
   }
 
-  // If current node is a child of an array
-  if (m_current->value->get_type() == SerializedType::Array)
+  if (number.integral)
   {
-    auto& arr = m_current->value->get_array();
-    arr.push_back(SerializedData::object({}));
+    Int64 value = 0;
+    auto [last, error] = std::from_chars(begin, begin + number.length, value);
+    if (error == std::errc{})
+    {
+      m_visitor.on_int(value);
+      return;
+    }
+  }
 
-    // Record the new object as the current node
-    m_current->children.push_back({&arr[arr.size() - 1], m_current});
-    m_current = &m_current->children.back();
-    return;
+  Float64 value = 0;
+  if (!exact_double(number, value))
+  {
+    auto [last, error] = std::from_chars(begin, begin + number.length, value);
+    if (error == std::errc::result_out_of_range && is_underflow(begin, number))
+    {
+      value = number.negative ? -0.0 : 0.0;
+    }
+    else if (error != std::errc{})
+    {
+      throw InvalidSyntaxException("Number {} is too large for a 64-bit float in JSON document",
+                                   {String(begin, number.length)});
+    }
   }
 
-  throw InvalidSyntaxException("Unexpected object begin in JSON stream");
+  m_visitor.on_float(value);
 }
 
+template<typename Visitor>
 Void
-JsonParser::handle_end_object()
+JsonEventParser<Visitor>::read_literal(size_t position)
 {
-  m_current = m_current->parent;
+  auto rest = m_input.substr(position);
+  if (rest.starts_with("true"))
+  {
+    expect_end(position + 4);
+    m_visitor.on_bool(true);
+  }
+  else if (rest.starts_with("false"))
+  {
+    expect_end(position + 5);
+    m_visitor.on_bool(false);
+  }
+  else if (rest.starts_with("null"))
+  {
+    expect_end(position + 4);
+    m_visitor.on_null();
+  }
+  else
+  {
+    unexpected(position, "a value");
+  }
 }
 
+template<typename Visitor>
 Void
-JsonParser::handle_new_array()
+JsonEventParser<Visitor>::expect_end(size_t position)
 {
-  // If current node is the root (no parent)
-  if (m_current == nullptr)
+  if (position == m_input.size())
   {
-    m_data = SerializedData::array({});
-    m_root = {
-      .value = &m_data,
-      .parent = nullptr,
-    };
-    m_current = &m_root;
     return;
   }
 
-  // If current node is a child of an object
-  if (m_current->value->get_type() == SerializedType::Object)
+  switch (m_input[position])
   {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
-
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::array({});
-
-    // Record the new array as the current node
-    m_current->children.push_back({&obj[key], m_current});
-    m_current = &m_current->children.back();
-    return;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ']':
+    case '}': return;
+    default: unexpected(position, "a delimiter");
   }
+}
 
-  // If current node is a child of an array
-  if (m_current->parent->value->get_type() == SerializedType::Array)
+template<typename Visitor>
+Void
+JsonEventParser<Visitor>::unexpected(size_t position, const char* expected) const
+{
+  if (position == JsonStructuralIndexer::npos)
   {
-    auto& arr = m_current->parent->value->get_array();
-    arr.push_back(SerializedData::array({}));
+    throw InvalidSyntaxException("Unexpected end of JSON document, expected {}", {String{expected}});
+  }
 
-    // Record the new array as the current node
-    m_current->children.push_back({&arr[arr.size() - 1], m_current});
-    m_current = &m_current->children.back();
-    return;
+  throw InvalidSyntaxException("Unexpected character {} at offset {} of JSON document, expected {}",
+                               {String(1, m_input[position]), m_offset + position, String{expected}});
+}
+
+JsonParser::JsonParser(InputStream& stream, SerializedData& data)
+  : m_stream(&stream),
+    m_data(data)
+{}
+
+JsonParser::JsonParser(StringView input, SerializedData& data)
+  : m_stream(nullptr),
+    m_input(input),
+    m_data(data)
+{}
+
+Void
+JsonParser::parse()
+{
+  m_key.clear();
+  m_stack.clear();
+
+  JsonEventParser<JsonParser> parser{*this};
+  if (m_stream)
+  {
+    parser.parse(*m_stream);
+  }
+  else
+  {
+    parser.parse(m_input);
   }
+}
 
-  throw InvalidSyntaxException("Unexpected array begin in JSON stream");
+Void
+JsonParser::on_object_begin()
+{
+  begin_container(SerializedData::object({}));
 }
 
 Void
-JsonParser::handle_end_array()
+JsonParser::on_object_end()
 {
-  m_current = m_current->parent;
+  end_container();
 }
 
 Void
-JsonParser::handle_key(const char* data, uint32_t len)
+JsonParser::on_array_begin()
 {
-  m_key = String(data, len);
+  begin_container(SerializedData::array({}));
 }
 
 Void
-JsonParser::handle_new_string(const char* data, uint32_t len)
+JsonParser::on_array_end()
 {
-  if (m_current == nullptr)
-  {
-    throw InvalidSyntaxException("Unexpected string in JSON stream");
-  }
+  end_container();
+}
 
-  if (m_current->value->get_type() == SerializedType::Object)
-  {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
+Void
+JsonParser::on_key(StringView key)
+{
+  m_key.assign(key);
+}
 
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::string(String(data, len));
-    return;
-  }
+Void
+JsonParser::on_string(StringView value)
+{
+  add_value(SerializedData::string(String(value)));
+}
 
-  if (m_current->value->get_type() == SerializedType::Array)
-  {
-    auto& arr = m_current->value->get_array();
-    arr.push_back(SerializedData::string(String(data, len)));
-    return;
-  }
+Void
+JsonParser::on_int(Int64 value)
+{
+  add_value(SerializedData::integer(value));
+}
 
-  throw InvalidSyntaxException("Unexpected string in JSON stream");
+Void
+JsonParser::on_float(Float64 value)
+{
+  add_value(SerializedData::floating(value));
 }
 
 Void
-JsonParser::handle_new_int(const char* data, uint32_t len)
+JsonParser::on_bool(Bool value)
 {
-  if (m_current == nullptr)
-  {
-    throw InvalidSyntaxException("Unexpected integer in JSON stream");
-  }
+  add_value(SerializedData::boolean(value));
+}
 
-  if (m_current->value->get_type() == SerializedType::Object)
-  {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
+Void
+JsonParser::on_null()
+{
+  add_value(SerializedData::null());
+}
+
+Void
+JsonParser::begin_container(SerializedData&& container)
+{
+  // The key is only needed again once the container is closed and moved into its parent
+  m_stack.push_back({std::move(container), std::move(m_key)});
+  m_key.clear();
+}
+
+Void
+JsonParser::end_container()
+{
+  auto frame = std::move(m_stack.back());
+  m_stack.pop_back();
+
+  m_key = std::move(frame.key);
+  add_value(std::move(frame.value));
+}
 
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::integer(std::stoi(String(data, len)));
+Void
+JsonParser::add_value(SerializedData&& value)
+{
+  if (m_stack.empty())
+  {
+    m_data = std::move(value);
     return;
   }
 
-  if (m_current->value->get_type() == SerializedType::Array)
+  auto& parent = m_stack.back().value;
+  if (parent.get_type() == SerializedType::Object)
   {
-    auto& arr = m_current->parent->value->get_array();
-    arr.push_back(SerializedData::integer(std::stoi(String(data, len))));
+    parent.get_object().emplace(m_key, std::move(value));
+    m_key.clear();
     return;
   }
 
-  throw InvalidSyntaxException("Unexpected integer in JSON stream");
+  parent.get_array().emplace_back(std::move(value));
 }
 
+JsonDocumentParser::JsonDocumentParser(InputStream& stream, SerializedDocument& document)
+  : m_stream(&stream),
+    m_builder(document)
+{}
+
+JsonDocumentParser::JsonDocumentParser(StringView input, SerializedDocument& document)
+  : m_stream(nullptr),
+    m_input(input),
+    m_builder(document)
+{}
+
 Void
-JsonParser::handle_new_float(const char* data, uint32_t len)
+JsonDocumentParser::parse()
 {
-  if (m_current == nullptr)
+  JsonEventParser<JsonDocumentParser> parser{*this};
+  if (m_stream)
   {
-    throw InvalidSyntaxException("Unexpected Float32 in JSON stream");
+    parser.parse(*m_stream);
   }
-
-  if (m_current->value->get_type() == SerializedType::Object)
+  else
   {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
-
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::floating(std::stof(String(data, len)));
-    return;
+    parser.parse(m_input);
   }
 
-  if (m_current->value->get_type() == SerializedType::Array)
+  m_builder.finish();
+}
+
+Optional<StringView>
+JsonDocumentParser::borrow(StringView value)
+{
+  // Strings without escapes are reported as views into the text, which outlives the parse unless it was read from a
+  // stream into a buffer which is refilled as the parse goes
+  auto begin = m_input.data(), end = m_input.data() + m_input.size();
+  if (m_stream || value.data() < begin || value.data() + value.size() > end)
   {
-    auto& arr = m_current->value->get_array();
-    arr.push_back(SerializedData::floating(std::stof(String(data, len))));
-    return;
+    return std::nullopt;
   }
 
-  throw InvalidSyntaxException("Unexpected Float32 in JSON stream");
+  return value;
 }
 
 Void
-JsonParser::handle_new_bool(Bool b)
+JsonDocumentParser::on_null()
 {
-  if (m_current == nullptr)
-  {
-    throw InvalidSyntaxException("Unexpected boolean in JSON stream");
-  }
+  m_builder.null();
+}
 
-  if (m_current->value->get_type() == SerializedType::Object)
-  {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
+Void
+JsonDocumentParser::on_bool(Bool value)
+{
+  m_builder.boolean(value);
+}
 
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::boolean(b);
-    return;
-  }
+Void
+JsonDocumentParser::on_int(Int64 value)
+{
+  m_builder.integer(value);
+}
+
+Void
+JsonDocumentParser::on_float(Float64 value)
+{
+  m_builder.floating(value);
+}
 
-  if (m_current->value->get_type() == SerializedType::Array)
+Void
+JsonDocumentParser::on_string(StringView value)
+{
+  if (auto slice = borrow(value))
   {
-    auto& arr = m_current->value->get_array();
-    arr.push_back(SerializedData::boolean(b));
+    m_builder.borrowed_string(*slice);
     return;
   }
 
-  throw InvalidSyntaxException("Unexpected boolean in JSON stream");
+  m_builder.string(value);
 }
 
 Void
-JsonParser::handle_new_null()
+JsonDocumentParser::on_key(StringView key)
 {
-  if (m_current == nullptr)
+  if (auto slice = borrow(key))
   {
-    throw InvalidSyntaxException("Unexpected null in JSON stream");
+    m_builder.borrowed_key(*slice);
+    return;
   }
 
-  if (m_current->value->get_type() == SerializedType::Object)
-  {
-    auto key = m_key.value();
-    m_key    = std::nullopt;
+  m_builder.key(key);
+}
 
-    auto& obj = m_current->value->get_object();
-    obj[key]  = SerializedData::null();
-    return;
-  }
+Void
+JsonDocumentParser::on_object_begin()
+{
+  m_builder.begin_object();
+}
 
-  if (m_current->value->get_type() == SerializedType::Array)
-  {
-    auto& arr = m_current->value->get_array();
-    arr.push_back(SerializedData::null());
-    return;
-  }
+Void
+JsonDocumentParser::on_object_end()
+{
+  m_builder.end_object();
+}
 
-  throw InvalidSyntaxException("Unexpected null in JSON stream");
+Void
+JsonDocumentParser::on_array_begin()
+{
+  m_builder.begin_array();
 }
-} // namespace setsugen
 
+Void
+JsonDocumentParser::on_array_end()
+{
+  m_builder.end_array();
+}
+template class JsonEventParser<SerializedVisitor>;
+template class JsonEventParser<JsonParser>;
+template class JsonEventParser<JsonDocumentParser>;
+} // namespace setsugen
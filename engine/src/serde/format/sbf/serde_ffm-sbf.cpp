@@ -0,0 +1,34 @@
+#include "serde_ffm-sbf.h"
+
+namespace setsugen
+{
+
+Sbf::Sbf() noexcept
+  : m_config{}
+{}
+
+Sbf::Sbf(const Configurations& config) noexcept
+  : m_config{config}
+{}
+
+Void
+Sbf::serialize(OutputStream& stream, const SerializedData& data) const
+{
+  emitter::SbfEmitter emitter(stream, data, m_config);
+  emitter.emit();
+}
+
+Void
+Sbf::deserialize(InputStream& stream, SerializedData& data) const
+{
+  String input{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+  deserialize(StringView{input}, data);
+}
+
+Void
+Sbf::deserialize(StringView input, SerializedData& data) const
+{
+  parser::SbfParser parser(input, data);
+  parser.parse();
+}
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <setsugen/exception.h>
+#include <setsugen/serde.h>
+
+namespace setsugen::parser
+{
+enum class SbfTag : UInt8
+{
+  Null,
+  False,
+  True,
+  Integer,
+  Float32,
+  Float64,
+  String,
+  Array,
+  Object,
+  IndexedArray,
+  IndexedObject,
+};
+
+constexpr UInt8  sbf_version         = 1;
+constexpr size_t sbf_header_size     = 4;
+constexpr size_t sbf_index_threshold = 8;
+constexpr size_t sbf_max_depth       = 1024;
+constexpr size_t sbf_max_size_length = 5; // Bytes of the varint of a size up to 32 bits
+
+/**
+ * @brief Little endian 32-bit value at `data`, which the caller has bounds checked.
+ */
+inline UInt32
+load_sbf_fixed32(const char* data)
+{
+  auto bytes = reinterpret_cast<const UInt8*>(data);
+  return static_cast<UInt32>(bytes[0]) | static_cast<UInt32>(bytes[1]) << 8 | static_cast<UInt32>(bytes[2]) << 16 |
+         static_cast<UInt32>(bytes[3]) << 24;
+}
+
+/**
+ * @brief Bounds checked reader over an SBF buffer, reading past its end throws an InvalidFormatException.
+ */
+class SbfCursor
+{
+public:
+  SbfCursor(const char* begin, const char* end)
+    : m_cursor(begin),
+      m_end(end)
+  {}
+
+  const char* position() const
+  {
+    return m_cursor;
+  }
+
+  size_t remaining() const
+  {
+    return static_cast<size_t>(m_end - m_cursor);
+  }
+
+  UInt8 read_byte()
+  {
+    if (m_cursor == m_end)
+    {
+      throw InvalidFormatException("Unexpected end of SBF data");
+    }
+
+    return static_cast<UInt8>(*m_cursor++);
+  }
+
+  UInt64 read_varint()
+  {
+    UInt64 value = 0;
+    for (UInt32 shift = 0; shift < 64; shift += 7)
+    {
+      auto byte = read_byte();
+      value |= static_cast<UInt64>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+      {
+        return value;
+      }
+    }
+
+    throw InvalidFormatException("SBF varint is longer than 64 bits");
+  }
+
+  /**
+   * @brief Varint which has to fit in a size, e.g. a count or a byte size, checked against the bytes left.
+   */
+  size_t read_size()
+  {
+    auto value = read_varint();
+    if (value > remaining())
+    {
+      throw InvalidFormatException("SBF size {} exceeds the {} bytes left", {static_cast<size_t>(value), remaining()});
+    }
+
+    return static_cast<size_t>(value);
+  }
+
+  /**
+   * @brief Varint id of a string of the string table.
+   */
+  UInt32 read_id()
+  {
+    auto value = read_varint();
+    if (value > std::numeric_limits<UInt32>::max())
+    {
+      throw InvalidFormatException("SBF string id is out of range");
+    }
+
+    return static_cast<UInt32>(value);
+  }
+
+  UInt32 read_fixed32()
+  {
+    return load_sbf_fixed32(skip(4));
+  }
+
+  UInt64 read_fixed64()
+  {
+    auto low = load_sbf_fixed32(skip(4));
+    return static_cast<UInt64>(load_sbf_fixed32(skip(4))) << 32 | low;
+  }
+
+  /**
+   * @brief Skip `length` bytes and return where they start.
+   */
+  const char* skip(size_t length)
+  {
+    if (length > remaining())
+    {
+      throw InvalidFormatException("Unexpected end of SBF data");
+    }
+
+    auto start = m_cursor;
+    m_cursor += length;
+    return start;
+  }
+
+private:
+  const char* m_cursor;
+  const char* m_end;
+};
+
+/**
+ * @brief The string table of an SBF buffer, read in place. Strings are bounds checked when they are looked up, not when
+ * the table is opened.
+ */
+class SbfStrings
+{
+public:
+  SbfStrings() noexcept;
+
+  /**
+   * @brief Read the table at the cursor and move the cursor past it.
+   */
+  Void open(SbfCursor& cursor);
+
+  UInt32     size() const noexcept;
+  StringView get(UInt32 id) const;
+
+  /**
+   * @brief Id of `value` found by binary search over the ids in string order, false when it is not in the table.
+   */
+  Bool find(StringView value, UInt32& id) const;
+
+private:
+  const char* m_offsets;
+  const char* m_order;
+  const char* m_blob;
+  size_t      m_blob_size;
+  UInt32      m_count;
+};
+
+/**
+ * @brief Header and string table of an SBF buffer, the root value starts at `root`.
+ */
+struct SbfLayout
+{
+  SbfStrings  strings;
+  const char* root;
+  const char* end;
+};
+
+SbfLayout read_sbf_layout(StringView input);
+
+/**
+ * @brief Decodes an SBF buffer into a SerializedData, validating it on the way.
+ */
+class SbfParser
+{
+public:
+  SbfParser(StringView input, SerializedData& data);
+
+  Void parse();
+
+private:
+  SerializedData read_value(SbfCursor& cursor, size_t depth);
+  SbfCursor      read_container(SbfCursor& cursor, size_t& count, size_t index_entry_size);
+
+  StringView      m_input;
+  SerializedData& m_data;
+  SbfLayout       m_layout;
+};
+}
+
+namespace setsugen::emitter
+{
+/**
+ * @brief Encodes a SerializedData as SBF in a single pass over the tree. Strings are numbered as they are first met,
+ * container sizes are written in placeholders of the largest size varint, which are compacted once the root is written.
+ */
+class SbfEmitter
+{
+public:
+  SbfEmitter(OutputStream& stream, const SerializedData& data, const Sbf::Configurations& conf);
+
+  Void emit();
+
+private:
+  struct Placeholder
+  {
+    size_t position;
+    size_t length;
+  };
+
+  struct IndexEntry
+  {
+    UInt32 key;
+    UInt32 offset;
+  };
+
+  Void   write_value(const SerializedData& data);
+  Void   write_byte(UInt8 value);
+  Void   write_varint(UInt64 value);
+  Void   write_fixed(UInt64 value, size_t width);
+  UInt32 intern(StringView value);
+  size_t open_container(size_t count);
+  Void   close_container(size_t slot, size_t body, size_t saved);
+  UInt32 element_offset(size_t first, size_t saved) const;
+  Void   compact();
+  Void   write_table();
+  char*  reserve(size_t length);
+  Bool   is_indexed(size_t count) const;
+
+  OutputStream&                          m_stream;
+  const SerializedData&                  m_data;
+  const Sbf::Configurations&             m_config;
+  std::unordered_map<StringView, UInt32> m_ids;
+  DArray<UInt32>                         m_offsets; // Offset of every string in m_strings, by id
+  String                                 m_strings;
+  DArray<Placeholder>                    m_placeholders;
+  size_t                                 m_saved; // Bytes given back by the placeholders closed so far
+  DArray<IndexEntry>                     m_entries;
+  DArray<char>                           m_buffer;
+  size_t                                 m_size;
+};
+}
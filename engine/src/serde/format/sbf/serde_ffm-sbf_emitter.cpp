@@ -0,0 +1,342 @@
+#include "serde_ffm-sbf.h"
+
+#include <bit>
+
+namespace setsugen::emitter
+{
+using parser::SbfTag;
+
+constexpr size_t chunk_size = 64 * 1024;
+
+static size_t
+store_varint(char* out, UInt64 value)
+{
+  size_t size = 0;
+  while (value >= 0x80)
+  {
+    out[size++] = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = static_cast<char>(value);
+  return size;
+}
+
+static Void
+store_fixed(char* out, UInt64 value, size_t width)
+{
+  for (size_t i = 0; i < width; ++i)
+  {
+    out[i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+static UInt64
+zigzag(Int64 value)
+{
+  return (static_cast<UInt64>(value) << 1) ^ static_cast<UInt64>(value >> 63);
+}
+
+// Whether the float survives a round trip through 32 bits, NaNs keep their payload in 64
+static Bool
+fits_float32(Float64 value)
+{
+  return static_cast<Float64>(static_cast<Float32>(value)) == value;
+}
+
+static Void
+check_offset(size_t value)
+{
+  if (value > std::numeric_limits<UInt32>::max())
+  {
+    throw InvalidArgumentException("Cannot write {} bytes as a 32-bit SBF offset", {value});
+  }
+}
+
+SbfEmitter::SbfEmitter(OutputStream& stream, const SerializedData& data, const Sbf::Configurations& conf)
+  : m_stream(stream),
+    m_data(data),
+    m_config(conf),
+    m_saved(0),
+    m_buffer(chunk_size),
+    m_size(0)
+{}
+
+Void
+SbfEmitter::emit()
+{
+  write_value(m_data);
+  compact();
+  write_table();
+  m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+}
+
+Void
+SbfEmitter::write_value(const SerializedData& data)
+{
+  switch (data.get_type())
+  {
+    case SerializedType::Null:
+    {
+      write_byte(static_cast<UInt8>(SbfTag::Null));
+    }
+    break;
+
+    case SerializedType::Bool:
+    {
+      write_byte(static_cast<UInt8>(data.get_bool().value() ? SbfTag::True : SbfTag::False));
+    }
+    break;
+
+    case SerializedType::Integer:
+    {
+      write_byte(static_cast<UInt8>(SbfTag::Integer));
+      write_varint(zigzag(data.get_integer().value()));
+    }
+    break;
+
+    case SerializedType::Float:
+    {
+      auto value = data.get_float().value();
+      if (fits_float32(value))
+      {
+        write_byte(static_cast<UInt8>(SbfTag::Float32));
+        write_fixed(std::bit_cast<UInt32>(static_cast<Float32>(value)), 4);
+      }
+      else
+      {
+        write_byte(static_cast<UInt8>(SbfTag::Float64));
+        write_fixed(std::bit_cast<UInt64>(value), 8);
+      }
+    }
+    break;
+
+    case SerializedType::String:
+    {
+      write_byte(static_cast<UInt8>(SbfTag::String));
+      write_varint(intern(data.get_string().view()));
+    }
+    break;
+
+    case SerializedType::Array:
+    {
+      const auto& array   = data.get_array();
+      auto        indexed = is_indexed(array.size());
+      write_byte(static_cast<UInt8>(indexed ? SbfTag::IndexedArray : SbfTag::Array));
+
+      auto slot  = open_container(array.size());
+      auto body  = m_size;
+      auto saved = m_saved;
+      if (indexed)
+      {
+        reserve(4 * array.size());
+        m_size += 4 * array.size();
+      }
+
+      auto first = m_size;
+      for (size_t i = 0; i < array.size(); ++i)
+      {
+        if (indexed)
+        {
+          store_fixed(m_buffer.data() + body + 4 * i, element_offset(first, saved), 4);
+        }
+        write_value(array[i]);
+      }
+
+      close_container(slot, body, saved);
+    }
+    break;
+
+    case SerializedType::Object:
+    {
+      const auto& object  = data.get_object();
+      auto        indexed = is_indexed(object.size());
+      write_byte(static_cast<UInt8>(indexed ? SbfTag::IndexedObject : SbfTag::Object));
+
+      auto slot  = open_container(object.size());
+      auto body  = m_size;
+      auto saved = m_saved;
+      if (indexed)
+      {
+        reserve(8 * object.size());
+        m_size += 8 * object.size();
+      }
+
+      // Entries of nested objects are pushed and popped above the ones of this object while its members are written
+      auto first = m_size;
+      auto base  = m_entries.size();
+      for (const auto& [key, value]: object)
+      {
+        auto id = intern(key);
+        if (indexed)
+        {
+          m_entries.push_back({id, element_offset(first, saved)});
+        }
+        write_varint(id);
+        write_value(value);
+      }
+
+      if (indexed)
+      {
+        std::sort(m_entries.begin() + base, m_entries.end(),
+                  [](const IndexEntry& a, const IndexEntry& b) { return a.key < b.key; });
+        for (size_t i = base; i < m_entries.size(); ++i)
+        {
+          store_fixed(m_buffer.data() + body + 8 * (i - base), m_entries[i].key, 4);
+          store_fixed(m_buffer.data() + body + 8 * (i - base) + 4, m_entries[i].offset, 4);
+        }
+        m_entries.resize(base);
+      }
+
+      close_container(slot, body, saved);
+    }
+    break;
+
+    default:
+    {
+      throw InvalidArgumentException("Invalid data type");
+    }
+  }
+}
+
+Void
+SbfEmitter::write_byte(UInt8 value)
+{
+  *reserve(1) = static_cast<char>(value);
+  ++m_size;
+}
+
+Void
+SbfEmitter::write_varint(UInt64 value)
+{
+  m_size += store_varint(reserve(10), value);
+}
+
+Void
+SbfEmitter::write_fixed(UInt64 value, size_t width)
+{
+  store_fixed(reserve(width), value, width);
+  m_size += width;
+}
+
+UInt32
+SbfEmitter::intern(StringView value)
+{
+  auto [it, added] = m_ids.try_emplace(value, static_cast<UInt32>(m_offsets.size()));
+  if (added)
+  {
+    check_offset(m_strings.size());
+    m_offsets.push_back(static_cast<UInt32>(m_strings.size()));
+
+    char length[10];
+    m_strings.append(length, store_varint(length, value.size()));
+    m_strings.append(value);
+  }
+
+  return it->second;
+}
+
+size_t
+SbfEmitter::open_container(size_t count)
+{
+  write_varint(count);
+
+  auto slot = m_placeholders.size();
+  m_placeholders.push_back({m_size, 0});
+  reserve(parser::sbf_max_size_length);
+  m_size += parser::sbf_max_size_length;
+  return slot;
+}
+
+Void
+SbfEmitter::close_container(size_t slot, size_t body, size_t saved)
+{
+  // The placeholders closed within the body shrink it by what they give back
+  auto size = m_size - body - (m_saved - saved);
+  check_offset(size);
+
+  auto& placeholder  = m_placeholders[slot];
+  placeholder.length = store_varint(m_buffer.data() + placeholder.position, size);
+  m_saved           += parser::sbf_max_size_length - placeholder.length;
+}
+
+UInt32
+SbfEmitter::element_offset(size_t first, size_t saved) const
+{
+  return static_cast<UInt32>(m_size - first - (m_saved - saved));
+}
+
+Void
+SbfEmitter::compact()
+{
+  // Placeholders are in the order they were opened, which is their order in the buffer
+  auto   data = m_buffer.data();
+  size_t to   = 0;
+  size_t from = 0;
+  for (const auto& placeholder: m_placeholders)
+  {
+    auto length = placeholder.position + placeholder.length - from;
+    std::memmove(data + to, data + from, length);
+    to   += length;
+    from  = placeholder.position + parser::sbf_max_size_length;
+  }
+
+  std::memmove(data + to, data + from, m_size - from);
+  m_size = to + m_size - from;
+}
+
+Void
+SbfEmitter::write_table()
+{
+  check_offset(m_strings.size());
+
+  auto string = [&](UInt32 id) {
+    parser::SbfCursor cursor{m_strings.data() + m_offsets[id], m_strings.data() + m_strings.size()};
+    auto              length = cursor.read_size();
+    return StringView{cursor.skip(length), length};
+  };
+
+  // Ids follow the order strings were met in, the table also lists them in string order for lookups
+  DArray<UInt32> order(m_offsets.size());
+  for (UInt32 id = 0; id < order.size(); ++id)
+  {
+    order[id] = id;
+  }
+  std::sort(order.begin(), order.end(), [&](UInt32 a, UInt32 b) { return string(a) < string(b); });
+
+  String header;
+  char   varint[10];
+  header.reserve(parser::sbf_header_size + 20 + 8 * order.size());
+  header.append("SBF", 3);
+  header.push_back(static_cast<char>(parser::sbf_version));
+  header.append(varint, store_varint(varint, order.size()));
+  header.append(varint, store_varint(varint, m_strings.size()));
+
+  auto fixed = header.size();
+  header.resize(fixed + 8 * order.size());
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    store_fixed(header.data() + fixed + 4 * i, m_offsets[i], 4);
+    store_fixed(header.data() + fixed + 4 * (order.size() + i), order[i], 4);
+  }
+
+  m_stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+  m_stream.write(m_strings.data(), static_cast<std::streamsize>(m_strings.size()));
+}
+
+char*
+SbfEmitter::reserve(size_t length)
+{
+  if (m_buffer.size() - m_size < length)
+  {
+    m_buffer.resize(std::max(2 * m_buffer.size(), m_size + length));
+  }
+
+  return m_buffer.data() + m_size;
+}
+
+Bool
+SbfEmitter::is_indexed(size_t count) const
+{
+  return m_config.indexed && count >= parser::sbf_index_threshold;
+}
+}
@@ -0,0 +1,234 @@
+#include "serde_ffm-sbf.h"
+
+#include <bit>
+
+namespace setsugen::parser
+{
+SbfStrings::SbfStrings() noexcept
+  : m_offsets(nullptr),
+    m_order(nullptr),
+    m_blob(nullptr),
+    m_blob_size(0),
+    m_count(0)
+{}
+
+Void
+SbfStrings::open(SbfCursor& cursor)
+{
+  auto count = cursor.read_size();
+  if (count > std::numeric_limits<UInt32>::max())
+  {
+    throw InvalidFormatException("SBF string table has too many strings");
+  }
+
+  m_blob_size = cursor.read_size();
+  m_count     = static_cast<UInt32>(count);
+  m_offsets   = cursor.skip(4 * count);
+  m_order     = cursor.skip(4 * count);
+  m_blob      = cursor.skip(m_blob_size);
+}
+
+UInt32
+SbfStrings::size() const noexcept
+{
+  return m_count;
+}
+
+StringView
+SbfStrings::get(UInt32 id) const
+{
+  if (id >= m_count)
+  {
+    throw InvalidFormatException("SBF string id {} is out of the string table", {static_cast<size_t>(id)});
+  }
+
+  auto offset = load_sbf_fixed32(m_offsets + 4 * static_cast<size_t>(id));
+  if (offset >= m_blob_size)
+  {
+    throw InvalidFormatException("SBF string {} is out of the string table", {static_cast<size_t>(id)});
+  }
+
+  SbfCursor cursor{m_blob + offset, m_blob + m_blob_size};
+  auto      length = cursor.read_size();
+  return {cursor.skip(length), length};
+}
+
+Bool
+SbfStrings::find(StringView value, UInt32& id) const
+{
+  UInt32 low  = 0;
+  UInt32 high = m_count;
+  while (low < high)
+  {
+    auto middle    = low + (high - low) / 2;
+    auto candidate = load_sbf_fixed32(m_order + 4 * static_cast<size_t>(middle));
+    auto string    = get(candidate);
+    if (string < value)
+    {
+      low = middle + 1;
+    }
+    else if (value < string)
+    {
+      high = middle;
+    }
+    else
+    {
+      id = candidate;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+SbfLayout
+read_sbf_layout(StringView input)
+{
+  SbfCursor cursor{input.data(), input.data() + input.size()};
+  if (input.size() < sbf_header_size || std::memcmp(cursor.skip(3), "SBF", 3) != 0)
+  {
+    throw InvalidFormatException("Input is not SBF data");
+  }
+
+  auto version = cursor.read_byte();
+  if (version != sbf_version)
+  {
+    throw InvalidFormatException("Unsupported SBF version {}", {static_cast<size_t>(version)});
+  }
+
+  SbfLayout layout;
+  layout.strings.open(cursor);
+  layout.root = cursor.position();
+  layout.end  = input.data() + input.size();
+  return layout;
+}
+
+SbfParser::SbfParser(StringView input, SerializedData& data)
+  : m_input(input),
+    m_data(data),
+    m_layout{}
+{}
+
+Void
+SbfParser::parse()
+{
+  m_layout = read_sbf_layout(m_input);
+
+  SbfCursor cursor{m_layout.root, m_layout.end};
+  m_data = read_value(cursor, 0);
+
+  if (cursor.remaining() != 0)
+  {
+    throw InvalidFormatException("Unexpected data after the SBF root value");
+  }
+}
+
+SbfCursor
+SbfParser::read_container(SbfCursor& cursor, size_t& count, size_t index_entry_size)
+{
+  count     = cursor.read_size();
+  auto size = cursor.read_size();
+  SbfCursor body{cursor.skip(size), cursor.position()};
+
+  // Every element takes at least a byte, besides its entry in the index
+  if (count > size / (index_entry_size + 1))
+  {
+    throw InvalidFormatException("SBF container of {} bytes cannot hold {} elements", {size, count});
+  }
+
+  body.skip(index_entry_size * count);
+  return body;
+}
+
+SerializedData
+SbfParser::read_value(SbfCursor& cursor, size_t depth)
+{
+  auto tag = cursor.read_byte();
+  switch (static_cast<SbfTag>(tag))
+  {
+    case SbfTag::Null: return SerializedData::null();
+    case SbfTag::False: return SerializedData::boolean(false);
+    case SbfTag::True: return SerializedData::boolean(true);
+
+    case SbfTag::Integer:
+    {
+      auto value = cursor.read_varint();
+      return SerializedData::integer(static_cast<Int64>(value >> 1) ^ -static_cast<Int64>(value & 1));
+    }
+
+    case SbfTag::Float32:
+    {
+      return SerializedData::floating(std::bit_cast<Float32>(cursor.read_fixed32()));
+    }
+
+    case SbfTag::Float64:
+    {
+      return SerializedData::floating(std::bit_cast<Float64>(cursor.read_fixed64()));
+    }
+
+    case SbfTag::String:
+    {
+      return SerializedData::string(String(m_layout.strings.get(cursor.read_id())));
+    }
+
+    case SbfTag::Array:
+    case SbfTag::IndexedArray:
+    {
+      if (depth == sbf_max_depth)
+      {
+        throw InvalidFormatException("SBF data is nested deeper than {} levels", {sbf_max_depth});
+      }
+
+      // The index only serves random access, decoding reads the elements in order
+      size_t count = 0;
+      auto   body  = read_container(cursor, count, static_cast<SbfTag>(tag) == SbfTag::IndexedArray ? 4 : 0);
+
+      DataStorage<SerializedType::Array> elements;
+      elements.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        elements.push_back(read_value(body, depth + 1));
+      }
+
+      if (body.remaining() != 0)
+      {
+        throw InvalidFormatException("SBF container size does not match its elements");
+      }
+
+      return SerializedData(std::move(elements));
+    }
+
+    case SbfTag::Object:
+    case SbfTag::IndexedObject:
+    {
+      if (depth == sbf_max_depth)
+      {
+        throw InvalidFormatException("SBF data is nested deeper than {} levels", {sbf_max_depth});
+      }
+
+      size_t count = 0;
+      auto   body  = read_container(cursor, count, static_cast<SbfTag>(tag) == SbfTag::IndexedObject ? 8 : 0);
+
+      DataStorage<SerializedType::Object> members;
+      members.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        auto key = m_layout.strings.get(body.read_id());
+        members.emplace(key, read_value(body, depth + 1));
+      }
+
+      if (body.remaining() != 0)
+      {
+        throw InvalidFormatException("SBF container size does not match its elements");
+      }
+
+      return SerializedData(std::move(members));
+    }
+
+    default:
+    {
+      throw InvalidFormatException("Unknown SBF tag {}", {static_cast<size_t>(tag)});
+    }
+  }
+}
+}
@@ -0,0 +1,508 @@
+#include "serde_ffm-sbf.h"
+
+#include <bit>
+
+namespace setsugen
+{
+using parser::SbfCursor;
+using parser::SbfStrings;
+using parser::SbfTag;
+
+static const char null_value[] = {static_cast<char>(SbfTag::Null)};
+
+struct SbfContainer
+{
+  const char* index;
+  const char* first;
+  const char* last;
+  size_t      count;
+};
+
+static SbfStrings
+open_strings(const char* table, const char* end)
+{
+  SbfCursor  cursor{table, end};
+  SbfStrings strings;
+  strings.open(cursor);
+  return strings;
+}
+
+static SbfContainer
+read_container(SbfCursor& cursor, size_t index_entry_size)
+{
+  auto count = cursor.read_size();
+  auto size  = cursor.read_size();
+  auto body  = cursor.skip(size);
+  if (count > size / (index_entry_size + 1))
+  {
+    throw InvalidFormatException("SBF container of {} bytes cannot hold {} elements", {size, count});
+  }
+
+  return {body, body + index_entry_size * count, body + size, count};
+}
+
+static Void
+skip_value(SbfCursor& cursor)
+{
+  auto tag = cursor.read_byte();
+  switch (static_cast<SbfTag>(tag))
+  {
+    case SbfTag::Null:
+    case SbfTag::False:
+    case SbfTag::True: break;
+    case SbfTag::Integer: cursor.read_varint(); break;
+    case SbfTag::Float32: cursor.skip(4); break;
+    case SbfTag::Float64: cursor.skip(8); break;
+    case SbfTag::String: cursor.read_id(); break;
+
+    case SbfTag::Array:
+    case SbfTag::Object:
+    case SbfTag::IndexedArray:
+    case SbfTag::IndexedObject:
+    {
+      cursor.read_size();
+      cursor.skip(cursor.read_size());
+    }
+    break;
+
+    default:
+    {
+      throw InvalidFormatException("Unknown SBF tag {}", {static_cast<size_t>(tag)});
+    }
+  }
+}
+
+// Element at `offset` from the first one, as read from an offset index
+static const char*
+indexed_element(const char* first, const char* last, UInt32 offset)
+{
+  if (offset >= static_cast<size_t>(last - first))
+  {
+    throw InvalidFormatException("SBF index offset {} is out of its container", {static_cast<size_t>(offset)});
+  }
+
+  return first + offset;
+}
+
+static SerializedData
+to_serialized(const SbfView& view, size_t depth)
+{
+  if (depth == parser::sbf_max_depth)
+  {
+    throw InvalidFormatException("SBF data is nested deeper than {} levels", {parser::sbf_max_depth});
+  }
+
+  switch (view.get_type())
+  {
+    case SerializedType::Bool: return SerializedData::boolean(view.get_bool());
+    case SerializedType::Integer: return SerializedData::integer(view.get_integer());
+    case SerializedType::Float: return SerializedData::floating(view.get_float());
+    case SerializedType::String: return SerializedData::string(String{view.get_string()});
+    case SerializedType::Array:
+    {
+      auto  array    = view.get_array();
+      auto  result   = SerializedData::array({});
+      auto& elements = result.get_array();
+      elements.reserve(array.size());
+      for (auto element: array)
+      {
+        elements.push_back(to_serialized(element, depth + 1));
+      }
+
+      return result;
+    }
+    case SerializedType::Object:
+    {
+      auto  object  = view.get_object();
+      auto  result  = SerializedData::object({});
+      auto& members = result.get_object();
+      members.reserve(object.size());
+      for (auto [key, value]: object)
+      {
+        members[key] = to_serialized(value, depth + 1);
+      }
+
+      return result;
+    }
+    default: return SerializedData::null();
+  }
+}
+
+SbfView::SbfView() noexcept : m_table{nullptr}, m_end{null_value + 1}, m_value{null_value}
+{}
+
+SbfView::SbfView(StringView buffer)
+{
+  auto layout = parser::read_sbf_layout(buffer);
+  m_table     = buffer.data() + parser::sbf_header_size;
+  m_end       = layout.end;
+  m_value     = layout.root;
+}
+
+SbfView::SbfView(const char* table, const char* end, const char* value) noexcept
+    : m_table{table}, m_end{end}, m_value{value}
+{}
+
+SerializedType
+SbfView::get_type() const
+{
+  auto tag = get_tag();
+  switch (static_cast<SbfTag>(tag))
+  {
+    case SbfTag::Null: return SerializedType::Null;
+    case SbfTag::False:
+    case SbfTag::True: return SerializedType::Bool;
+    case SbfTag::Integer: return SerializedType::Integer;
+    case SbfTag::Float32:
+    case SbfTag::Float64: return SerializedType::Float;
+    case SbfTag::String: return SerializedType::String;
+    case SbfTag::Array:
+    case SbfTag::IndexedArray: return SerializedType::Array;
+    case SbfTag::Object:
+    case SbfTag::IndexedObject: return SerializedType::Object;
+    default:
+    {
+      throw InvalidFormatException("Unknown SBF tag {}", {static_cast<size_t>(tag)});
+    }
+  }
+}
+
+size_t
+SbfView::size() const
+{
+  auto type = get_type();
+  if (type != SerializedType::Array && type != SerializedType::Object)
+  {
+    throw InvalidOperationException("Cannot get size of non-iterable type: {}", {type});
+  }
+
+  SbfCursor cursor{m_value + 1, m_end};
+  return cursor.read_size();
+}
+
+Bool
+SbfView::get_bool() const
+{
+  auto tag = static_cast<SbfTag>(get_tag());
+  if (tag != SbfTag::False && tag != SbfTag::True)
+  {
+    throw InvalidOperationException("Cannot get Bool from non-Bool");
+  }
+
+  return tag == SbfTag::True;
+}
+
+Int64
+SbfView::get_integer() const
+{
+  if (static_cast<SbfTag>(get_tag()) != SbfTag::Integer)
+  {
+    throw InvalidOperationException("Cannot get integer from non-integer");
+  }
+
+  SbfCursor cursor{m_value + 1, m_end};
+  auto      value = cursor.read_varint();
+  return static_cast<Int64>(value >> 1) ^ -static_cast<Int64>(value & 1);
+}
+
+Float64
+SbfView::get_float() const
+{
+  SbfCursor cursor{m_value + 1, m_end};
+  switch (static_cast<SbfTag>(get_tag()))
+  {
+    case SbfTag::Float32: return std::bit_cast<Float32>(cursor.read_fixed32());
+    case SbfTag::Float64: return std::bit_cast<Float64>(cursor.read_fixed64());
+    default:
+    {
+      throw InvalidOperationException("Cannot get Float32 from non-Float32");
+    }
+  }
+}
+
+StringView
+SbfView::get_string() const
+{
+  if (static_cast<SbfTag>(get_tag()) != SbfTag::String)
+  {
+    throw InvalidOperationException("Cannot get string from non-string");
+  }
+
+  SbfCursor cursor{m_value + 1, m_end};
+  return open_strings(m_table, m_end).get(cursor.read_id());
+}
+
+SbfArrayView
+SbfView::get_array() const
+{
+  return SbfArrayView{m_table, m_end, m_value};
+}
+
+SbfObjectView
+SbfView::get_object() const
+{
+  return SbfObjectView{m_table, m_end, m_value};
+}
+
+SbfView
+SbfView::operator[](size_t index) const
+{
+  return get_array()[index];
+}
+
+SbfView
+SbfView::operator[](StringView key) const
+{
+  return get_object()[key];
+}
+
+SbfView::operator Bool() const
+{
+  return static_cast<SbfTag>(get_tag()) != SbfTag::Null;
+}
+
+SerializedData
+SbfView::to_serialized() const
+{
+  return setsugen::to_serialized(*this, 0);
+}
+
+UInt8
+SbfView::get_tag() const
+{
+  SbfCursor cursor{m_value, m_end};
+  return cursor.read_byte();
+}
+
+SbfArrayView::Iter::Iter(const char* table, const char* end, const char* position, const char* last) noexcept
+    : m_table{table}, m_end{end}, m_position{position}, m_last{last}
+{}
+
+SbfView
+SbfArrayView::Iter::operator*() const noexcept
+{
+  return SbfView{m_table, m_end, m_position};
+}
+
+SbfArrayView::Iter&
+SbfArrayView::Iter::operator++()
+{
+  SbfCursor cursor{m_position, m_last};
+  skip_value(cursor);
+  m_position = cursor.position();
+  return *this;
+}
+
+SbfArrayView::Iter
+SbfArrayView::Iter::operator++(Int32)
+{
+  auto copy = *this;
+  ++*this;
+  return copy;
+}
+
+SbfArrayView::SbfArrayView(const char* table, const char* end, const char* value) : m_table{table}, m_end{end}
+{
+  SbfCursor cursor{value, end};
+  auto      tag = static_cast<SbfTag>(cursor.read_byte());
+  if (tag != SbfTag::Array && tag != SbfTag::IndexedArray)
+  {
+    throw InvalidOperationException("Cannot get array from non-array");
+  }
+
+  auto container = read_container(cursor, tag == SbfTag::IndexedArray ? 4 : 0);
+  m_index        = container.index;
+  m_first        = container.first;
+  m_last         = container.last;
+  m_count        = container.count;
+}
+
+size_t
+SbfArrayView::size() const noexcept
+{
+  return m_count;
+}
+
+Bool
+SbfArrayView::empty() const noexcept
+{
+  return m_count == 0;
+}
+
+SbfArrayView::Iter
+SbfArrayView::begin() const noexcept
+{
+  return Iter{m_table, m_end, m_first, m_last};
+}
+
+SbfArrayView::Iter
+SbfArrayView::end() const noexcept
+{
+  return Iter{m_table, m_end, m_last, m_last};
+}
+
+SbfView
+SbfArrayView::operator[](size_t index) const
+{
+  if (index >= m_count)
+  {
+    throw OutOfBoundsException("Index {} is out of bounds for an array of size {}", {index, m_count});
+  }
+
+  if (m_index != m_first)
+  {
+    auto offset = parser::load_sbf_fixed32(m_index + 4 * index);
+    return SbfView{m_table, m_end, indexed_element(m_first, m_last, offset)};
+  }
+
+  SbfCursor cursor{m_first, m_last};
+  for (size_t i = 0; i < index; ++i)
+  {
+    skip_value(cursor);
+  }
+
+  return SbfView{m_table, m_end, cursor.position()};
+}
+
+SbfObjectView::Iter::Iter(const char* table, const char* end, const char* position, const char* last) noexcept
+    : m_table{table}, m_end{end}, m_position{position}, m_last{last}
+{}
+
+SbfMember
+SbfObjectView::Iter::operator*() const
+{
+  SbfCursor cursor{m_position, m_last};
+  auto      id = cursor.read_id();
+  return {open_strings(m_table, m_end).get(id), SbfView{m_table, m_end, cursor.position()}};
+}
+
+SbfObjectView::Iter&
+SbfObjectView::Iter::operator++()
+{
+  SbfCursor cursor{m_position, m_last};
+  cursor.read_id();
+  skip_value(cursor);
+  m_position = cursor.position();
+  return *this;
+}
+
+SbfObjectView::Iter
+SbfObjectView::Iter::operator++(Int32)
+{
+  auto copy = *this;
+  ++*this;
+  return copy;
+}
+
+SbfObjectView::SbfObjectView(const char* table, const char* end, const char* value) : m_table{table}, m_end{end}
+{
+  SbfCursor cursor{value, end};
+  auto      tag = static_cast<SbfTag>(cursor.read_byte());
+  if (tag != SbfTag::Object && tag != SbfTag::IndexedObject)
+  {
+    throw InvalidOperationException("Cannot get object from non-object");
+  }
+
+  auto container = read_container(cursor, tag == SbfTag::IndexedObject ? 8 : 0);
+  m_index        = container.index;
+  m_first        = container.first;
+  m_last         = container.last;
+  m_count        = container.count;
+}
+
+size_t
+SbfObjectView::size() const noexcept
+{
+  return m_count;
+}
+
+Bool
+SbfObjectView::empty() const noexcept
+{
+  return m_count == 0;
+}
+
+SbfObjectView::Iter
+SbfObjectView::begin() const noexcept
+{
+  return Iter{m_table, m_end, m_first, m_last};
+}
+
+SbfObjectView::Iter
+SbfObjectView::end() const noexcept
+{
+  return Iter{m_table, m_end, m_last, m_last};
+}
+
+Bool
+SbfObjectView::has_key(StringView key) const
+{
+  return find(key).has_value();
+}
+
+Optional<SbfView>
+SbfObjectView::find(StringView key) const
+{
+  // A key which is not in the string table is in no object, the others are compared by id from here on
+  UInt32 id = 0;
+  if (!open_strings(m_table, m_end).find(key, id))
+  {
+    return std::nullopt;
+  }
+
+  if (m_index != m_first)
+  {
+    size_t low  = 0;
+    size_t high = m_count;
+    while (low < high)
+    {
+      auto middle = low + (high - low) / 2;
+      auto entry  = parser::load_sbf_fixed32(m_index + 8 * middle);
+      if (entry < id)
+      {
+        low = middle + 1;
+      }
+      else if (id < entry)
+      {
+        high = middle;
+      }
+      else
+      {
+        auto      offset = parser::load_sbf_fixed32(m_index + 8 * middle + 4);
+        SbfCursor cursor{indexed_element(m_first, m_last, offset), m_last};
+        if (cursor.read_id() != id)
+        {
+          throw InvalidFormatException("SBF index entry does not point at its key");
+        }
+
+        return SbfView{m_table, m_end, cursor.position()};
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  SbfCursor cursor{m_first, m_last};
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    if (cursor.read_id() == id)
+    {
+      return SbfView{m_table, m_end, cursor.position()};
+    }
+    skip_value(cursor);
+  }
+
+  return std::nullopt;
+}
+
+SbfView
+SbfObjectView::operator[](StringView key) const
+{
+  if (auto value = find(key))
+  {
+    return *value;
+  }
+
+  throw OutOfBoundsException("Key {} does not exist in the object", {String{key}});
+}
+}
@@ -0,0 +1,171 @@
+#include <setsugen/exception.h>
+#include <setsugen/serde.h>
+
+#include <utility>
+
+#ifdef SETSUGENE_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace setsugen
+{
+
+#ifdef SETSUGENE_WINDOWS
+MappedFile::MappedFile(const String& path)
+  : m_data(nullptr),
+    m_size(0)
+{
+  auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw FileNotFoundException("Cannot open file {}", {path});
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    throw FileNotFoundException("Cannot read the size of file {}", {path});
+  }
+
+  m_size = static_cast<size_t>(size.QuadPart);
+  if (m_size == 0)
+  {
+    CloseHandle(file);
+    return;
+  }
+
+  // The view keeps the mapping alive, neither handle is needed once it exists
+  auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+  {
+    throw FileNotFoundException("Cannot map file {}", {path});
+  }
+
+  m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  CloseHandle(mapping);
+  if (!m_data)
+  {
+    throw FileNotFoundException("Cannot map file {}", {path});
+  }
+}
+
+Void
+MappedFile::unmap() noexcept
+{
+  if (m_data)
+  {
+    UnmapViewOfFile(m_data);
+  }
+}
+#else
+MappedFile::MappedFile(const String& path)
+  : m_data(nullptr),
+    m_size(0)
+{
+  auto file = open(path.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    throw FileNotFoundException("Cannot open file {}", {path});
+  }
+
+  struct stat status;
+  if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode))
+  {
+    close(file);
+    throw FileNotFoundException("Cannot open file {}, it is not a regular file", {path});
+  }
+
+  m_size = static_cast<size_t>(status.st_size);
+  if (m_size == 0)
+  {
+    close(file);
+    return;
+  }
+
+  // The mapping keeps the file referenced, the descriptor is not needed once it exists
+  auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if (data == MAP_FAILED)
+  {
+    throw FileNotFoundException("Cannot map file {}", {path});
+  }
+
+  // Parsers read front to back, so read ahead aggressively and drop the pages behind
+  madvise(data, m_size, MADV_SEQUENTIAL);
+  m_data = static_cast<const char*>(data);
+}
+
+Void
+MappedFile::unmap() noexcept
+{
+  if (m_data)
+  {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+}
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0))
+{}
+
+MappedFile::~MappedFile() noexcept
+{
+  unmap();
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    unmap();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+  }
+
+  return *this;
+}
+
+const char*
+MappedFile::data() const noexcept
+{
+  return m_data;
+}
+
+size_t
+MappedFile::size() const noexcept
+{
+  return m_size;
+}
+
+StringView
+MappedFile::view() const noexcept
+{
+  return {m_data, m_size};
+}
+
+SpanInputStream::SpanInputStream(StringView input)
+  : InputStream(nullptr),
+    m_buffer(input)
+{
+  rdbuf(&m_buffer);
+}
+
+SpanInputStream::Buffer::Buffer(StringView input)
+{
+  // The get area is never written through, the stream buffer interface only takes mutable pointers
+  auto begin = const_cast<char*>(input.data());
+  setg(begin, begin, begin + input.size());
+}
+
+} // namespace setsugen
@@ -4,13 +4,27 @@
 
 namespace setsugen
 {
-SerializedData::
-SerializedData() noexcept
+
+// The container of `shared`, cloned first if a copy shares it
+template<typename T>
+static T&
+unshare(Shared<T>& shared)
 {
-  m_actual = DataStorage<SerializedType::Null>();
+  if (shared.use_count() != 1)
+  {
+    shared = std::make_shared<T>(*shared);
+  }
+
+  return *shared;
 }
 
 
+SerializedData::
+SerializedData() noexcept
+    : m_actual(DataStorage<SerializedType::Null>())
+{}
+
+
 SerializedData::
 SerializedData(const SerializedData& other) noexcept
     : m_actual(other.m_actual)
@@ -19,8 +33,11 @@ SerializedData(const SerializedData& other) noexcept
 
 SerializedData::
 SerializedData(SerializedData&& other) noexcept
-    : m_actual(std::move(other.m_actual))
-{}
+{
+  other.detach();
+  m_actual = std::exchange(other.m_actual, DataStorage<SerializedType::Null>());
+  other.invalidate_parent();
+}
 
 SerializedData::
 SerializedData(Initializer<SerializedData> value, SerializedType type)
@@ -31,43 +48,101 @@ SerializedData(Initializer<SerializedData> value, SerializedType type)
     {
       if (check_object_initializer(value))
       {
-        m_actual = DataStorage<SerializedType::Object>(value);
+        m_actual = std::make_shared<DataStorage<SerializedType::Object>>(value);
       }
       else
       {
-        m_actual = DataStorage<SerializedType::Array>(value);
+        m_actual = std::make_shared<DataStorage<SerializedType::Array>>(value);
       }
     }
     break;
     case SerializedType::Array:
     {
-      m_actual = DataStorage<SerializedType::Array>(value);
+      m_actual = std::make_shared<DataStorage<SerializedType::Array>>(value);
     }
     break;
     case SerializedType::Object:
     {
       if (check_object_initializer(value))
       {
-        m_actual = DataStorage<SerializedType::Object>(value);
+        m_actual = std::make_shared<DataStorage<SerializedType::Object>>(value);
       }
       else
       {
         throw InvalidOperationException("Invalid initializer list for object");
       }
     }
+    break;
 
     default: throw InvalidArgumentException("Invalid type for initializer list: {}", {type});
   }
 }
 
 
-SerializedData::~SerializedData() noexcept = default;
+SerializedData::~SerializedData() noexcept
+{
+  detach();
+}
+
+
+const SerializedHash*
+SerializedData::get_container_hash() const noexcept
+{
+  switch (m_actual.index())
+  {
+    case 2: return &std::get<SharedArray>(m_actual)->m_hash;
+    case 5: return &std::get<SharedObject>(m_actual)->m_hash;
+    default: return nullptr;
+  }
+}
+
+
+Void
+SerializedData::attach() const noexcept
+{
+  auto hash = get_container_hash();
+  if (hash && m_parent)
+  {
+    hash->set_parent(m_parent);
+  }
+}
+
+
+Void
+SerializedData::detach() const noexcept
+{
+  auto hash = get_container_hash();
+  if (hash && m_parent)
+  {
+    hash->detach(m_parent);
+  }
+}
+
+
+Void
+SerializedData::invalidate_parent() const noexcept
+{
+  if (m_parent)
+  {
+    m_parent->invalidate();
+  }
+}
+
+
+Void
+SerializedData::assign(SerializedVariant&& value) noexcept
+{
+  detach();
+  m_actual = std::move(value);
+  attach();
+  invalidate_parent();
+}
 
 template<>
 SerializedData&
 SerializedData::operator=(std::nullptr_t value) noexcept
 {
-  m_actual = DataStorage<SerializedType::Null>();
+  assign(DataStorage<SerializedType::Null>());
   return *this;
 }
 
@@ -75,7 +150,7 @@ template<>
 SerializedData&
 SerializedData::operator=(Bool value) noexcept
 {
-  m_actual = DataStorage(value);
+  assign(DataStorage(value));
   return *this;
 }
 
@@ -83,7 +158,7 @@ template<>
 SerializedData&
 SerializedData::operator=(int64_t value) noexcept
 {
-  m_actual = DataStorage(value);
+  assign(DataStorage(value));
   return *this;
 }
 
@@ -140,7 +215,7 @@ template<>
 SerializedData&
 SerializedData::operator=(Float64 value) noexcept
 {
-  m_actual = DataStorage(value);
+  assign(DataStorage(value));
   return *this;
 }
 
@@ -155,7 +230,7 @@ template<>
 SerializedData&
 SerializedData::operator=(String value) noexcept
 {
-  m_actual = DataStorage(std::move(value));
+  assign(DataStorage(std::move(value)));
   return *this;
 }
 
@@ -163,7 +238,7 @@ template<>
 SerializedData&
 SerializedData::operator=(const char* value) noexcept
 {
-  m_actual = DataStorage{value};
+  assign(DataStorage{value});
   return *this;
 }
 
@@ -171,7 +246,7 @@ template<>
 SerializedData&
 SerializedData::operator=(char*& value) noexcept
 {
-  m_actual = DataStorage{value};
+  assign(DataStorage{value});
   return *this;
 }
 
@@ -190,12 +265,12 @@ SerializedData::size() const
   {
     case SerializedType::Array:
     {
-      return std::get<DataStorage<SerializedType::Array>>(m_actual).size();
+      return std::get<SharedArray>(m_actual)->size();
     }
 
     case SerializedType::Object:
     {
-      return std::get<DataStorage<SerializedType::Object>>(m_actual).size();
+      return std::get<SharedObject>(m_actual)->size();
     }
 
     default:
@@ -215,7 +290,7 @@ SerializedData::operator Bool() const noexcept
 SerializedData&
 SerializedData::operator=(const SerializedData& other) noexcept
 {
-  m_actual = other.m_actual;
+  assign(SerializedVariant(other.m_actual));
   return *this;
 }
 
@@ -223,8 +298,10 @@ SerializedData::operator=(const SerializedData& other) noexcept
 SerializedData&
 SerializedData::operator=(SerializedData&& other) noexcept
 {
-  m_actual = std::move(other.m_actual);
-  other    = nullptr;
+  other.detach();
+  auto value = std::exchange(other.m_actual, DataStorage<SerializedType::Null>());
+  other.invalidate_parent();
+  assign(std::move(value));
   return *this;
 }
 
@@ -236,11 +313,11 @@ SerializedData::operator=(Initializer<SerializedData> list)
 
   if (is_object)
   {
-    m_actual = DataStorage<SerializedType::Object>(list);
+    assign(std::make_shared<DataStorage<SerializedType::Object>>(list));
   }
   else
   {
-    m_actual = DataStorage<SerializedType::Array>(list);
+    assign(std::make_shared<DataStorage<SerializedType::Array>>(list));
   }
 
   return *this;
@@ -252,7 +329,7 @@ SerializedData::get_object() const
 {
   if (m_actual.index() == 5)
   {
-    return std::get<DataStorage<SerializedType::Object>>(m_actual);
+    return *std::get<SharedObject>(m_actual);
   }
 
   throw InvalidOperationException("Cannot get object from non-object");
@@ -264,7 +341,11 @@ SerializedData::get_object()
 {
   if (m_actual.index() == 5)
   {
-    return std::get<DataStorage<SerializedType::Object>>(m_actual);
+    detach();
+    auto& object = unshare(std::get<SharedObject>(m_actual));
+    object.m_hash.set_parent(m_parent);
+    object.m_hash.invalidate();
+    return object;
   }
 
   throw InvalidOperationException("Cannot get object from non-object");
@@ -324,7 +405,7 @@ SerializedData::get_array() const
 {
   if (this->get_type() == SerializedType::Array)
   {
-    return std::get<DataStorage<SerializedType::Array>>(m_actual);
+    return *std::get<SharedArray>(m_actual);
   }
 
   throw InvalidOperationException("Cannot get array from non-array");
@@ -336,7 +417,11 @@ SerializedData::get_array()
 {
   if (this->get_type() == SerializedType::Array)
   {
-    return std::get<DataStorage<SerializedType::Array>>(m_actual);
+    detach();
+    auto& array = unshare(std::get<SharedArray>(m_actual));
+    array.m_hash.set_parent(m_parent);
+    array.m_hash.invalidate();
+    return array;
   }
 
   throw InvalidOperationException("Cannot get array from non-array");
@@ -346,41 +431,49 @@ SerializedData::get_array()
 size_t
 SerializedData::hash() const
 {
+  // Every type is seeded differently so that, e.g., false and 0 do not collide. Integers and floats compare equal by
+  // value and therefore share the Float seed and are hashed as a Float64
+  auto seed = [](SerializedType type) { return SerializedHash::mix(static_cast<UInt64>(type) + 1); };
+
   switch (this->get_type())
   {
     case SerializedType::Integer:
     {
-      return std::hash<int64_t>{}(std::get<DataStorage<SerializedType::Integer>>(m_actual).value());
+      auto value = static_cast<Float64>(std::get<DataStorage<SerializedType::Integer>>(m_actual).value());
+      return SerializedHash::mix(seed(SerializedType::Float) + std::hash<Float64>{}(value));
     }
 
     case SerializedType::Float:
     {
-      return std::hash<Float64>{}(std::get<DataStorage<SerializedType::Float>>(m_actual).value());
+      auto value = std::get<DataStorage<SerializedType::Float>>(m_actual).value();
+      return SerializedHash::mix(seed(SerializedType::Float) + std::hash<Float64>{}(value));
     }
 
     case SerializedType::String:
     {
-      return std::hash<String>{}(std::get<DataStorage<SerializedType::String>>(m_actual).value());
+      auto value = std::get<DataStorage<SerializedType::String>>(m_actual).view();
+      return SerializedHash::mix(seed(SerializedType::String) + std::hash<StringView>{}(value));
     }
 
     case SerializedType::Bool:
     {
-      return std::hash<Bool>{}(std::get<DataStorage<SerializedType::Bool>>(m_actual).value());
+      auto value = std::get<DataStorage<SerializedType::Bool>>(m_actual).value();
+      return SerializedHash::mix(seed(SerializedType::Bool) + static_cast<UInt64>(value));
     }
 
     case SerializedType::Array:
     {
-      throw InvalidOperationException("Cannot hash an array");
+      return std::get<SharedArray>(m_actual)->hash();
     }
 
     case SerializedType::Object:
     {
-      throw InvalidOperationException("Cannot hash an object");
+      return std::get<SharedObject>(m_actual)->hash();
     }
 
     case SerializedType::Null:
     {
-      throw InvalidOperationException("Cannot hash a null");
+      return seed(SerializedType::Null);
     }
 
     default:
@@ -399,6 +492,7 @@ SerializedData::get_bool()
     throw InvalidOperationException("Cannot get Bool from non-Bool");
   }
 
+  invalidate_parent();
   return std::get<DataStorage<SerializedType::Bool>>(m_actual);
 }
 
@@ -411,6 +505,7 @@ SerializedData::get_integer()
     throw InvalidOperationException("Cannot get integer from non-integer");
   }
 
+  invalidate_parent();
   return std::get<DataStorage<SerializedType::Integer>>(m_actual);
 }
 
@@ -423,6 +518,7 @@ SerializedData::get_float()
     throw InvalidOperationException("Cannot get Float32 from non-Float32");
   }
 
+  invalidate_parent();
   return std::get<DataStorage<SerializedType::Float>>(m_actual);
 }
 
@@ -435,6 +531,7 @@ SerializedData::get_string()
     throw InvalidOperationException("Cannot get string from non-string");
   }
 
+  invalidate_parent();
   return std::get<DataStorage<SerializedType::String>>(m_actual);
 }
 
@@ -632,6 +729,13 @@ SerializedData::string(const String& value)
 }
 
 
+SerializedData
+SerializedData::string(String&& value)
+{
+  return SerializedData(DataStorage(std::move(value)));
+}
+
+
 SerializedData
 SerializedData::boolean(Bool value)
 {
@@ -679,9 +783,9 @@ SerializedData::check_object_initializer(const Initializer<SerializedData>& list
 Bool
 SerializedData::try_compare_object(const SerializedData& other) const
 {
-  if (this->get_type() == SerializedType::Object || other.get_type() == SerializedType::Object)
+  if (this->get_type() == SerializedType::Object && other.get_type() == SerializedType::Object)
   {
-    throw InvalidOperationException("Cannot perform comparison between two SerializedData with Object type");
+    return this->get_object() == other.get_object();
   }
   return false;
 }
@@ -689,9 +793,9 @@ SerializedData::try_compare_object(const SerializedData& other) const
 Bool
 SerializedData::try_compare_array(const SerializedData& other) const
 {
-  if (this->get_type() == SerializedType::Array || other.get_type() == SerializedType::Array)
+  if (this->get_type() == SerializedType::Array && other.get_type() == SerializedType::Array)
   {
-    throw InvalidOperationException("Cannot perform comparison between two SerializedData with Array type");
+    return this->get_array() == other.get_array();
   }
   return false;
 }
@@ -0,0 +1,638 @@
+#include <setsugen/exception.h>
+#include <setsugen/serde.h>
+
+#include <utility>
+
+namespace setsugen
+{
+
+// Chunks double in size up to this many times, so a large document needs a few dozen allocations at most
+static constexpr size_t arena_max_growth = 10;
+
+static const DocumentNode null_node{};
+
+SerializedArena::SerializedArena(size_t chunk_size) noexcept
+    : m_cursor{nullptr}, m_end{nullptr}, m_chunk_size{std::max<size_t>(chunk_size, 64)}, m_used{0}
+{}
+
+SerializedArena::SerializedArena(SerializedArena&& other) noexcept
+    : m_chunks{std::move(other.m_chunks)}, m_cursor{std::exchange(other.m_cursor, nullptr)},
+      m_end{std::exchange(other.m_end, nullptr)}, m_chunk_size{other.m_chunk_size},
+      m_used{std::exchange(other.m_used, 0)}
+{}
+
+SerializedArena::~SerializedArena() noexcept = default;
+
+SerializedArena&
+SerializedArena::operator=(SerializedArena&& other) noexcept
+{
+  if (this != &other)
+  {
+    m_chunks     = std::move(other.m_chunks);
+    m_cursor     = std::exchange(other.m_cursor, nullptr);
+    m_end        = std::exchange(other.m_end, nullptr);
+    m_chunk_size = other.m_chunk_size;
+    m_used       = std::exchange(other.m_used, 0);
+  }
+
+  return *this;
+}
+
+Void*
+SerializedArena::allocate(size_t size, size_t alignment)
+{
+  auto address = reinterpret_cast<uintptr_t>(m_cursor);
+  auto aligned = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+
+  if (m_cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(m_end))
+  {
+    add_chunk(size + alignment);
+    address = reinterpret_cast<uintptr_t>(m_cursor);
+    aligned = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  }
+
+  m_cursor = reinterpret_cast<Byte*>(aligned + size);
+  m_used += size;
+  return reinterpret_cast<Void*>(aligned);
+}
+
+StringView
+SerializedArena::store(StringView value)
+{
+  auto data = allocate_array<char>(value.size() + 1);
+  std::memcpy(data, value.data(), value.size());
+  data[value.size()] = '\0';
+  return {data, value.size()};
+}
+
+Void
+SerializedArena::clear() noexcept
+{
+  if (m_chunks.empty())
+  {
+    return;
+  }
+
+  m_chunks.resize(1);
+  m_cursor = m_chunks.front().data.get();
+  m_end    = m_cursor + m_chunks.front().size;
+  m_used   = 0;
+}
+
+size_t
+SerializedArena::get_used_bytes() const noexcept
+{
+  return m_used;
+}
+
+size_t
+SerializedArena::get_reserved_bytes() const noexcept
+{
+  size_t reserved = 0;
+  for (const auto& chunk: m_chunks)
+  {
+    reserved += chunk.size;
+  }
+
+  return reserved;
+}
+
+Void
+SerializedArena::add_chunk(size_t min_size)
+{
+  auto size = std::max(min_size, m_chunk_size << std::min(m_chunks.size(), arena_max_growth));
+
+  // A chunk which is still empty, e.g. the one kept by clear(), is replaced instead of wasted
+  if (!m_chunks.empty() && m_cursor == m_chunks.back().data.get())
+  {
+    m_chunks.pop_back();
+  }
+
+  m_chunks.push_back({Owner<Byte[]>{new Byte[size]}, size});
+  m_cursor = m_chunks.back().data.get();
+  m_end    = m_cursor + size;
+}
+
+DocumentView::DocumentView() noexcept : m_node{&null_node}
+{}
+
+DocumentView::DocumentView(const DocumentNode* node) noexcept : m_node{node ? node : &null_node}
+{}
+
+SerializedType
+DocumentView::get_type() const noexcept
+{
+  return m_node->type;
+}
+
+size_t
+DocumentView::size() const
+{
+  if (m_node->type != SerializedType::Array && m_node->type != SerializedType::Object)
+  {
+    throw InvalidOperationException("Cannot get size of non-iterable type: {}", {m_node->type});
+  }
+
+  return m_node->size;
+}
+
+Bool
+DocumentView::get_bool() const
+{
+  if (m_node->type != SerializedType::Bool)
+  {
+    throw InvalidOperationException("Cannot get Bool from non-Bool");
+  }
+
+  return m_node->boolean;
+}
+
+Int64
+DocumentView::get_integer() const
+{
+  if (m_node->type != SerializedType::Integer)
+  {
+    throw InvalidOperationException("Cannot get integer from non-integer");
+  }
+
+  return m_node->integer;
+}
+
+Float64
+DocumentView::get_float() const
+{
+  if (m_node->type != SerializedType::Float)
+  {
+    throw InvalidOperationException("Cannot get Float32 from non-Float32");
+  }
+
+  return m_node->floating;
+}
+
+StringView
+DocumentView::get_string() const
+{
+  if (m_node->type != SerializedType::String)
+  {
+    throw InvalidOperationException("Cannot get string from non-string");
+  }
+
+  return {m_node->string, m_node->size};
+}
+
+DocumentArrayView
+DocumentView::get_array() const
+{
+  if (m_node->type != SerializedType::Array)
+  {
+    throw InvalidOperationException("Cannot get array from non-array");
+  }
+
+  return DocumentArrayView{m_node};
+}
+
+DocumentObjectView
+DocumentView::get_object() const
+{
+  if (m_node->type != SerializedType::Object)
+  {
+    throw InvalidOperationException("Cannot get object from non-object");
+  }
+
+  return DocumentObjectView{m_node};
+}
+
+DocumentView
+DocumentView::operator[](size_t index) const
+{
+  return get_array()[index];
+}
+
+DocumentView
+DocumentView::operator[](StringView key) const
+{
+  return get_object()[key];
+}
+
+DocumentView::operator Bool() const noexcept
+{
+  return m_node->type != SerializedType::Null;
+}
+
+SerializedData
+DocumentView::to_serialized() const
+{
+  switch (m_node->type)
+  {
+    case SerializedType::Bool: return SerializedData::boolean(m_node->boolean);
+    case SerializedType::Integer: return SerializedData::integer(m_node->integer);
+    case SerializedType::Float: return SerializedData::floating(m_node->floating);
+    case SerializedType::String: return SerializedData::string(String{m_node->string, m_node->size});
+    case SerializedType::Array:
+    {
+      auto  result = SerializedData::array({});
+      auto& array  = result.get_array();
+      array.reserve(m_node->size);
+      for (auto child: get_array())
+      {
+        array.push_back(child.to_serialized());
+      }
+
+      return result;
+    }
+    case SerializedType::Object:
+    {
+      auto  result = SerializedData::object({});
+      auto& object = result.get_object();
+      object.reserve(m_node->size);
+      for (auto [key, value]: get_object())
+      {
+        object[key] = value.to_serialized();
+      }
+
+      return result;
+    }
+    default: return SerializedData::null();
+  }
+}
+
+const DocumentNode*
+DocumentView::get_node() const noexcept
+{
+  return m_node;
+}
+
+DocumentArrayView::DocumentArrayView(const DocumentNode* node) noexcept : m_node{node}
+{}
+
+size_t
+DocumentArrayView::size() const noexcept
+{
+  return m_node->size;
+}
+
+Bool
+DocumentArrayView::empty() const noexcept
+{
+  return m_node->size == 0;
+}
+
+DocumentArrayView::Iter
+DocumentArrayView::begin() const noexcept
+{
+  return Iter{m_node->children};
+}
+
+DocumentArrayView::Iter
+DocumentArrayView::end() const noexcept
+{
+  return Iter{m_node->children + m_node->size};
+}
+
+DocumentView
+DocumentArrayView::operator[](size_t index) const
+{
+  if (index >= m_node->size)
+  {
+    throw OutOfBoundsException("Index {} is out of bounds for an array of size {}", {index, m_node->size});
+  }
+
+  return DocumentView{m_node->children + index};
+}
+
+DocumentObjectView::DocumentObjectView(const DocumentNode* node) noexcept : m_node{node}
+{}
+
+size_t
+DocumentObjectView::size() const noexcept
+{
+  return m_node->size;
+}
+
+Bool
+DocumentObjectView::empty() const noexcept
+{
+  return m_node->size == 0;
+}
+
+DocumentObjectView::Iter
+DocumentObjectView::begin() const noexcept
+{
+  return Iter{m_node->children};
+}
+
+DocumentObjectView::Iter
+DocumentObjectView::end() const noexcept
+{
+  return Iter{m_node->children + m_node->size * 2};
+}
+
+Bool
+DocumentObjectView::has_key(StringView key) const noexcept
+{
+  return find(key).has_value();
+}
+
+Optional<DocumentView>
+DocumentObjectView::find(StringView key) const noexcept
+{
+  for (auto [name, value]: *this)
+  {
+    if (name == key)
+    {
+      return value;
+    }
+  }
+
+  return std::nullopt;
+}
+
+DocumentView
+DocumentObjectView::operator[](StringView key) const
+{
+  if (auto value = find(key))
+  {
+    return *value;
+  }
+
+  throw OutOfBoundsException("Key {} does not exist in the object", {String{key}});
+}
+
+SerializedDocument::SerializedDocument(size_t chunk_size) noexcept : m_arena{chunk_size}, m_root{&null_node}
+{}
+
+SerializedDocument::SerializedDocument(SerializedDocument&& other) noexcept
+    : m_arena{std::move(other.m_arena)}, m_root{std::exchange(other.m_root, &null_node)}
+{}
+
+SerializedDocument::~SerializedDocument() noexcept = default;
+
+SerializedDocument&
+SerializedDocument::operator=(SerializedDocument&& other) noexcept
+{
+  m_arena = std::move(other.m_arena);
+  m_root  = std::exchange(other.m_root, &null_node);
+  return *this;
+}
+
+DocumentView
+SerializedDocument::root() const noexcept
+{
+  return DocumentView{m_root};
+}
+
+Void
+SerializedDocument::clear() noexcept
+{
+  m_arena.clear();
+  m_root = &null_node;
+}
+
+SerializedArena&
+SerializedDocument::get_arena() noexcept
+{
+  return m_arena;
+}
+
+const SerializedArena&
+SerializedDocument::get_arena() const noexcept
+{
+  return m_arena;
+}
+
+static Void
+build_from(DocumentBuilder& builder, const SerializedData& data)
+{
+  switch (data.get_type())
+  {
+    case SerializedType::Bool: builder.boolean(data.get_bool().value()); break;
+    case SerializedType::Integer: builder.integer(data.get_integer().value()); break;
+    case SerializedType::Float: builder.floating(data.get_float().value()); break;
+    case SerializedType::String: builder.string(data.get_string().value()); break;
+    case SerializedType::Array:
+    {
+      builder.begin_array();
+      for (const auto& child: data.get_array())
+      {
+        build_from(builder, child);
+      }
+      builder.end_array();
+      break;
+    }
+    case SerializedType::Object:
+    {
+      builder.begin_object();
+      for (const auto& [key, value]: data.get_object())
+      {
+        builder.key(key);
+        build_from(builder, value);
+      }
+      builder.end_object();
+      break;
+    }
+    default: builder.null(); break;
+  }
+}
+
+SerializedDocument
+SerializedDocument::from(const SerializedData& data)
+{
+  SerializedDocument document;
+  DocumentBuilder    builder{document};
+  build_from(builder, data);
+  builder.finish();
+  return document;
+}
+
+static DocumentNode
+string_node(StringView value)
+{
+  if (value.size() > std::numeric_limits<UInt32>::max())
+  {
+    throw OutOfBoundsException("String of {} bytes is too long for a document", {value.size()});
+  }
+
+  return DocumentNode{.type = SerializedType::String, .size = static_cast<UInt32>(value.size()), .string = value.data()};
+}
+
+DocumentBuilder::DocumentBuilder(SerializedDocument& document) : m_document{document}, m_keys{}
+{}
+
+Void
+DocumentBuilder::null()
+{
+  push(DocumentNode{});
+}
+
+Void
+DocumentBuilder::boolean(Bool value)
+{
+  push(DocumentNode{.type = SerializedType::Bool, .size = 0, .boolean = value});
+}
+
+Void
+DocumentBuilder::integer(Int64 value)
+{
+  push(DocumentNode{.type = SerializedType::Integer, .size = 0, .integer = value});
+}
+
+Void
+DocumentBuilder::floating(Float64 value)
+{
+  push(DocumentNode{.type = SerializedType::Float, .size = 0, .floating = value});
+}
+
+Void
+DocumentBuilder::string(StringView value)
+{
+  push(string_node(m_document.m_arena.store(value)));
+}
+
+Void
+DocumentBuilder::key(StringView key)
+{
+  push_key(intern(key));
+}
+
+Void
+DocumentBuilder::borrowed_string(StringView value)
+{
+  push(string_node(value));
+}
+
+Void
+DocumentBuilder::borrowed_key(StringView key)
+{
+  push_key(key);
+}
+
+Void
+DocumentBuilder::begin_array()
+{
+  expect_value();
+  m_frames.push_back({m_stack.size(), false});
+}
+
+Void
+DocumentBuilder::end_array()
+{
+  close(SerializedType::Array);
+}
+
+Void
+DocumentBuilder::begin_object()
+{
+  expect_value();
+  m_frames.push_back({m_stack.size(), true});
+}
+
+Void
+DocumentBuilder::end_object()
+{
+  close(SerializedType::Object);
+}
+
+Void
+DocumentBuilder::finish()
+{
+  if (!m_frames.empty() || m_stack.size() != 1)
+  {
+    throw InvalidStateException("A document needs exactly one complete top-level value");
+  }
+
+  auto root = m_document.m_arena.allocate_array<DocumentNode>(1);
+  *root     = m_stack.front();
+  m_stack.clear();
+
+  m_document.m_root = root;
+}
+
+Void
+DocumentBuilder::push(const DocumentNode& node)
+{
+  expect_value();
+  m_stack.push_back(node);
+}
+
+Void
+DocumentBuilder::push_key(StringView key)
+{
+  if (m_frames.empty() || !m_frames.back().object || (m_stack.size() - m_frames.back().start) % 2 != 0)
+  {
+    throw InvalidStateException("A key can only start a member of an object");
+  }
+
+  m_stack.push_back(string_node(key));
+}
+
+Void
+DocumentBuilder::expect_value() const
+{
+  if (m_frames.empty())
+  {
+    if (!m_stack.empty())
+    {
+      throw InvalidStateException("A document can only have one top-level value");
+    }
+  }
+  else if (m_frames.back().object && (m_stack.size() - m_frames.back().start) % 2 == 0)
+  {
+    throw InvalidStateException("A value inside an object must be preceded by its key");
+  }
+}
+
+Void
+DocumentBuilder::close(SerializedType type)
+{
+  if (m_frames.empty() || m_frames.back().object != (type == SerializedType::Object))
+  {
+    throw InvalidStateException("Closing a {} which was never opened", {type});
+  }
+
+  auto frame = m_frames.back();
+  auto count = m_stack.size() - frame.start;
+  if (frame.object && count % 2 != 0)
+  {
+    throw InvalidStateException("The last member of the object has no value");
+  }
+
+  if (count > std::numeric_limits<UInt32>::max())
+  {
+    throw OutOfBoundsException("Container of {} nodes is too large for a document", {count});
+  }
+
+  // Children are copied into the arena in one block, so they stay contiguous and the stack can be reused
+  auto children = m_document.m_arena.allocate_array<DocumentNode>(count);
+  std::copy(m_stack.begin() + static_cast<PtrDiff>(frame.start), m_stack.end(), children);
+  m_stack.resize(frame.start);
+  m_frames.pop_back();
+
+  auto size = static_cast<UInt32>(frame.object ? count / 2 : count);
+  m_stack.push_back(DocumentNode{.type = type, .size = size, .children = children});
+}
+
+StringView
+DocumentBuilder::intern(StringView key)
+{
+  if (key.size() > max_interned_size)
+  {
+    return m_document.m_arena.store(key);
+  }
+
+  // FNV-1a, keys are short enough that anything smarter costs more than it saves
+  UInt32 hash = 2166136261u;
+  for (auto c: key)
+  {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+  }
+
+  auto& cached = m_keys[hash % key_cache_size];
+  if (cached.data() == nullptr || cached != key)
+  {
+    cached = m_document.m_arena.store(key);
+  }
+
+  return cached;
+}
+
+} // namespace setsugen
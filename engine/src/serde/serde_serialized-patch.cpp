@@ -0,0 +1,489 @@
+#include <setsugen/exception.h>
+#include <setsugen/serde.h>
+
+namespace setsugen
+{
+
+// Whether `from` and `to` are equal. Shared containers are equal without a traversal and containers whose hashes differ
+// without a comparison, hashes are cached so checking the children of a compared container again is cheap
+static Bool
+unchanged(const SerializedData& from, const SerializedData& to)
+{
+  if (from.get_type() != to.get_type())
+  {
+    return false;
+  }
+
+  if (from.get_type() == SerializedType::Object)
+  {
+    return &from.get_object() == &to.get_object() || (from.hash() == to.hash() && from == to);
+  }
+
+  if (from.get_type() == SerializedType::Array)
+  {
+    return &from.get_array() == &to.get_array() || (from.hash() == to.hash() && from == to);
+  }
+
+  return from == to;
+}
+
+static Void
+append_token(String& pointer, StringView token)
+{
+  pointer.push_back('/');
+  for (auto c: token)
+  {
+    if (c == '~')
+    {
+      pointer.append("~0");
+    }
+    else if (c == '/')
+    {
+      pointer.append("~1");
+    }
+    else
+    {
+      pointer.push_back(c);
+    }
+  }
+}
+
+static Void
+add_operation(DataStorage<SerializedType::Array>& operations, const char* op, const String& pointer,
+              const SerializedData* value)
+{
+  auto builder = SerializedData::object_builder(3);
+  builder.add("op", op).add("path", pointer);
+  if (value)
+  {
+    builder.add("value", *value);
+  }
+
+  operations.push_back(std::move(builder).build());
+}
+
+// Appends the operations turning `from` into `to` to `operations`, `pointer` locates both and is restored on return
+static Void
+diff_into(const SerializedData& from, const SerializedData& to, String& pointer,
+          DataStorage<SerializedType::Array>& operations)
+{
+  if (unchanged(from, to))
+  {
+    return;
+  }
+
+  auto length = pointer.size();
+  if (from.get_type() == SerializedType::Object && to.get_type() == SerializedType::Object)
+  {
+    const auto& before = from.get_object();
+    const auto& after  = to.get_object();
+
+    for (const auto& [key, value]: before)
+    {
+      if (!after.find(key))
+      {
+        append_token(pointer, key);
+        add_operation(operations, "remove", pointer, nullptr);
+        pointer.resize(length);
+      }
+    }
+
+    for (const auto& [key, value]: after)
+    {
+      append_token(pointer, key);
+      if (auto previous = before.find(key))
+      {
+        diff_into(*previous, value, pointer, operations);
+      }
+      else
+      {
+        add_operation(operations, "add", pointer, &value);
+      }
+      pointer.resize(length);
+    }
+
+    return;
+  }
+
+  if (from.get_type() == SerializedType::Array && to.get_type() == SerializedType::Array)
+  {
+    const auto& before = from.get_array();
+    const auto& after  = to.get_array();
+    auto        common = std::min(before.size(), after.size());
+
+    size_t prefix = 0;
+    while (prefix < common && unchanged(before[prefix], after[prefix]))
+    {
+      ++prefix;
+    }
+
+    size_t suffix = 0;
+    while (suffix < common - prefix && unchanged(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix]))
+    {
+      ++suffix;
+    }
+
+    auto removed = before.size() - prefix - suffix;
+    auto added   = after.size() - prefix - suffix;
+    auto paired  = std::min(removed, added);
+
+    for (size_t i = 0; i < paired; ++i)
+    {
+      append_token(pointer, std::to_string(prefix + i));
+      diff_into(before[prefix + i], after[prefix + i], pointer, operations);
+      pointer.resize(length);
+    }
+
+    // Surplus elements are removed from the back, so that removing one does not shift the next
+    for (auto i = removed; i > paired; --i)
+    {
+      append_token(pointer, std::to_string(prefix + i - 1));
+      add_operation(operations, "remove", pointer, nullptr);
+      pointer.resize(length);
+    }
+
+    for (auto i = paired; i < added; ++i)
+    {
+      append_token(pointer, std::to_string(prefix + i));
+      add_operation(operations, "add", pointer, &after[prefix + i]);
+      pointer.resize(length);
+    }
+
+    return;
+  }
+
+  add_operation(operations, "replace", pointer, &to);
+}
+
+SerializedData
+SerializedData::diff(const SerializedData& from, const SerializedData& to)
+{
+  auto   patch = SerializedData::array({});
+  String pointer;
+  diff_into(from, to, pointer, patch.get_array());
+  return patch;
+}
+
+
+SerializedData
+SerializedData::merge_diff(const SerializedData& from, const SerializedData& to)
+{
+  if (from.get_type() != SerializedType::Object || to.get_type() != SerializedType::Object)
+  {
+    return to;
+  }
+
+  const auto& before  = from.get_object();
+  const auto& after   = to.get_object();
+  auto        builder = SerializedData::object_builder();
+
+  for (const auto& [key, value]: before)
+  {
+    if (!after.find(key))
+    {
+      builder.add(key, SerializedData::null());
+    }
+  }
+
+  for (const auto& [key, value]: after)
+  {
+    auto previous = before.find(key);
+    if (previous ? unchanged(*previous, value) : value.get_type() == SerializedType::Null)
+    {
+      continue;
+    }
+
+    builder.add(key, previous ? merge_diff(*previous, value) : value);
+  }
+
+  return std::move(builder).build();
+}
+
+// Whether applying the merge `patch` to `target` changes it
+static Bool
+merge_changes(const SerializedData& target, const SerializedData& patch)
+{
+  if (patch.get_type() != SerializedType::Object)
+  {
+    return !unchanged(target, patch);
+  }
+
+  if (target.get_type() != SerializedType::Object)
+  {
+    return true;
+  }
+
+  for (const auto& [key, value]: patch.get_object())
+  {
+    auto existing = target.get_object().find(key);
+    if (value.get_type() == SerializedType::Null ? existing != nullptr : !existing || merge_changes(*existing, value))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static Void
+merge_into(SerializedData& target, const SerializedData& patch)
+{
+  if (patch.get_type() != SerializedType::Object)
+  {
+    target = patch;
+    return;
+  }
+
+  if (target.get_type() != SerializedType::Object)
+  {
+    target = SerializedData::object({});
+  }
+
+  auto& object = target.get_object();
+  for (const auto& [key, value]: patch.get_object())
+  {
+    auto existing = object.find(key);
+    if (value.get_type() == SerializedType::Null)
+    {
+      if (existing)
+      {
+        object.erase(key);
+      }
+    }
+    else if (!existing)
+    {
+      merge_into(object[key], value);
+    }
+    else if (merge_changes(*existing, value))
+    {
+      merge_into(*existing, value);
+    }
+  }
+}
+
+Void
+SerializedData::apply_merge_patch(const SerializedData& patch)
+{
+  // Only the containers on the way to a change are accessed mutably, which is what clones shared ones and resets hashes
+  if (merge_changes(*this, patch))
+  {
+    merge_into(*this, patch);
+  }
+}
+
+static const SerializedData&
+member_of(const SerializedData& operation, StringView key)
+{
+  auto member = operation.get_object().find(key);
+  if (!member)
+  {
+    throw InvalidFormatException("Patch operation has no {} member", {String{key}});
+  }
+
+  return *member;
+}
+
+static SerializedPath
+pointer_of(const SerializedData& operation, StringView key)
+{
+  const auto& member = member_of(operation, key);
+  if (member.get_type() != SerializedType::String)
+  {
+    throw InvalidFormatException("Patch operation member {} is not a string", {String{key}});
+  }
+
+  return SerializedPath::pointer(member.get_string().view());
+}
+
+// Container of the value at `path`, which must exist up to the last segment
+static SerializedData&
+parent_of(SerializedData& root, const SerializedPath& path)
+{
+  const auto& segments = path.get_segments();
+  auto        current  = &root;
+
+  for (size_t i = 0; i + 1 < segments.size(); ++i)
+  {
+    SerializedData* next = nullptr;
+    if (current->get_type() == SerializedType::Object)
+    {
+      next = current->get_object().find(segments[i].key, segments[i].hash);
+    }
+    else if (current->get_type() == SerializedType::Array && segments[i].index < current->get_array().size())
+    {
+      next = &current->get_array()[segments[i].index];
+    }
+
+    if (!next)
+    {
+      throw InvalidArgumentException("Path {} does not exist", {path.to_pointer()});
+    }
+    current = next;
+  }
+
+  return *current;
+}
+
+static Void
+patch_add(SerializedData& root, const SerializedPath& path, SerializedData&& value)
+{
+  if (path.empty())
+  {
+    root = std::move(value);
+    return;
+  }
+
+  auto&       parent = parent_of(root, path);
+  const auto& last   = path.get_segments().back();
+
+  if (parent.get_type() == SerializedType::Object)
+  {
+    parent.get_object().emplace(last.key, std::move(value));
+    return;
+  }
+
+  if (parent.get_type() == SerializedType::Array)
+  {
+    auto& array = parent.get_array();
+    if (last.key == "-")
+    {
+      array.push_back(std::move(value));
+      return;
+    }
+
+    if (last.index <= array.size())
+    {
+      array.insert(last.index, std::move(value));
+      return;
+    }
+  }
+
+  throw InvalidArgumentException("Path {} does not exist", {path.to_pointer()});
+}
+
+static SerializedData
+patch_remove(SerializedData& root, const SerializedPath& path)
+{
+  if (path.empty())
+  {
+    throw InvalidArgumentException("Cannot remove the root of a document");
+  }
+
+  auto&       parent = parent_of(root, path);
+  const auto& last   = path.get_segments().back();
+
+  if (parent.get_type() == SerializedType::Object)
+  {
+    auto& object = parent.get_object();
+    if (auto value = object.find(last.key, last.hash))
+    {
+      auto removed = std::move(*value);
+      object.erase(last.key);
+      return removed;
+    }
+  }
+  else if (parent.get_type() == SerializedType::Array && last.index < parent.get_array().size())
+  {
+    auto& array   = parent.get_array();
+    auto  removed = std::move(array[last.index]);
+    array.erase(last.index);
+    return removed;
+  }
+
+  throw InvalidArgumentException("Path {} does not exist", {path.to_pointer()});
+}
+
+static Bool
+is_proper_prefix(const SerializedPath& prefix, const SerializedPath& path)
+{
+  if (prefix.size() >= path.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < prefix.size(); ++i)
+  {
+    if (prefix.get_segments()[i].key != path.get_segments()[i].key)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Void
+SerializedData::apply_patch(const SerializedData& patch)
+{
+  if (patch.get_type() != SerializedType::Array)
+  {
+    throw InvalidFormatException("A JSON patch must be an array of operations");
+  }
+
+  // The copy shares every container with this value, the ones an operation writes to are cloned on the way down
+  auto result = *this;
+  for (const auto& operation: patch.get_array())
+  {
+    if (operation.get_type() != SerializedType::Object ||
+        member_of(operation, "op").get_type() != SerializedType::String)
+    {
+      throw InvalidFormatException("A JSON patch operation must be an object with an op string");
+    }
+
+    auto op   = member_of(operation, "op").get_string().view();
+    auto path = pointer_of(operation, "path");
+
+    if (op == "add")
+    {
+      patch_add(result, path, SerializedData(member_of(operation, "value")));
+    }
+    else if (op == "remove")
+    {
+      patch_remove(result, path);
+    }
+    else if (op == "replace")
+    {
+      auto target = path.resolve(result);
+      if (!target)
+      {
+        throw InvalidArgumentException("Path {} does not exist", {path.to_pointer()});
+      }
+      *target = member_of(operation, "value");
+    }
+    else if (op == "move")
+    {
+      auto from = pointer_of(operation, "from");
+      if (is_proper_prefix(from, path))
+      {
+        throw InvalidArgumentException("Cannot move {} into itself", {from.to_pointer()});
+      }
+      patch_add(result, path, patch_remove(result, from));
+    }
+    else if (op == "copy")
+    {
+      auto from   = pointer_of(operation, "from");
+      auto source = from.resolve(static_cast<const SerializedData&>(result));
+      if (!source)
+      {
+        throw InvalidArgumentException("Path {} does not exist", {from.to_pointer()});
+      }
+      patch_add(result, path, SerializedData(*source));
+    }
+    else if (op == "test")
+    {
+      auto target = path.resolve(static_cast<const SerializedData&>(result));
+      if (!target || *target != member_of(operation, "value"))
+      {
+        throw InvalidArgumentException("Test of {} failed", {path.to_pointer()});
+      }
+    }
+    else
+    {
+      throw InvalidFormatException("Unknown patch operation {}", {String{op}});
+    }
+  }
+
+  *this = std::move(result);
+}
+
+} // namespace setsugen
@@ -0,0 +1,264 @@
+#include <setsugen/exception.h>
+#include <setsugen/serde.h>
+
+#include <charconv>
+
+namespace setsugen
+{
+
+// Array index spelled by `token`, digits only and without leading zeros as RFC 6901 requires
+static size_t
+parse_index(StringView token)
+{
+  if (token.empty() || (token.size() > 1 && token[0] == '0'))
+  {
+    return SerializedPath::no_index;
+  }
+
+  size_t index = 0;
+  auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), index);
+  if (error != std::errc{} || end != token.data() + token.size())
+  {
+    return SerializedPath::no_index;
+  }
+
+  return index;
+}
+
+
+SerializedPath::SerializedPath(StringView path)
+    : SerializedPath(path.empty() || path[0] == '/' ? pointer(path) : dotted(path))
+{}
+
+
+SerializedPath::SerializedPath(const char* path) : SerializedPath(StringView{path})
+{}
+
+
+SerializedPath::SerializedPath(const String& path) : SerializedPath(StringView{path})
+{}
+
+
+SerializedPath
+SerializedPath::pointer(StringView pointer)
+{
+  SerializedPath path;
+  if (pointer.empty())
+  {
+    return path;
+  }
+
+  if (pointer[0] != '/')
+  {
+    throw InvalidSyntaxException("JSON pointer {} does not start with /", {String{pointer}});
+  }
+
+  size_t begin = 1;
+  while (true)
+  {
+    auto   end = std::min(pointer.find('/', begin), pointer.size());
+    String key;
+    key.reserve(end - begin);
+
+    for (auto i = begin; i < end; ++i)
+    {
+      if (pointer[i] != '~')
+      {
+        key.push_back(pointer[i]);
+        continue;
+      }
+
+      if (i + 1 == end || (pointer[i + 1] != '0' && pointer[i + 1] != '1'))
+      {
+        throw InvalidSyntaxException("Invalid escape sequence in JSON pointer {}", {String{pointer}});
+      }
+
+      key.push_back(pointer[++i] == '0' ? '~' : '/');
+    }
+
+    path.append(std::move(key), false);
+    if (end == pointer.size())
+    {
+      return path;
+    }
+    begin = end + 1;
+  }
+}
+
+
+SerializedPath
+SerializedPath::dotted(StringView dotted)
+{
+  SerializedPath path;
+  size_t         position = 0;
+
+  while (position < dotted.size())
+  {
+    // A member name, which may be left out before a subscript as in `[0].id`
+    auto end = std::min(dotted.find_first_of(".[", position), dotted.size());
+    if (end == position && (position != 0 || end == dotted.size() || dotted[end] != '['))
+    {
+      throw InvalidSyntaxException("Empty member name at position {} in path {}", {position, String{dotted}});
+    }
+
+    if (end != position)
+    {
+      auto name = dotted.substr(position, end - position);
+      path.append(String{name}, name == "*");
+    }
+    position = end;
+
+    while (position < dotted.size() && dotted[position] == '[')
+    {
+      auto close = dotted.find(']', position);
+      if (close == StringView::npos)
+      {
+        throw InvalidSyntaxException("Unterminated subscript in path {}", {String{dotted}});
+      }
+
+      auto subscript = dotted.substr(position + 1, close - position - 1);
+      if (subscript != "*" && parse_index(subscript) == no_index)
+      {
+        throw InvalidSyntaxException("Invalid subscript [{}] in path {}", {String{subscript}, String{dotted}});
+      }
+
+      path.append(String{subscript}, subscript == "*");
+      position = close + 1;
+    }
+
+    if (position < dotted.size())
+    {
+      if (dotted[position] != '.' || position + 1 == dotted.size())
+      {
+        throw InvalidSyntaxException("Unexpected character at position {} in path {}", {position, String{dotted}});
+      }
+      ++position;
+    }
+  }
+
+  return path;
+}
+
+
+SerializedPath&
+SerializedPath::append(String&& key, Bool wildcard)
+{
+  auto& segment    = m_segments.emplace_back();
+  segment.hash     = DataStorage<SerializedType::Object>::key_hash(key);
+  segment.index    = parse_index(key);
+  segment.wildcard = wildcard;
+  segment.key      = std::move(key);
+  m_wildcard       = m_wildcard || wildcard;
+  return *this;
+}
+
+
+SerializedData*
+SerializedPath::resolve(SerializedData& root) const
+{
+  if (m_wildcard)
+  {
+    throw InvalidOperationException("Cannot resolve path {} with wildcards to a single value", {to_pointer()});
+  }
+
+  auto current = &root;
+  for (const auto& segment: m_segments)
+  {
+    current = step(*current, segment);
+    if (!current)
+    {
+      return nullptr;
+    }
+  }
+
+  return current;
+}
+
+
+const SerializedData*
+SerializedPath::resolve(const SerializedData& root) const
+{
+  if (m_wildcard)
+  {
+    throw InvalidOperationException("Cannot resolve path {} with wildcards to a single value", {to_pointer()});
+  }
+
+  auto current = &root;
+  for (const auto& segment: m_segments)
+  {
+    current = step(*current, segment);
+    if (!current)
+    {
+      return nullptr;
+    }
+  }
+
+  return current;
+}
+
+
+DArray<const SerializedData*>
+SerializedPath::select(const SerializedData& root) const
+{
+  DArray<const SerializedData*> result;
+  for_each(root, [&result](const SerializedData& data) { result.push_back(&data); });
+  return result;
+}
+
+
+Bool
+SerializedPath::empty() const noexcept
+{
+  return m_segments.empty();
+}
+
+
+size_t
+SerializedPath::size() const noexcept
+{
+  return m_segments.size();
+}
+
+
+Bool
+SerializedPath::has_wildcard() const noexcept
+{
+  return m_wildcard;
+}
+
+
+const DArray<SerializedPath::Segment>&
+SerializedPath::get_segments() const noexcept
+{
+  return m_segments;
+}
+
+
+String
+SerializedPath::to_pointer() const
+{
+  String result;
+  for (const auto& segment: m_segments)
+  {
+    result.push_back('/');
+    for (auto c: segment.key)
+    {
+      if (c == '~')
+      {
+        result.append("~0");
+      }
+      else if (c == '/')
+      {
+        result.append("~1");
+      }
+      else
+      {
+        result.push_back(c);
+      }
+    }
+  }
+
+  return result;
+}
+
+} // namespace setsugen
@@ -7,27 +7,55 @@ using ArrayStorage = DataStorage<SerializedType::Array>;
 ArrayStorage::DataStorage() noexcept = default;
 
 
-ArrayStorage::DataStorage(const DataStorage &other) noexcept : m_arrays(other.m_arrays)
-{}
+ArrayStorage::DataStorage(const DataStorage &other) noexcept : m_arrays(other.m_arrays), m_hash(other.m_hash)
+{
+  adopt();
+}
 
 
-ArrayStorage::DataStorage(DataStorage &&other) noexcept : m_arrays(std::move(other.m_arrays))
-{}
+ArrayStorage::DataStorage(DataStorage &&other) noexcept
+    : m_arrays(std::move(other.m_arrays)),
+      m_hash(std::move(other.m_hash))
+{
+  other.m_hash.invalidate();
+  adopt();
+}
 
 
 ArrayStorage::DataStorage(Initializer<SerializedData> list) : m_arrays(list)
-{}
+{
+  adopt();
+}
 
 
-ArrayStorage &ArrayStorage::operator=(const DataStorage &other) noexcept = default;
+ArrayStorage &
+ArrayStorage::operator=(const DataStorage &other) noexcept
+{
+  m_hash.invalidate();
+  m_arrays = other.m_arrays;
+  adopt();
+  return *this;
+}
 
-ArrayStorage &ArrayStorage::operator=(DataStorage &&other) noexcept = default;
+
+ArrayStorage &
+ArrayStorage::operator=(DataStorage &&other) noexcept
+{
+  m_hash.invalidate();
+  other.m_hash.invalidate();
+  m_arrays = std::move(other.m_arrays);
+  adopt();
+  return *this;
+}
 
 
 ArrayStorage &
 ArrayStorage::push_back(const SerializedData &data)
 {
+  m_hash.invalidate();
+  auto previous = m_arrays.data();
   m_arrays.push_back(data);
+  adopt_appended(previous);
   return *this;
 }
 
@@ -35,7 +63,10 @@ ArrayStorage::push_back(const SerializedData &data)
 ArrayStorage &
 ArrayStorage::push_back(SerializedData &&data)
 {
+  m_hash.invalidate();
+  auto previous = m_arrays.data();
   m_arrays.push_back(std::move(data));
+  adopt_appended(previous);
   return *this;
 }
 
@@ -43,6 +74,7 @@ ArrayStorage::push_back(SerializedData &&data)
 ArrayStorage &
 ArrayStorage::pop_back()
 {
+  m_hash.invalidate();
   m_arrays.pop_back();
   return *this;
 }
@@ -51,6 +83,7 @@ ArrayStorage::pop_back()
 ArrayStorage &
 ArrayStorage::clear()
 {
+  m_hash.invalidate();
   m_arrays.clear();
   return *this;
 }
@@ -59,7 +92,9 @@ ArrayStorage::clear()
 ArrayStorage &
 ArrayStorage::erase(size_t index)
 {
+  m_hash.invalidate();
   m_arrays.erase(m_arrays.begin() + index);
+  adopt();
   return *this;
 }
 
@@ -67,7 +102,9 @@ ArrayStorage::erase(size_t index)
 ArrayStorage &
 ArrayStorage::insert(size_t index, const SerializedData &data)
 {
+  m_hash.invalidate();
   m_arrays.insert(m_arrays.begin() + index, data);
+  adopt();
   return *this;
 }
 
@@ -75,7 +112,9 @@ ArrayStorage::insert(size_t index, const SerializedData &data)
 ArrayStorage &
 ArrayStorage::insert(size_t index, SerializedData &&data)
 {
+  m_hash.invalidate();
   m_arrays.insert(m_arrays.begin() + index, std::move(data));
+  adopt();
   return *this;
 }
 
@@ -83,7 +122,9 @@ ArrayStorage::insert(size_t index, SerializedData &&data)
 ArrayStorage &
 ArrayStorage::resize(size_t size)
 {
+  m_hash.invalidate();
   m_arrays.resize(size);
+  adopt();
   return *this;
 }
 
@@ -91,7 +132,13 @@ ArrayStorage::resize(size_t size)
 ArrayStorage &
 ArrayStorage::reserve(size_t size)
 {
+  auto previous = m_arrays.data();
   m_arrays.reserve(size);
+  if (m_arrays.data() != previous)
+  {
+    adopt();
+  }
+
   return *this;
 }
 
@@ -99,7 +146,11 @@ ArrayStorage::reserve(size_t size)
 ArrayStorage &
 ArrayStorage::swap(DataStorage &other) noexcept
 {
+  m_hash.invalidate();
+  other.m_hash.invalidate();
   m_arrays.swap(other.m_arrays);
+  adopt();
+  other.adopt();
   return *this;
 }
 
@@ -107,7 +158,13 @@ ArrayStorage::swap(DataStorage &other) noexcept
 ArrayStorage &
 ArrayStorage::shrink_to_fit()
 {
+  auto previous = m_arrays.data();
   m_arrays.shrink_to_fit();
+  if (m_arrays.data() != previous)
+  {
+    adopt();
+  }
+
   return *this;
 }
 
@@ -115,7 +172,9 @@ ArrayStorage::shrink_to_fit()
 ArrayStorage &
 ArrayStorage::sort(std::function<Int32(const SerializedData &, const SerializedData &)> pred)
 {
+  m_hash.invalidate();
   std::sort(m_arrays.begin(), m_arrays.end(), pred);
+  adopt();
   return *this;
 }
 
@@ -143,6 +202,7 @@ ArrayStorage::operator Bool() const noexcept
 ArrayStorage::Iter
 ArrayStorage::begin()
 {
+  m_hash.invalidate();
   return m_arrays.begin();
 }
 
@@ -150,6 +210,7 @@ ArrayStorage::begin()
 ArrayStorage::Iter
 ArrayStorage::end()
 {
+  m_hash.invalidate();
   return m_arrays.end();
 }
 
@@ -171,6 +232,7 @@ ArrayStorage::end() const
 ArrayStorage::RIter
 ArrayStorage::rbegin()
 {
+  m_hash.invalidate();
   return m_arrays.rbegin();
 }
 
@@ -178,6 +240,7 @@ ArrayStorage::rbegin()
 ArrayStorage::RIter
 ArrayStorage::rend()
 {
+  m_hash.invalidate();
   return m_arrays.rend();
 }
 
@@ -199,6 +262,7 @@ ArrayStorage::rend() const
 SerializedData &
 ArrayStorage::operator[](size_t index)
 {
+  m_hash.invalidate();
   return m_arrays[index];
 }
 
@@ -208,4 +272,87 @@ ArrayStorage::operator[](size_t index) const
 {
   return m_arrays[index];
 }
+
+
+UInt64
+ArrayStorage::hash() const
+{
+  if (auto cached = m_hash.get())
+  {
+    return cached;
+  }
+
+  // Combining in sequence keeps the hash sensitive to the order of the elements
+  UInt64 value = SerializedHash::mix(static_cast<UInt64>(SerializedType::Array) + 1);
+  for (const auto &data: m_arrays)
+  {
+    value = SerializedHash::mix(value + data.hash());
+  }
+
+  value = value ? value : 1;
+  m_hash.store(value);
+  return value;
+}
+
+
+Bool
+ArrayStorage::operator==(const DataStorage &other) const
+{
+  if (this == &other)
+  {
+    return true;
+  }
+
+  if (m_arrays.size() != other.m_arrays.size())
+  {
+    return false;
+  }
+
+  auto hash = m_hash.get(), other_hash = other.m_hash.get();
+  if (hash && other_hash && hash != other_hash)
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < m_arrays.size(); ++i)
+  {
+    if (m_arrays[i] != other.m_arrays[i])
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Void
+ArrayStorage::adopt(SerializedData &data) noexcept
+{
+  data.m_parent = &m_hash;
+  data.attach();
+}
+
+
+Void
+ArrayStorage::adopt() noexcept
+{
+  for (auto &data: m_arrays)
+  {
+    adopt(data);
+  }
+}
+
+
+Void
+ArrayStorage::adopt_appended(const SerializedData *previous) noexcept
+{
+  if (m_arrays.data() != previous)
+  {
+    adopt();
+  }
+  else
+  {
+    adopt(m_arrays.back());
+  }
+}
 } // namespace setsugen
@@ -1,19 +1,40 @@
 #include <setsugen/serde.h>
 #include <setsugen/exception.h>
 
+#include <bit>
+#include <utility>
+
 namespace setsugen
 {
 using ObjectStorage = DataStorage<SerializedType::Object>;
 
+static constexpr size_t npos = static_cast<size_t>(-1);
+
 ObjectStorage::DataStorage() = default;
 
-ObjectStorage::DataStorage(const ObjectStorage &other) = default;
+ObjectStorage::DataStorage(const ObjectStorage &other)
+    : m_entries(other.m_entries),
+      m_index(other.m_index),
+      m_hash(other.m_hash)
+{
+  adopt();
+}
 
-ObjectStorage::DataStorage(ObjectStorage &&other) noexcept = default;
+
+ObjectStorage::DataStorage(ObjectStorage &&other) noexcept
+    : m_entries(std::move(other.m_entries)),
+      m_index(std::move(other.m_index)),
+      m_hash(std::move(other.m_hash))
+{
+  other.m_hash.invalidate();
+  adopt();
+}
 
 
 ObjectStorage::DataStorage(Initializer<SerializedData> list)
 {
+  m_entries.reserve(list.size());
+
   for (const auto &data: list)
   {
     if (data.get_type() != SerializedType::Array)
@@ -32,65 +53,408 @@ ObjectStorage::DataStorage(Initializer<SerializedData> list)
       throw InvalidArgumentException("ObjectStorage initializer list array first element must be a string");
     }
 
-    m_map[arr[0].get_string().value()] = arr[1];
+    (*this)[arr[0].get_string().value()] = arr[1];
   }
 }
 
 
-ObjectStorage &ObjectStorage::operator=(const ObjectStorage &other) = default;
+ObjectStorage &
+ObjectStorage::operator=(const ObjectStorage &other)
+{
+  m_hash.invalidate();
+  m_entries = other.m_entries;
+  m_index   = other.m_index;
+  adopt();
+  return *this;
+}
+
 
-ObjectStorage &ObjectStorage::operator=(ObjectStorage &&other) noexcept = default;
+ObjectStorage &
+ObjectStorage::operator=(ObjectStorage &&other) noexcept
+{
+  m_hash.invalidate();
+  other.m_hash.invalidate();
+  m_entries = std::move(other.m_entries);
+  m_index   = std::move(other.m_index);
+  adopt();
+  return *this;
+}
 
 
-SerializedData &ObjectStorage::operator[](const String &key)
+SerializedData &ObjectStorage::operator[](StringView key)
 {
-  return m_map[key];
+  m_hash.invalidate();
+  if (m_index.empty())
+  {
+    auto position = find_position(key);
+    if (position != npos)
+    {
+      return m_entries[position].second;
+    }
+
+    auto previous = m_entries.data();
+    m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+    adopt_appended(previous);
+    if (m_entries.size() > index_threshold)
+    {
+      rebuild_index();
+    }
+    return m_entries.back().second;
+  }
+
+  // The hash is computed once and serves both the lookup and the insertion
+  auto hash     = key_hash(key);
+  auto position = find_indexed(key, hash);
+  if (position != npos)
+  {
+    return m_entries[position].second;
+  }
+
+  auto previous = m_entries.data();
+  m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+  adopt_appended(previous);
+  insert_index(m_entries.size() - 1, hash);
+  return m_entries.back().second;
 }
 
 
 DataStorage<SerializedType::Object>::Iter
 ObjectStorage::begin()
 {
-  return m_map.begin();
+  m_hash.invalidate();
+  return m_entries.begin();
 }
 
 
 DataStorage<SerializedType::Object>::Iter
 ObjectStorage::end()
 {
-  return m_map.end();
+  m_hash.invalidate();
+  return m_entries.end();
 }
 
 
 DataStorage<SerializedType::Object>::CIter
 ObjectStorage::begin() const
 {
-  return m_map.begin();
+  return m_entries.begin();
 }
 
 
 DataStorage<SerializedType::Object>::CIter
 ObjectStorage::end() const
 {
-  return m_map.end();
+  return m_entries.end();
 }
 
 
 const SerializedData&
-ObjectStorage::operator[](const String& key) const
+ObjectStorage::operator[](StringView key) const
+{
+  auto position = find_position(key);
+  if (position == npos)
+  {
+    throw OutOfBoundsException("Key {} does not exist in the object", {String{key}});
+  }
+
+  return m_entries[position].second;
+}
+
+Bool
+DataStorage<SerializedType::Object>::has_key(StringView key) const
+{
+  return find_position(key) != npos;
+}
+
+
+SerializedData*
+ObjectStorage::find(StringView key)
+{
+  m_hash.invalidate();
+  auto position = find_position(key);
+  return position != npos ? &m_entries[position].second : nullptr;
+}
+
+
+const SerializedData*
+ObjectStorage::find(StringView key) const
+{
+  auto position = find_position(key);
+  return position != npos ? &m_entries[position].second : nullptr;
+}
+
+
+SerializedData*
+ObjectStorage::find(StringView key, UInt32 hash)
+{
+  m_hash.invalidate();
+  auto position = find_position(key, hash);
+  return position != npos ? &m_entries[position].second : nullptr;
+}
+
+
+const SerializedData*
+ObjectStorage::find(StringView key, UInt32 hash) const
+{
+  auto position = find_position(key, hash);
+  return position != npos ? &m_entries[position].second : nullptr;
+}
+
+
+UInt32
+ObjectStorage::key_hash(StringView key)
+{
+  return static_cast<UInt32>(std::hash<StringView>{}(key));
+}
+
+
+ObjectStorage&
+ObjectStorage::erase(StringView key)
+{
+  m_hash.invalidate();
+  auto position = find_position(key);
+  if (position == npos)
+  {
+    return *this;
+  }
+
+  // Removing from the middle shifts every later member, the slots pointing at them are easier to rebuild than to fix
+  m_entries.erase(m_entries.begin() + static_cast<PtrDiff>(position));
+  adopt();
+  rebuild_index();
+  return *this;
+}
+
+
+ObjectStorage&
+ObjectStorage::clear()
+{
+  m_hash.invalidate();
+  m_entries.clear();
+  m_index.clear();
+  return *this;
+}
+
+
+ObjectStorage&
+ObjectStorage::reserve(size_t size)
 {
-  return m_map.at(key);
+  auto previous = m_entries.data();
+  m_entries.reserve(size);
+  if (m_entries.data() != previous)
+  {
+    adopt();
+  }
+
+  return *this;
 }
 
+
 Bool
-DataStorage<SerializedType::Object>::has_key(const String& key) const
+ObjectStorage::empty() const
 {
-  return m_map.find(key) != m_map.end();
+  return m_entries.empty();
 }
 
 
 size_t ObjectStorage::size() const
 {
-  return m_map.size();
+  return m_entries.size();
+}
+
+
+UInt64
+ObjectStorage::hash() const
+{
+  if (auto cached = m_hash.get())
+  {
+    return cached;
+  }
+
+  // Members are hashed on their own and summed, which gives the same hash for any order of the same members
+  UInt64 sum = 0;
+  for (const auto& [key, data]: m_entries)
+  {
+    sum += SerializedHash::mix(std::hash<StringView>{}(key) + SerializedHash::mix(data.hash()));
+  }
+
+  auto value = SerializedHash::mix(SerializedHash::mix(static_cast<UInt64>(SerializedType::Object) + 1) + sum);
+  value      = value ? value : 1;
+  m_hash.store(value);
+  return value;
+}
+
+
+Bool
+ObjectStorage::operator==(const ObjectStorage& other) const
+{
+  if (this == &other)
+  {
+    return true;
+  }
+
+  if (m_entries.size() != other.m_entries.size())
+  {
+    return false;
+  }
+
+  auto hash = m_hash.get(), other_hash = other.m_hash.get();
+  if (hash && other_hash && hash != other_hash)
+  {
+    return false;
+  }
+
+  // Keys are unique on both sides, so with equal sizes every key found in the other object means the key sets match
+  for (const auto& [key, data]: m_entries)
+  {
+    auto other_data = other.find(key);
+    if (!other_data || *other_data != data)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+size_t
+ObjectStorage::find_position(StringView key) const
+{
+  // Small objects are scanned without looking at the hash, there is no need to compute it
+  return find_position(key, m_index.empty() ? 0 : key_hash(key));
+}
+
+
+size_t
+ObjectStorage::find_position(StringView key, UInt32 hash) const
+{
+  if (!m_index.empty())
+  {
+    return find_indexed(key, hash);
+  }
+
+  for (size_t i = 0; i < m_entries.size(); ++i)
+  {
+    if (m_entries[i].first == key)
+    {
+      return i;
+    }
+  }
+
+  return npos;
+}
+
+
+size_t
+ObjectStorage::find_indexed(StringView key, UInt32 hash) const
+{
+  auto mask = m_index.size() - 1;
+  for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+  {
+    const auto& entry = m_index[slot];
+    if (entry.position == 0)
+    {
+      return npos;
+    }
+
+    if (entry.hash == hash && m_entries[entry.position - 1].first == key)
+    {
+      return entry.position - 1;
+    }
+  }
+}
+
+
+Void
+ObjectStorage::rebuild_index()
+{
+  m_index.clear();
+  if (m_entries.size() <= index_threshold)
+  {
+    return;
+  }
+
+  // Keep the table at most half full so that probe sequences stay short
+  m_index.resize(std::bit_ceil(m_entries.size() * 2));
+  for (size_t i = 0; i < m_entries.size(); ++i)
+  {
+    insert_index(i, key_hash(m_entries[i].first));
+  }
+}
+
+
+Void
+ObjectStorage::resize_index(size_t capacity)
+{
+  auto previous = std::exchange(m_index, DArray<Slot>(capacity));
+  auto mask     = m_index.size() - 1;
+
+  for (const auto& entry: previous)
+  {
+    if (entry.position == 0)
+    {
+      continue;
+    }
+
+    auto slot = entry.hash & mask;
+    while (m_index[slot].position != 0)
+    {
+      slot = (slot + 1) & mask;
+    }
+
+    m_index[slot] = entry;
+  }
+}
+
+
+Void
+ObjectStorage::insert_index(size_t position, UInt32 hash)
+{
+  if (m_entries.size() * 2 > m_index.size())
+  {
+    resize_index(m_index.size() * 2);
+  }
+
+  auto mask = m_index.size() - 1;
+  auto slot = hash & mask;
+  while (m_index[slot].position != 0)
+  {
+    slot = (slot + 1) & mask;
+  }
+
+  m_index[slot] = {static_cast<UInt32>(position + 1), hash};
+}
+
+
+Void
+ObjectStorage::adopt(SerializedData& data) noexcept
+{
+  data.m_parent = &m_hash;
+  data.attach();
+}
+
+
+Void
+ObjectStorage::adopt() noexcept
+{
+  for (auto& [key, data]: m_entries)
+  {
+    adopt(data);
+  }
+}
+
+
+Void
+ObjectStorage::adopt_appended(const Entry* previous) noexcept
+{
+  if (m_entries.data() != previous)
+  {
+    adopt();
+  }
+  else
+  {
+    adopt(m_entries.back().second);
+  }
 }
 } // namespace setsugen
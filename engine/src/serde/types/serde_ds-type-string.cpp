@@ -13,7 +13,7 @@ DataStorage<SerializedType::String>::DataStorage(const String &value)
 
 
 DataStorage<SerializedType::String>::DataStorage(String &&value)
-    : m_value{value}
+    : m_value{std::move(value)}
 {}
 
 
@@ -62,9 +62,16 @@ DataStorage<SerializedType::String>::operator!=(const DataStorage &other) const
 }
 
 
-String
+const String &
 DataStorage<SerializedType::String>::value() const noexcept
 {
     return m_value;
 }
+
+
+StringView
+DataStorage<SerializedType::String>::view() const noexcept
+{
+    return m_value;
+}
 } // namespace setsugen
@@ -0,0 +1,150 @@
+#include "../test.hpp"
+
+#include <setsugen/async.h>
+
+Task<Int32>
+add_on(WorkStealingExecutor& executor, Int32 a, Int32 b)
+{
+  co_await executor.schedule();
+  co_return a + b;
+}
+
+Task<Int32>
+sum_twice(WorkStealingExecutor& executor, Int32 value)
+{
+  auto first  = co_await add_on(executor, value, value);
+  auto second = co_await add_on(executor, first, value);
+  co_return second;
+}
+
+Task<>
+fail_on(WorkStealingExecutor& executor)
+{
+  co_await executor.schedule();
+  throw InvalidArgumentException("Task failed");
+}
+
+TEST(Async, TaskRunsOnExecutor)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  auto caller = std::this_thread::get_id();
+  auto worker = sync_wait(
+      [](WorkStealingExecutor& executor) -> Task<std::thread::id>
+      {
+        co_await executor.schedule();
+        co_return std::this_thread::get_id();
+      }(*executor));
+
+  EXPECT_NE(worker, caller);
+  EXPECT_EQ(sync_wait(sum_twice(*executor, 3)), 9);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Async, ExceptionsPropagate)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  EXPECT_THROW(sync_wait(fail_on(*executor)), InvalidArgumentException);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Async, ScheduleOnStoppedExecutorThrows)
+{
+  auto executor = WorkStealingExecutor::create(2);
+
+  EXPECT_THROW(sync_wait(add_on(*executor, 1, 2)), InvalidStateException);
+}
+
+TEST(Async, SpawnStartsEagerly)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  Atomic<Bool> started{false};
+  auto         future = spawn(*executor, [&started] { started = true; return 5; });
+
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(sync_wait(
+                [](AsyncFuture<Int32> future) -> Task<Int32>
+                {
+                  auto value = co_await future;
+                  co_return value * 2;
+                }(future)),
+            10);
+
+  EXPECT_EQ(spawn(*executor, add_on(*executor, 2, 3)).get(), 5);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Async, WhenAll)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  auto [a, b, c] = sync_wait(when_all(add_on(*executor, 1, 2), sum_twice(*executor, 2),
+                                      [](WorkStealingExecutor& executor) -> Task<>
+                                      { co_await executor.schedule(); }(*executor)));
+  EXPECT_EQ(a, 3);
+  EXPECT_EQ(b, 6);
+  EXPECT_EQ(c, std::monostate{});
+
+  DArray<Task<Int32>> tasks;
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    tasks.emplace_back(add_on(*executor, i, 1));
+  }
+
+  auto results = sync_wait(when_all(std::move(tasks)));
+  ASSERT_EQ(results.size(), 100);
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(results[i], i + 1);
+  }
+
+  EXPECT_THROW(sync_wait(when_all(add_on(*executor, 1, 2), fail_on(*executor))), InvalidArgumentException);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Async, WhenAny)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  std::promise<Void> release;
+  auto               released = release.get_future().share();
+
+  auto slow = [](WorkStealingExecutor& executor, std::shared_future<Void> released) -> Task<Int32>
+  {
+    co_await executor.schedule();
+    released.wait();
+    co_return 1;
+  };
+
+  auto result = sync_wait(when_any(slow(*executor, released), add_on(*executor, 20, 22)));
+  EXPECT_EQ(result.index, 1);
+  EXPECT_EQ(result.value, 42);
+
+  release.set_value();
+
+  EXPECT_THROW(sync_wait(when_any(DArray<Task<Int32>>{})), InvalidArgumentException);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST_MAIN()
@@ -0,0 +1,88 @@
+#include "../test.hpp"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <setsugen/conf.h>
+
+static Configuration
+load_sample()
+{
+  SerializedData data = {
+      {"window", {{"width", 1280}, {"height", 720}, {"title", "setsugen"}}},
+      {"audio", {{"volume", 0.5}}},
+  };
+
+  return ConfigurationLoader()
+      .set_default("logging.level", "info")
+      .set_override("window.vsync", true)
+      .add_source<SerializedConfigurationSource>(data)
+      .load();
+}
+
+TEST(Configuration, ReadsPaths)
+{
+  auto config = load_sample();
+
+  EXPECT_EQ(config.get_int("window.width", {}), 1280);
+  EXPECT_EQ(config.get_int("/window/height", {}), 720);
+  EXPECT_EQ(config.get_string("window.title", {}), "setsugen");
+  EXPECT_EQ(config.get_double("audio.volume", {}), 0.5);
+  EXPECT_EQ(config.get_string("logging.level", {}), "info");
+  EXPECT_EQ(config.get_child("window").get_int("width", {}), 1280);
+
+  SerializedPath width{"window.width"};
+  EXPECT_EQ(config.get_long(width, {}), 1280);
+}
+
+TEST(Configuration, MissingKeys)
+{
+  auto config = load_sample();
+
+  EXPECT_EQ(config.get_int("window.depth", 32), 32);
+  EXPECT_EQ(config.get_int("window.title", 7), 7);
+  EXPECT_THROW(config.get_int("window.depth", {}), InvalidArgumentException);
+  EXPECT_THROW(config.get_child("missing"), InvalidArgumentException);
+
+  // Reads must not create the keys they looked for
+  EXPECT_EQ(config.get_int("window.depth", 32), 32);
+  EXPECT_THROW(config.get_child("window.depth"), InvalidArgumentException);
+}
+
+TEST(Configuration, SourcesAreLayered)
+{
+  SerializedData base = {
+      {"window", {{"width", 1280}, {"height", 720}}},
+      {"audio", {{"volume", 0.5}}},
+  };
+  SerializedData user = {
+      {"window", {{"width", 1920}}},
+      {"audio", nullptr},
+  };
+
+  auto config = ConfigurationLoader()
+                    .set_default("window.title", "setsugen")
+                    .add_source<SerializedConfigurationSource>(base)
+                    .add_source<SerializedConfigurationSource>(user)
+                    .load();
+
+  // A later source only overrides the keys it sets and null removes a key
+  EXPECT_EQ(config.get_int("window.width", {}), 1920);
+  EXPECT_EQ(config.get_int("window.height", {}), 720);
+  EXPECT_EQ(config.get_string("window.title", {}), "setsugen");
+  EXPECT_THROW(config.get_child("audio"), InvalidArgumentException);
+}
+
+TEST(Configuration, LoadsFiles)
+{
+  auto path = (std::filesystem::temp_directory_path() / "setsugen-config.json").string();
+  std::ofstream{path} << R"({"window": {"width": 1920, "title": "from file"}})";
+
+  auto config = ConfigurationLoader().add_source<FileConfigurationSource>(path).load();
+  EXPECT_EQ(config.get_int("window.width", {}), 1920);
+  EXPECT_EQ(config.get_string("window.title", {}), "from file");
+
+  auto missing = (std::filesystem::temp_directory_path() / "setsugen-missing.json").string();
+  EXPECT_THROW(ConfigurationLoader().add_source<FileConfigurationSource>(missing).load(), FileNotFoundException);
+}
+
+TEST_MAIN()
@@ -0,0 +1,582 @@
+#include "../test.hpp"
+
+#include <setsugen/executor.h>
+
+#include <numeric>
+
+TEST(WorkStealingExecutor, SubmitAndWait)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  auto future = executor->submit([](Int32 a, Int32 b) { return a + b; }, 20, 22);
+  EXPECT_EQ(future.get(), 42);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(WorkStealingExecutor, ManyTasks)
+{
+  constexpr Int32 count = 10000;
+
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  Atomic<Int32>             counter{0};
+  DArray<std::future<Void>> futures;
+  futures.reserve(count);
+  for (Int32 i = 0; i < count; ++i)
+  {
+    futures.push_back(executor->submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); }));
+  }
+
+  for (auto& future: futures)
+  {
+    future.get();
+  }
+
+  EXPECT_EQ(counter.load(), count);
+  EXPECT_TRUE(executor->is_queue_empty());
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(WorkStealingExecutor, NestedSubmit)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  Atomic<Int32> counter{0};
+  auto          outer = executor->submit(
+      [&]
+      {
+        DArray<std::future<Void>> inner;
+        for (Int32 i = 0; i < 100; ++i)
+        {
+          inner.push_back(executor->submit([&counter] { counter.fetch_add(1); }));
+        }
+        return inner;
+      });
+
+  for (auto& future: outer.get())
+  {
+    future.get();
+  }
+
+  EXPECT_EQ(counter.load(), 100);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(WorkStealingExecutor, SubmitAfterStop)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+  executor->stop();
+  executor->join();
+
+  auto future = executor->submit([] { return 1; });
+  EXPECT_THROW(future.get(), InvalidStateException);
+}
+
+TEST(WorkStealingExecutor, SubmitDetached)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  std::promise<Int32> promise;
+  auto                future = promise.get_future();
+  executor->submit_detached([&promise](Int32 value) { promise.set_value(value); }, 7);
+  EXPECT_EQ(future.get(), 7);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(CachedThreadPoolExecutor, BurstLoad)
+{
+  using Clock = std::chrono::steady_clock;
+
+  constexpr Int32 max_threads = 16;
+  constexpr Int32 num_tasks   = 64;
+  constexpr auto  task_time   = std::chrono::milliseconds(20);
+
+  auto executor = CachedThreadPoolExecutor::create(max_threads, std::chrono::milliseconds(50));
+  executor->start();
+
+  DArray<std::future<Clock::duration>> futures;
+  for (Int32 i = 0; i < num_tasks; ++i)
+  {
+    futures.emplace_back(executor->submit(
+        [task_time](Clock::time_point submitted)
+        {
+          auto latency = Clock::now() - submitted;
+          std::this_thread::sleep_for(task_time);
+          return latency;
+        },
+        Clock::now()));
+  }
+
+  Clock::duration worst{0};
+  for (auto& future: futures)
+  {
+    worst = std::max(worst, future.get());
+  }
+
+  // The burst runs in num_tasks / max_threads waves, no task waits much longer than the waves before it
+  EXPECT_LT(worst, task_time * (num_tasks / max_threads) + std::chrono::milliseconds(200));
+  EXPECT_LE(executor->get_peak_threads(), max_threads);
+  EXPECT_GT(executor->get_peak_threads(), 1);
+
+  // Idle threads are reaped once the burst is over
+  auto deadline = Clock::now() + std::chrono::seconds(5);
+  while (executor->get_live_threads() > 0 && Clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(executor->get_live_threads(), 0);
+  EXPECT_EQ(executor->get_idle_threads(), 0);
+
+  // The pool grows again for the next burst
+  EXPECT_EQ(executor->submit([] { return 42; }).get(), 42);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(CachedThreadPoolExecutor, ReusesIdleThreads)
+{
+  auto executor = CachedThreadPoolExecutor::create(8);
+  executor->start();
+
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(executor->submit([](Int32 value) { return value * 2; }, i).get(), i * 2);
+
+    // Let the thread go idle, the next task is then handed to it instead of a new thread
+    while (executor->get_idle_threads() == 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  EXPECT_EQ(executor->get_peak_threads(), 1);
+
+  executor->stop();
+  executor->join();
+  EXPECT_EQ(executor->get_live_threads(), 0);
+}
+
+TEST(CachedThreadPoolExecutor, SubmitAfterStop)
+{
+  auto executor = CachedThreadPoolExecutor::create();
+  executor->start();
+  executor->stop();
+  executor->join();
+
+  auto future = executor->submit([] { return 1; });
+  EXPECT_THROW(future.get(), InvalidStateException);
+}
+
+template<class E>
+DArray<TaskPriority>
+run_lanes(E& executor)
+{
+  // Keep the only worker busy until every lane has queued tasks, then record the order in which they run
+  std::promise<Void>   gate;
+  auto                 opened = gate.get_future().share();
+  Mutex                mutex;
+  DArray<TaskPriority> order;
+
+  auto blocker = executor.submit([opened] { opened.wait(); });
+
+  DArray<std::future<Void>> futures;
+  for (auto priority: {TaskPriority::Background, TaskPriority::Normal, TaskPriority::Critical})
+  {
+    for (Int32 i = 0; i < 4; ++i)
+    {
+      futures.emplace_back(executor.submit(priority,
+                                           [&mutex, &order, priority]
+                                           {
+                                             Lock lock(mutex);
+                                             order.push_back(priority);
+                                           }));
+    }
+  }
+
+  gate.set_value();
+  blocker.get();
+  for (auto& future: futures)
+  {
+    future.get();
+  }
+
+  return order;
+}
+
+TEST(TaskPriority, HigherLanesRunFirst)
+{
+  auto expected = DArray<TaskPriority>(4, TaskPriority::Critical);
+  expected.insert(expected.end(), 4, TaskPriority::Normal);
+  expected.insert(expected.end(), 4, TaskPriority::Background);
+
+  auto work_stealing = WorkStealingExecutor::create(1);
+  work_stealing->start();
+  EXPECT_EQ(run_lanes(*work_stealing), expected);
+  work_stealing->stop();
+  work_stealing->join();
+
+  auto cached = CachedThreadPoolExecutor::create(1);
+  cached->start();
+  EXPECT_EQ(run_lanes(*cached), expected);
+  cached->stop();
+  cached->join();
+
+  auto fixed = FixedThreadPoolExecutor::create(1);
+  fixed->start();
+  EXPECT_EQ(run_lanes(*fixed), expected);
+  fixed->stop();
+  fixed->join();
+
+  auto single = SingleThreadExecutor::create();
+  single->start();
+  EXPECT_EQ(run_lanes(*single), expected);
+  single->stop();
+  single->join();
+}
+
+TEST(TaskPriority, LateTasksAreCounted)
+{
+  using Clock = std::chrono::steady_clock;
+
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  executor->submit(TaskPriority::Critical, Clock::now() + std::chrono::hours(1), [] {}).get();
+  EXPECT_EQ(executor->get_late_tasks(), 0);
+
+  executor->submit(TaskPriority::Critical, Clock::now() - std::chrono::milliseconds(1), [] {}).get();
+  EXPECT_EQ(executor->get_late_tasks(), 1);
+
+  auto deadline = Clock::now() + std::chrono::milliseconds(5);
+  auto result   = executor->submit(
+      TaskPriority::Normal, deadline,
+      [](Int32 value)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return value;
+      },
+      3);
+  EXPECT_EQ(result.get(), 3);
+  EXPECT_EQ(executor->get_late_tasks(), 2);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(ExecutorOptions, RejectsUnknownCpu)
+{
+  EXPECT_THROW(WorkStealingExecutor(ExecutorOptions{.cpus = {1 << 20}}), InvalidArgumentException);
+  EXPECT_THROW(FixedThreadPoolExecutor(ExecutorOptions{.cpus = {-1}}), InvalidArgumentException);
+}
+
+TEST(ExecutorOptions, NumaAwarePoolRunsTasks)
+{
+  auto executor = WorkStealingExecutor::create(ExecutorOptions{.num_threads = 4, .numa_aware = true});
+  executor->start();
+
+  EXPECT_GE(executor->get_num_nodes(), 1);
+  EXPECT_LE(executor->get_num_nodes(), 4);
+
+  Atomic<Int32> counter{0};
+  parallel_for(*executor, 0, 1000, 10, [&counter](Int32) { counter.fetch_add(1); });
+  EXPECT_EQ(counter, 1000);
+
+  executor->stop();
+  executor->join();
+}
+
+#ifdef SETSUGENE_LINUX
+TEST(ExecutorOptions, NamesAndPinsWorkers)
+{
+  auto executor = WorkStealingExecutor::create(
+      ExecutorOptions{.num_threads = 2, .thread_name = "worker", .cpus = {0}, .pin_threads = true});
+  executor->start();
+
+  auto [name, cpu] = executor
+                         ->submit(
+                             []
+                             {
+                               char buffer[16] = {};
+                               pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+                               return std::make_pair(String(buffer), sched_getcpu());
+                             })
+                         .get();
+
+  EXPECT_TRUE(name == "worker-0" || name == "worker-1");
+  EXPECT_EQ(cpu, 0);
+
+  executor->stop();
+  executor->join();
+}
+#endif
+
+TEST(Parallel, ForVisitsEveryIndexOnce)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  DArray<Atomic<Int32>> visits(10'007);
+  parallel_for(*executor, 0, 10'007, 64, [&](Int32 i) { visits[i].fetch_add(1); });
+
+  for (auto& visit: visits)
+  {
+    EXPECT_EQ(visit.load(), 1);
+  }
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Parallel, NestedForDoesNotDeadlock)
+{
+  auto executor = FixedThreadPoolExecutor::create(1);
+  executor->start();
+
+  Atomic<Int32> counter{0};
+  auto          future = executor->submit(
+      [&]
+      {
+        parallel_for(*executor, 0, 1000, 10, [&](Int32) { counter.fetch_add(1); });
+      });
+  future.get();
+
+  EXPECT_EQ(counter.load(), 1000);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Parallel, ReduceAndTransform)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  auto sum = parallel_reduce(
+      *executor, Int64{1}, Int64{100'001}, Int64{256}, Int64{0}, [](Int64 i) { return i; }, std::plus<Int64>{});
+  EXPECT_EQ(sum, 5'000'050'000);
+
+  DArray<Int32> input(1000);
+  std::iota(input.begin(), input.end(), 0);
+  DArray<Int32> output(input.size());
+  parallel_transform(*executor, input, output.begin(), 32, [](Int32 x) { return x * 2; });
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    EXPECT_EQ(output[i], input[i] * 2);
+  }
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(Parallel, ForRethrows)
+{
+  auto executor = WorkStealingExecutor::create(2);
+  executor->start();
+
+  EXPECT_THROW(parallel_for(*executor, 0, 100, 1,
+                            [](Int32 i)
+                            {
+                              if (i == 50)
+                              {
+                                throw InvalidArgumentException("boom");
+                              }
+                            }),
+               InvalidArgumentException);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(TaskGraph, RespectsDependencies)
+{
+  auto executor = WorkStealingExecutor::create(4);
+  executor->start();
+
+  // a -> {b, c} -> d
+  Mutex         mutex;
+  DArray<Int32> order;
+  auto          record = [&](Int32 id)
+  {
+    Lock lock(mutex);
+    order.push_back(id);
+  };
+
+  TaskGraph graph;
+  auto      a = graph.add("a", [&] { record(0); });
+  auto      b = graph.add("b", [&] { record(1); });
+  auto      c = graph.add("c",
+                          [&]
+                          {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                            record(2);
+                          });
+  auto      d = graph.add("d", [&] { record(3); });
+  graph.precede(a, b).precede(a, c).precede(b, d).precede(c, d);
+
+  for (Int32 frame = 0; frame < 3; ++frame)
+  {
+    order.clear();
+    graph.run(*executor);
+
+    ASSERT_EQ(order.size(), 4);
+    EXPECT_EQ(order.front(), 0);
+    EXPECT_EQ(order.back(), 3);
+  }
+
+  auto& report = graph.last_report();
+  EXPECT_EQ(report.critical_path, (DArray<size_t>{a, c, d}));
+  EXPECT_GE(report.critical_time, 5.0);
+
+  executor->stop();
+  executor->join();
+}
+
+TEST(TaskGraph, ThrowsWhenExecutorStops)
+{
+  auto executor = SingleThreadExecutor::create();
+  executor->start();
+
+  // a stops the executor, b and its successor c are cancelled instead of leaving run waiting for them
+  Atomic<Int32> ran{0};
+  TaskGraph     graph;
+  graph.add("a",
+            [&]
+            {
+              ++ran;
+              executor->stop();
+            });
+  auto b = graph.add("b", [&] { ++ran; });
+  auto c = graph.add("c", [&] { ++ran; });
+  graph.precede(b, c);
+
+  EXPECT_THROW(graph.run(*executor), InvalidStateException);
+  EXPECT_EQ(ran.load(), 1);
+
+  executor->join();
+}
+
+TEST(TaskGraph, RejectsCycles)
+{
+  TaskGraph graph;
+  auto      a = graph.add("a", [] {});
+  auto      b = graph.add("b", [] {});
+  graph.precede(a, b).precede(b, a);
+
+  EXPECT_THROW(graph.compile(), InvalidStateException);
+}
+
+TEST(ExecutorStats, HistogramBucketsAreLogLinear)
+{
+  for (UInt64 value: {UInt64{0}, UInt64{15}, UInt64{16}, UInt64{17}, UInt64{1000}, UInt64{123456789}})
+  {
+    auto bucket = ExecutorHistogram::bucket_of(value);
+    EXPECT_LE(ExecutorHistogram::bucket_lower_bound(bucket), value);
+    EXPECT_GE(ExecutorHistogram::bucket_upper_bound(bucket), value);
+    // Every bucket is at most 1/16 of its lower bound wide
+    EXPECT_LE(ExecutorHistogram::bucket_upper_bound(bucket) - ExecutorHistogram::bucket_lower_bound(bucket),
+              ExecutorHistogram::bucket_lower_bound(bucket) / 16);
+  }
+  EXPECT_EQ(ExecutorHistogram::bucket_of(ExecutorHistogram::max_value), ExecutorHistogram::bucket_count - 1);
+
+  ExecutorHistogram histogram;
+  for (UInt64 value = 1; value <= 1000; ++value)
+  {
+    histogram.record(value);
+  }
+
+  auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.count, 1000);
+  EXPECT_EQ(snapshot.min, 1);
+  EXPECT_EQ(snapshot.max, 1000);
+  EXPECT_DOUBLE_EQ(snapshot.mean(), 500.5);
+  EXPECT_GE(snapshot.percentile(50), 500);
+  EXPECT_LE(snapshot.percentile(50), 500 + 500 / 16);
+  EXPECT_EQ(snapshot.percentile(100), 1000);
+}
+
+TEST(ExecutorStats, CountsTasksAndTimes)
+{
+  auto executor = FixedThreadPoolExecutor::create(2);
+  executor->start();
+
+  DArray<std::future<Void>> futures;
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    futures.push_back(executor->submit([] { std::this_thread::sleep_for(std::chrono::microseconds(10)); }));
+  }
+  for (auto& future: futures)
+  {
+    future.get();
+  }
+
+  // A task is counted as completed after its future is ready, joining the workers makes the counters final
+  executor->stop();
+  executor->join();
+
+  auto stats = executor->stats();
+  EXPECT_EQ(stats.submitted, 100);
+  EXPECT_EQ(stats.completed, 100);
+  EXPECT_EQ(stats.cancelled, 0);
+  EXPECT_EQ(stats.in_flight, 0);
+  EXPECT_EQ(stats.queue_depth.count, 100);
+  EXPECT_EQ(stats.wait_time.count, 100);
+  EXPECT_EQ(stats.run_time.count, 100);
+  EXPECT_GE(stats.run_time.min, 10000);
+
+  EXPECT_EQ(executor->submit([] {}).wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_EQ(executor->stats().cancelled, 1);
+
+  executor->reset_stats();
+  executor->set_timing_enabled(false);
+  executor->start();
+  executor->submit([] {}).get();
+  executor->stop();
+  executor->join();
+
+  stats = executor->stats();
+  EXPECT_EQ(stats.submitted, 1);
+  EXPECT_EQ(stats.completed, 1);
+  EXPECT_EQ(stats.run_time.count, 0);
+  EXPECT_EQ(stats.wait_time.count, 0);
+}
+
+TEST(InplaceFn, MoveOnlyCapture)
+{
+  auto value = std::make_unique<Int32>(5);
+
+  InplaceFn<Int32(Int32)> fn = [value = std::move(value)](Int32 x) { return *value + x; };
+  InplaceFn<Int32(Int32)> moved = std::move(fn);
+
+  EXPECT_FALSE(fn);
+  EXPECT_TRUE(moved);
+  EXPECT_EQ(moved(1), 6);
+}
+
+TEST(InplaceFn, LargeCallableFallsBackToHeap)
+{
+  Array<Int64, 32> payload{};
+  payload[31] = 9;
+
+  auto large = [payload] { return payload[31]; };
+  static_assert(!InplaceFn<Int64()>::stored_inline<decltype(large)>);
+  static_assert(InplaceFn<Int64()>::stored_inline<decltype([] { return Int64{0}; })>);
+
+  InplaceFn<Int64()> fn = large;
+  EXPECT_EQ(fn(), 9);
+}
+
+TEST_MAIN()
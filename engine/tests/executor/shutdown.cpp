@@ -0,0 +1,271 @@
+#include "../test.hpp"
+
+#include <setsugen/executor.h>
+
+// Producers keep submitting while the executor is stopped under them. Every future has to resolve, either with the
+// value of a task which ran or with the exception of a task which was cancelled, and nothing may be left behind
+template<class E>
+Void
+race_stop(E& executor)
+{
+  constexpr Int32 producers    = 4;
+  constexpr Int32 per_producer = 2000;
+
+  executor.start();
+
+  Atomic<Int32>                                ran{0};
+  Array<DArray<std::future<Int32>>, producers> futures;
+  DArray<Thread>                               threads;
+  for (Int32 p = 0; p < producers; ++p)
+  {
+    threads.emplace_back(
+        [&executor, &ran, &futures, p]
+        {
+          for (Int32 i = 0; i < per_producer; ++i)
+          {
+            futures[p].push_back(executor.submit(
+                [&ran, i]
+                {
+                  ran.fetch_add(1, std::memory_order_relaxed);
+                  return i;
+                }));
+          }
+        });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  executor.stop();
+
+  for (auto& thread: threads)
+  {
+    thread.join();
+  }
+  executor.join();
+
+  Int32 resolved  = 0;
+  Int32 cancelled = 0;
+  for (auto& lane: futures)
+  {
+    for (Int32 i = 0; i < static_cast<Int32>(lane.size()); ++i)
+    {
+      try
+      {
+        EXPECT_EQ(lane[i].get(), i);
+        ++resolved;
+      }
+      catch (const InvalidStateException&)
+      {
+        ++cancelled;
+      }
+    }
+  }
+
+  EXPECT_EQ(resolved, ran.load());
+  EXPECT_EQ(resolved + cancelled, producers * per_producer);
+  EXPECT_TRUE(executor.is_queue_empty());
+}
+
+TEST(ExecutorShutdown, StopRacesProducers)
+{
+  for (Int32 round = 0; round < 5; ++round)
+  {
+    auto fixed = FixedThreadPoolExecutor::create(4);
+    race_stop(*fixed);
+
+    auto work_stealing = WorkStealingExecutor::create(4);
+    race_stop(*work_stealing);
+
+    auto single = SingleThreadExecutor::create();
+    race_stop(*single);
+
+    auto cached = CachedThreadPoolExecutor::create(4);
+    race_stop(*cached);
+  }
+}
+
+template<class E>
+Void
+force_stop_signals_token(E& executor)
+{
+  executor.start();
+
+  std::promise<Void> started;
+  auto               running = started.get_future();
+  auto               future  = executor.submit(
+      [&executor, &started]
+      {
+        auto token = executor.get_stop_token();
+        started.set_value();
+        while (!token.stop_requested())
+        {
+          std::this_thread::yield();
+        }
+        return true;
+      });
+
+  running.wait();
+  EXPECT_FALSE(executor.get_stop_token().stop_requested());
+
+  executor.force_stop();
+  executor.join();
+  EXPECT_TRUE(future.get());
+
+  // A restarted executor hands out a fresh token
+  executor.start();
+  EXPECT_FALSE(executor.get_stop_token().stop_requested());
+  EXPECT_EQ(executor.submit([] { return 7; }).get(), 7);
+  executor.stop();
+  executor.join();
+}
+
+TEST(ExecutorShutdown, ForceStopSignalsRunningTasks)
+{
+  auto fixed = FixedThreadPoolExecutor::create(2);
+  force_stop_signals_token(*fixed);
+
+  auto work_stealing = WorkStealingExecutor::create(2);
+  force_stop_signals_token(*work_stealing);
+
+  auto single = SingleThreadExecutor::create();
+  force_stop_signals_token(*single);
+
+  auto cached = CachedThreadPoolExecutor::create(2);
+  force_stop_signals_token(*cached);
+}
+
+template<class E>
+Void
+drain_finishes_queued_tasks(E& executor)
+{
+  executor.start();
+
+  Atomic<Int32>             counter{0};
+  DArray<std::future<Void>> futures;
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    futures.push_back(executor.submit(
+        [&counter]
+        {
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+          counter.fetch_add(1, std::memory_order_relaxed);
+        }));
+  }
+
+  // The wait is woken up by the last task leaving the queue, not by the timeout
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(executor.drain_and_stop(std::chrono::seconds(10)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  executor.join();
+
+  for (auto& future: futures)
+  {
+    EXPECT_NO_THROW(future.get());
+  }
+  EXPECT_EQ(counter.load(), 100);
+  EXPECT_TRUE(executor.is_stopped());
+}
+
+TEST(ExecutorShutdown, DrainAndStopFinishesQueuedTasks)
+{
+  auto fixed = FixedThreadPoolExecutor::create(2);
+  drain_finishes_queued_tasks(*fixed);
+
+  auto work_stealing = WorkStealingExecutor::create(2);
+  drain_finishes_queued_tasks(*work_stealing);
+
+  auto single = SingleThreadExecutor::create();
+  drain_finishes_queued_tasks(*single);
+
+  auto cached = CachedThreadPoolExecutor::create(2);
+  drain_finishes_queued_tasks(*cached);
+}
+
+TEST(ExecutorShutdown, DrainAndStopTimesOut)
+{
+  auto executor = SingleThreadExecutor::create();
+  executor->start();
+
+  // The only thread is held until the stop is requested, so the queued tasks cannot drain in time
+  auto blocker = executor->submit(
+      [&executor]
+      {
+        auto token = executor->get_stop_token();
+        while (!token.stop_requested())
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      });
+
+  DArray<std::future<Int32>> queued;
+  for (Int32 i = 0; i < 10; ++i)
+  {
+    queued.push_back(executor->submit([i] { return i; }));
+  }
+
+  EXPECT_FALSE(executor->drain_and_stop(std::chrono::milliseconds(20)));
+  executor->join();
+
+  EXPECT_NO_THROW(blocker.get());
+  for (auto& future: queued)
+  {
+    EXPECT_THROW(future.get(), InvalidStateException);
+  }
+}
+
+TEST(SingleThreadExecutor, ConcurrentSubmitters)
+{
+  constexpr Int32 producers    = 4;
+  constexpr Int32 per_producer = 1000;
+
+  auto executor = SingleThreadExecutor::create();
+  executor->start();
+
+  // Tasks are never run concurrently, so the plain counter and thread id are only touched by the executor thread
+  Int32                                       counter = 0;
+  std::thread::id                             worker;
+  Bool                                        same_thread = true;
+  Array<DArray<std::future<Void>>, producers> futures;
+  DArray<Thread>                              threads;
+  for (Int32 p = 0; p < producers; ++p)
+  {
+    threads.emplace_back(
+        [&, p]
+        {
+          for (Int32 i = 0; i < per_producer; ++i)
+          {
+            futures[p].push_back(executor->submit(
+                [&]
+                {
+                  if (worker == std::thread::id{})
+                  {
+                    worker = std::this_thread::get_id();
+                  }
+                  same_thread = same_thread && worker == std::this_thread::get_id();
+                  ++counter;
+                }));
+          }
+        });
+  }
+
+  for (auto& thread: threads)
+  {
+    thread.join();
+  }
+
+  for (auto& lane: futures)
+  {
+    for (auto& future: lane)
+    {
+      future.get();
+    }
+  }
+
+  EXPECT_EQ(counter, producers * per_producer);
+  EXPECT_TRUE(same_thread);
+  EXPECT_NE(worker, std::this_thread::get_id());
+
+  executor->stop();
+  executor->join();
+}
+
+TEST_MAIN()
@@ -37,3 +37,61 @@ struct Family
 };
 
 DECLARE_REFLECTION(Family, father, mother, children);
+
+struct Prefab
+{
+  String         name;
+  Bool           visible;
+  Float32        mass;
+  DArray<Int32>  layers;
+  DArray<Person> owners;
+};
+
+DECLARE_REFLECTION(Prefab, name, visible, mass, layers, owners);
+
+TEST(Reflection, ReadsStraightFromParserEvents)
+{
+  StringStream ss{R"({
+    "name": "crate",
+    "unknown": {"nested": [1, {"deep": true}], "more": "skipped"},
+    "visible": true,
+    "mass": 2,
+    "layers": [1, 4, 9],
+    "owners": [{"name": "John", "age": 30, "extra": null}, {"age": 28, "name": "Jane"}]
+  })"};
+
+  Prefab prefab{};
+  prefab.layers = {7};
+  ReflectionReader reader{prefab};
+  Json{}.deserialize(ss, reader);
+
+  EXPECT_EQ(prefab.name, "crate");
+  EXPECT_TRUE(prefab.visible);
+  EXPECT_EQ(prefab.mass, 2.0f);
+  EXPECT_EQ(prefab.layers, (DArray<Int32>{1, 4, 9}));
+  ASSERT_EQ(prefab.owners.size(), 2);
+  EXPECT_EQ(prefab.owners[0].name, "John");
+  EXPECT_EQ(prefab.owners[0].age, 30);
+  EXPECT_EQ(prefab.owners[1].name, "Jane");
+  EXPECT_EQ(prefab.owners[1].age, 28);
+}
+
+TEST(Reflection, ReaderRejectsMismatchedTypes)
+{
+  Prefab prefab;
+
+  {
+    ReflectionReader reader{prefab};
+    EXPECT_THROW(Json{}.deserialize(StringView{R"({"mass": "heavy"})"}, reader), InvalidFormatException);
+  }
+
+  {
+    ReflectionReader reader{prefab};
+    EXPECT_THROW(Json{}.deserialize(StringView{R"({"owners": {"name": "John"}})"}, reader), InvalidFormatException);
+  }
+
+  {
+    ReflectionReader reader{prefab};
+    EXPECT_THROW(Json{}.deserialize(StringView{R"([1, 2])"}, reader), InvalidFormatException);
+  }
+}
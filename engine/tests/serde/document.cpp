@@ -0,0 +1,205 @@
+#include "../test.hpp"
+
+#include <gtest/gtest.h>
+#include <setsugen/serde.h>
+
+static SerializedDocument
+build_sample()
+{
+  SerializedDocument document;
+  DocumentBuilder    builder{document};
+
+  builder.begin_object();
+  builder.key("name");
+  builder.string("level-01");
+  builder.key("size");
+  builder.integer(128);
+  builder.key("gravity");
+  builder.floating(9.81);
+  builder.key("visible");
+  builder.boolean(true);
+  builder.key("parent");
+  builder.null();
+  builder.key("entities");
+  builder.begin_array();
+  for (Int64 i = 0; i < 3; ++i)
+  {
+    builder.begin_object();
+    builder.key("id");
+    builder.integer(i);
+    builder.key("tags");
+    builder.begin_array();
+    builder.end_array();
+    builder.end_object();
+  }
+  builder.end_array();
+  builder.end_object();
+  builder.finish();
+
+  return document;
+}
+
+TEST(SerializedDocument, EmptyDocumentIsNull)
+{
+  SerializedDocument document;
+  EXPECT_EQ(document.root().get_type(), SerializedType::Null);
+  EXPECT_FALSE(document.root());
+}
+
+TEST(SerializedDocument, BuilderCreatesNestedValues)
+{
+  auto document = build_sample();
+  auto root     = document.root();
+
+  EXPECT_EQ(root.get_type(), SerializedType::Object);
+  EXPECT_EQ(root.size(), 6);
+  EXPECT_EQ(root["name"].get_string(), "level-01");
+  EXPECT_EQ(root["size"].get_integer(), 128);
+  EXPECT_EQ(root["gravity"].get_float(), 9.81);
+  EXPECT_TRUE(root["visible"].get_bool());
+  EXPECT_EQ(root["parent"].get_type(), SerializedType::Null);
+
+  auto entities = root["entities"].get_array();
+  EXPECT_EQ(entities.size(), 3);
+  for (Int64 i = 0; i < 3; ++i)
+  {
+    EXPECT_EQ(entities[i]["id"].get_integer(), i);
+    EXPECT_TRUE(entities[i]["tags"].get_array().empty());
+  }
+}
+
+TEST(SerializedDocument, NodesAreSixteenBytes)
+{
+  EXPECT_EQ(sizeof(DocumentNode), 16);
+  EXPECT_EQ(sizeof(DocumentView), sizeof(Void*));
+}
+
+TEST(SerializedDocument, ObjectKeepsInsertionOrder)
+{
+  auto document = build_sample();
+
+  DArray<String> keys;
+  for (auto [key, value]: document.root().get_object())
+  {
+    keys.emplace_back(key);
+  }
+
+  EXPECT_EQ(keys, (DArray<String>{"name", "size", "gravity", "visible", "parent", "entities"}));
+}
+
+TEST(SerializedDocument, RepeatedKeysAreInterned)
+{
+  auto document = build_sample();
+  auto entities = document.root()["entities"].get_array();
+
+  auto first  = (*entities[0].get_object().begin()).key;
+  auto second = (*entities[1].get_object().begin()).key;
+  EXPECT_EQ(first, "id");
+  EXPECT_EQ(first.data(), second.data());
+}
+
+TEST(SerializedDocument, LookupAndErrors)
+{
+  auto document = build_sample();
+  auto object   = document.root().get_object();
+
+  EXPECT_TRUE(object.has_key("gravity"));
+  EXPECT_FALSE(object.has_key("missing"));
+  EXPECT_TRUE(object.find("size").has_value());
+  EXPECT_FALSE(object.find("missing").has_value());
+
+  EXPECT_THROW(object["missing"], OutOfBoundsException);
+  EXPECT_THROW(document.root()["entities"][3], OutOfBoundsException);
+  EXPECT_THROW(document.root()["name"].get_integer(), InvalidOperationException);
+  EXPECT_THROW(document.root()["size"].get_array(), InvalidOperationException);
+}
+
+TEST(SerializedDocument, BuilderRejectsMisuse)
+{
+  SerializedDocument document;
+
+  {
+    DocumentBuilder builder{document};
+    builder.begin_object();
+    EXPECT_THROW(builder.integer(1), InvalidStateException);
+  }
+
+  {
+    DocumentBuilder builder{document};
+    builder.begin_array();
+    EXPECT_THROW(builder.key("key"), InvalidStateException);
+    EXPECT_THROW(builder.end_object(), InvalidStateException);
+    EXPECT_THROW(builder.finish(), InvalidStateException);
+  }
+
+  {
+    DocumentBuilder builder{document};
+    builder.integer(1);
+    EXPECT_THROW(builder.integer(2), InvalidStateException);
+  }
+
+  {
+    DocumentBuilder builder{document};
+    builder.begin_object();
+    builder.key("dangling");
+    EXPECT_THROW(builder.end_object(), InvalidStateException);
+  }
+}
+
+TEST(SerializedDocument, RoundTripsSerializedData)
+{
+  SerializedData data = {
+      {"name", "level-01"},
+      {"size", 128},
+      {"gravity", 9.81},
+      {"layers", SerializedData::array({1, 2, SerializedData::array({"nested", false})})},
+  };
+
+  auto document = SerializedDocument::from(data);
+  auto root     = document.root();
+
+  EXPECT_EQ(root.size(), 4);
+  EXPECT_EQ(root["layers"][2][0].get_string(), "nested");
+
+  auto copy = root.to_serialized();
+  EXPECT_EQ(copy.get_type(), SerializedType::Object);
+  EXPECT_EQ(copy["name"].get_string().value(), "level-01");
+  EXPECT_EQ(copy["size"].get_integer().value(), 128);
+  EXPECT_EQ(copy["gravity"].get_float().value(), 9.81);
+  EXPECT_EQ(copy["layers"][2][1].get_bool().value(), false);
+}
+
+TEST(SerializedDocument, ClearKeepsFirstChunk)
+{
+  SerializedDocument document{256};
+  DocumentBuilder    builder{document};
+
+  builder.begin_array();
+  for (Int32 i = 0; i < 1000; ++i)
+  {
+    builder.string("a string long enough to need a few chunks");
+  }
+  builder.end_array();
+  builder.finish();
+
+  EXPECT_EQ(document.root().size(), 1000);
+  EXPECT_GT(document.get_arena().get_reserved_bytes(), 256);
+
+  document.clear();
+  EXPECT_EQ(document.root().get_type(), SerializedType::Null);
+  EXPECT_EQ(document.get_arena().get_used_bytes(), 0);
+  EXPECT_EQ(document.get_arena().get_reserved_bytes(), 256);
+}
+
+TEST(SerializedDocument, MoveKeepsViewsValid)
+{
+  auto document = build_sample();
+  auto name     = document.root()["name"];
+
+  SerializedDocument moved{std::move(document)};
+  EXPECT_EQ(name.get_string(), "level-01");
+  EXPECT_EQ(moved.root()["name"].get_string(), "level-01");
+  EXPECT_EQ(document.root().get_type(), SerializedType::Null);
+}
+
+TEST_MAIN()
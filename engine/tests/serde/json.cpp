@@ -40,4 +40,319 @@ TEST(JsonSerde, Deserializer)
   EXPECT_EQ(1, 1);
 }
 
-TEST_MAIN()
\ No newline at end of file
+TEST(JsonSerde, DeserializerNestedValues)
+{
+  SerializedData data;
+  StringStream   ss{R"({"grid": [[1, 2], [3, [4.5, "five"]]], "big": 9007199254740993, "after": {"ok": true}})"};
+  data.parse<Json>(ss);
+
+  EXPECT_EQ(data["grid"].size(), 2);
+  EXPECT_EQ(data["grid"][0][1], 2);
+  EXPECT_EQ(data["grid"][1][0], 3);
+  EXPECT_EQ(data["grid"][1][1][0], 4.5);
+  EXPECT_EQ(data["grid"][1][1][1], "five");
+  EXPECT_EQ(data["big"].get_integer().value(), 9007199254740993);
+  EXPECT_EQ(data["after"]["ok"], true);
+
+  DArray<String> keys;
+  for (const auto& [key, value]: data.get_object())
+  {
+    keys.push_back(key);
+  }
+  EXPECT_EQ(keys, (DArray<String>{"grid", "big", "after"}));
+}
+
+TEST(JsonSerde, DocumentFromStream)
+{
+  SerializedDocument document;
+  StringStream       ss{sample_json};
+  document.parse<Json>(ss);
+
+  auto root = document.root();
+  EXPECT_EQ(root["firstName"].get_string(), "John");
+  EXPECT_EQ(root["age"].get_integer(), 30);
+  EXPECT_EQ(root["address"]["city"].get_string(), "Anytown");
+  EXPECT_EQ(root["phoneNumbers"][1]["number"].get_string(), "555-5678");
+  EXPECT_EQ(root["children"].size(), 0);
+  EXPECT_EQ(root["spouse"].get_type(), SerializedType::Null);
+}
+
+TEST(JsonSerde, DocumentBorrowsFromInput)
+{
+  String input = R"({"name": "plain", "escaped": "tab\there", "list": ["a", "b\"c", "d"]})";
+
+  SerializedDocument document;
+  document.parse<Json>(StringView{input});
+
+  auto is_borrowed = [&input](StringView value)
+  { return value.data() >= input.data() && value.data() < input.data() + input.size(); };
+
+  auto root = document.root();
+  EXPECT_EQ(root["name"].get_string(), "plain");
+  EXPECT_TRUE(is_borrowed(root["name"].get_string()));
+  EXPECT_EQ(root["escaped"].get_string(), "tab\there");
+  EXPECT_FALSE(is_borrowed(root["escaped"].get_string()));
+
+  auto list = root["list"];
+  EXPECT_EQ(list[0].get_string(), "a");
+  EXPECT_EQ(list[1].get_string(), "b\"c");
+  EXPECT_EQ(list[2].get_string(), "d");
+  EXPECT_TRUE(is_borrowed(list[2].get_string()));
+
+  for (auto [key, value]: root.get_object())
+  {
+    EXPECT_TRUE(is_borrowed(key));
+  }
+}
+
+// Sums the "bytes" field of every record in a log without building it
+class BytesVisitor : public SerializedVisitor
+{
+public:
+  Void on_key(StringView key) override
+  {
+    m_in_bytes = key == "bytes";
+  }
+
+  Void on_int(Int64 value) override
+  {
+    if (m_in_bytes)
+    {
+      total += value;
+    }
+    m_in_bytes = false;
+  }
+
+  Void on_object_begin() override
+  {
+    ++records;
+  }
+
+  Int64 total   = 0;
+  Int32 records = 0;
+
+private:
+  Bool m_in_bytes = false;
+};
+
+// Writes down every event it receives
+class EventRecorder : public SerializedVisitor
+{
+public:
+  Void on_null() override
+  {
+    events += "n";
+  }
+
+  Void on_bool(Bool value) override
+  {
+    events += value ? "t" : "f";
+  }
+
+  Void on_int(Int64 value) override
+  {
+    events += "i" + std::to_string(value);
+  }
+
+  Void on_float(Float64 /*value*/) override
+  {
+    events += "d";
+  }
+
+  Void on_string(StringView value) override
+  {
+    events += "s" + String(value);
+  }
+
+  Void on_key(StringView key) override
+  {
+    events += "k" + String(key);
+  }
+
+  Void on_object_begin() override
+  {
+    events += "{";
+  }
+
+  Void on_object_end() override
+  {
+    events += "}";
+  }
+
+  Void on_array_begin() override
+  {
+    events += "[";
+  }
+
+  Void on_array_end() override
+  {
+    events += "]";
+  }
+
+  String events;
+};
+
+TEST(JsonSerde, VisitorStreamsEvents)
+{
+  StringStream ss{R"([{"path": "/a", "bytes": 120}, {"path": "/b", "bytes": 30, "tags": [1, 2]}, {"bytes": 1.5}])"};
+
+  BytesVisitor visitor;
+  Json{}.deserialize(ss, visitor);
+  EXPECT_EQ(visitor.records, 3);
+  EXPECT_EQ(visitor.total, 150);
+
+  // Every event in order, through the in-memory overload
+  EventRecorder recorder;
+  Json{}.deserialize(StringView{R"({"a": [1, 2.5, "x", null, true], "b": {}})"}, recorder);
+  EXPECT_EQ(recorder.events, "{ka[i1dsxnt]kb{}}");
+}
+
+TEST(JsonSerde, VisitorRejectsIncompleteDocuments)
+{
+  SerializedVisitor visitor;
+  EXPECT_THROW(Json{}.deserialize(StringView{R"({"a": [1, 2)"}, visitor), InvalidSyntaxException);
+  EXPECT_THROW(Json{}.deserialize(StringView{R"([1] [2])"}, visitor), InvalidSyntaxException);
+}
+
+TEST(JsonSerde, DecodesStringsAndNumbers)
+{
+  EventRecorder recorder;
+  Json{}.deserialize(StringView{R"(["a\"b\\c\/\n", "\u00e9\u20ac\ud83d\ude00", -0, 9223372036854775807, -2.5E-3])"},
+                     recorder);
+  EXPECT_EQ(recorder.events, "[sa\"b\\c/\ns\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80i0i9223372036854775807d]");
+
+  // Integers past 64 bits become floats instead of being truncated
+  SerializedData data;
+  StringStream   ss{"[18446744073709551616, -9223372036854775808]"};
+  data.parse<Json>(ss);
+  EXPECT_EQ(data[0].get_type(), SerializedType::Float);
+  EXPECT_EQ(data[0].get_float().value(), 18446744073709551616.0);
+  EXPECT_EQ(data[1].get_integer().value(), std::numeric_limits<Int64>::min());
+}
+
+TEST(JsonSerde, ReadsNumbersPastFloatRange)
+{
+  // Underflow rounds to a zero that keeps its sign, overflow has no JSON value to become
+  SerializedData data;
+  Json{}.deserialize(StringView{"[1e-400, -1e-400, 0.0000000000000000000001e-310, 2.5e-320]"}, data);
+  EXPECT_EQ(data[0].get_float().value(), 0.0);
+  EXPECT_FALSE(std::signbit(data[0].get_float().value()));
+  EXPECT_EQ(data[1].get_float().value(), 0.0);
+  EXPECT_TRUE(std::signbit(data[1].get_float().value()));
+  EXPECT_EQ(data[2].get_float().value(), 0.0);
+  EXPECT_EQ(data[3].get_float().value(), 2.5e-320);
+
+  SerializedVisitor visitor;
+  for (const char* input: {"[1e400]", "[-1e400]", "[1000000000000000000000000e300]", "[0.001e312]"})
+  {
+    EXPECT_THROW(Json{}.deserialize(StringView{input}, visitor), InvalidSyntaxException) << input;
+  }
+}
+
+TEST(JsonSerde, RejectsInvalidSyntax)
+{
+  SerializedVisitor visitor;
+  for (const char* input: {"", "  ", "[1,]", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "[01]", "[1.]", "[.5]", "[+1]",
+                           "[1e]", "[tru]", "[nulls]", "[\"a\"b]", "[1 2]", "[\"a]", "[\"\\x\"]", "[\"\\u12\"]",
+                           "[\"\\ud800\"]", "[\"a\tb\"]", "[1e400]", "[1}", "{\"a\": 1]", "]", "nan"})
+  {
+    EXPECT_THROW(Json{}.deserialize(StringView{input}, visitor), InvalidSyntaxException) << input;
+  }
+}
+
+TEST(JsonSerde, ParsesAcrossBlocks)
+{
+  // Escapes, strings and numbers straddling the 64 byte blocks and the windows of the structural scan
+  StringStream input;
+  input << "[";
+  for (Int32 i = 0; i < 5000; ++i)
+  {
+    input << (i ? "," : "") << R"({"k)" << String(i % 70, 'x') << R"(": ")" << String(i % 67 * 2, '\\')
+          << R"(\"", "n": )" << i * 1001 << "}";
+  }
+  input << "]";
+
+  SerializedData data;
+  data.parse<Json>(input);
+  ASSERT_EQ(data.size(), 5000);
+  for (Int32 i = 0; i < 5000; ++i)
+  {
+    EXPECT_EQ(data[i]["k" + String(i % 70, 'x')], String(i % 67, '\\') + "\"");
+    EXPECT_EQ(data[i]["n"], i * 1001);
+  }
+}
+
+TEST(JsonSerde, StreamsAcrossRefills)
+{
+  // Values of every kind straddle the refills of the stream buffer, one string is longer than the buffer itself
+  String input = "[";
+  for (Int32 i = 0; i < 20000; ++i)
+  {
+    input += i ? "," : "";
+    input += String(i % 13, ' ');
+    switch (i % 5)
+    {
+      case 0: input += std::to_string(i * 7919); break;
+      case 1: input += "-" + std::to_string(i) + ".5e-3"; break;
+      case 2: input += i % 3 ? "true" : "null"; break;
+      case 3: input += R"({"key)" + std::to_string(i) + R"(": "a\nb"})"; break;
+      default: input += '"' + String(i == 9999 ? 300000 : i % 101, 'x') + '"'; break;
+    }
+  }
+  input += "]";
+
+  EventRecorder streamed, contiguous;
+  StringStream  ss{input};
+  Json{}.deserialize(ss, streamed);
+  Json{}.deserialize(StringView{input}, contiguous);
+  EXPECT_EQ(streamed.events, contiguous.events);
+
+  // Errors report their offset in the whole stream
+  StringStream broken{input.substr(0, input.size() - 1) + "x"};
+  try
+  {
+    Json{}.deserialize(broken, streamed);
+    FAIL();
+  }
+  catch (const InvalidSyntaxException& e)
+  {
+    EXPECT_NE(String(e.what()).find("offset " + std::to_string(input.size() - 1)), String::npos) << e.what();
+  }
+}
+
+TEST(JsonSerde, Serializer)
+{
+  auto empty = SerializedData::object({{"k", SerializedData::array({})}});
+  auto data  = SerializedData::array({1, 0.1, 2.0, 1e300, "a\"b\n\x01", true, nullptr, empty});
+
+  StringStream compact;
+  data.dumps<Json>(compact);
+  EXPECT_EQ(compact.str(), R"([1,0.1,2.0,1e+300,"a\"b\n\u0001",true,null,{"k":[]}])");
+
+  Json::Configurations config;
+  config.serializer_config.pretty_print = true;
+  config.serializer_config.indent       = 2;
+
+  StringStream pretty;
+  SerializedData::object({{"k", SerializedData::array({1, SerializedData::object({})})}}).dumps(pretty, Json{config});
+  EXPECT_EQ(pretty.str(), "{\n  \"k\": [\n    1,\n    {}\n  ]\n}");
+
+  // Floats are written in their shortest form which reads back exactly, strings longer than a chunk pass through
+  SerializedData original;
+  StringStream   input{sample_json};
+  original.parse<Json>(input);
+  original["ratio"] = 0.1 + 0.2;
+  original["long"]  = String(100000, 'x') + "\"";
+
+  StringStream output;
+  original.dumps<Json>(output);
+  SerializedData parsed;
+  parsed.parse<Json>(output);
+  EXPECT_EQ(parsed, original);
+  EXPECT_EQ(parsed["ratio"].get_float().value(), 0.1 + 0.2);
+
+  StringStream invalid;
+  EXPECT_THROW(SerializedData(std::nan("")).dumps<Json>(invalid), InvalidArgumentException);
+}
+
+TEST_MAIN()
@@ -0,0 +1,75 @@
+#include "../test.hpp"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <setsugen/serde.h>
+
+static String
+write_file(const String& name, const String& contents)
+{
+  auto path = (std::filesystem::temp_directory_path() / name).string();
+  std::ofstream{path, std::ios::binary} << contents;
+  return path;
+}
+
+// Reads its input through a stream only, one array element per line
+struct LinesFormat
+{
+  Void deserialize(InputStream& stream, SerializedData& data) const
+  {
+    data = SerializedData::array({});
+    for (String line; std::getline(stream, line);)
+    {
+      data.get_array().push_back(line);
+    }
+  }
+};
+
+TEST(MappedFile, MapsWholeFile)
+{
+  auto       path = write_file("setsugen-mapped.json", R"({"name": "level-01", "size": [1, 2, 3]})");
+  MappedFile file{path};
+
+  EXPECT_EQ(file.size(), std::filesystem::file_size(path));
+  EXPECT_EQ(file.view().substr(0, 9), R"({"name": )");
+
+  SerializedData data;
+  data.parse<Json>(file.view());
+  EXPECT_EQ(data["name"], "level-01");
+  EXPECT_EQ(data["size"].size(), 3);
+
+  // Documents borrow their strings from the mapping
+  SerializedDocument document;
+  document.parse<Json>(file.view());
+  auto name = document.root()["name"].get_string();
+  EXPECT_EQ(name, "level-01");
+  EXPECT_GE(name.data(), file.data());
+  EXPECT_LT(name.data(), file.data() + file.size());
+
+  // Moving hands the mapping over
+  auto moved = std::move(file);
+  EXPECT_EQ(moved.view().substr(0, 1), "{");
+  EXPECT_EQ(file.size(), 0);
+  EXPECT_EQ(file.data(), nullptr);
+}
+
+TEST(MappedFile, StreamFormatsReadTheSpan)
+{
+  MappedFile file{write_file("setsugen-mapped.txt", "first\nsecond\nthird")};
+
+  SerializedData data;
+  data.parse<LinesFormat>(file.view());
+  EXPECT_EQ(data, SerializedData::array({"first", "second", "third"}));
+}
+
+TEST(MappedFile, EmptyAndMissingFiles)
+{
+  MappedFile empty{write_file("setsugen-empty.json", "")};
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_TRUE(empty.view().empty());
+
+  EXPECT_THROW(MappedFile{"/nonexistent/setsugen.json"}, FileNotFoundException);
+  EXPECT_THROW(MappedFile{std::filesystem::temp_directory_path().string()}, FileNotFoundException);
+}
+
+TEST_MAIN()
@@ -0,0 +1,128 @@
+#include "../test.hpp"
+
+#include <gtest/gtest.h>
+#include <setsugen/serde.h>
+
+static SerializedData
+operation(const char* op, const char* path, SerializedData value)
+{
+  return SerializedData::object_builder().add("op", op).add("path", path).add("value", std::move(value)).build();
+}
+
+TEST(SerializedPatch, DiffRoundTrips)
+{
+  SerializedData from = {
+      {"name", "level-01"},
+      {"a/b", 1},
+      {"settings", {{"fog", true}}},
+      {"items", SerializedData::array({SerializedData::array({"x", "y"}), 2, 3})},
+  };
+  auto to = from;
+
+  to["name"]               = "level-02";
+  to["settings"]["fog"]    = false;
+  to["items"][0]           = SerializedData::array({"x"});
+  to.get_object()["added"] = 3;
+  to.get_object().erase("a/b");
+  to["items"].get_array().insert(1, 9);
+
+  auto patch  = SerializedData::diff(from, to);
+  auto result = from;
+  result.apply_patch(patch);
+  EXPECT_EQ(result, to);
+
+  // Only the changed values are in the patch, the inserted element is a single add
+  Int32 adds = 0;
+  for (const auto& op: patch.get_array())
+  {
+    EXPECT_NE(op["path"].get_string().value(), "/items/2");
+    adds += op["op"] == "add" ? 1 : 0;
+  }
+  EXPECT_EQ(adds, 2);
+  EXPECT_EQ(SerializedData::diff(from, from).size(), 0);
+
+  // Values are escaped as pointers
+  EXPECT_EQ(SerializedData::diff(from, to)[0]["path"], "/a~1b");
+
+  // Different types are replaced wholesale
+  auto replaced = SerializedData::diff(from, SerializedData::array({1}));
+  ASSERT_EQ(replaced.size(), 1);
+  EXPECT_EQ(replaced[0]["op"], "replace");
+  EXPECT_EQ(replaced[0]["path"], "");
+}
+
+TEST(SerializedPatch, ApplyOperations)
+{
+  SerializedData data = {
+      {"a/b", 1},
+      {"gravity", -9.8},
+      {"items", SerializedData::array({SerializedData::object({{"tags", SerializedData::array({"x", "y"})}})})},
+  };
+
+  data.apply_patch(SerializedData::array({
+      operation("add", "/items/-", 13),
+      operation("replace", "/gravity", -1.6),
+      operation("test", "/items/1", 13),
+      SerializedData::object_builder().add("op", "move").add("from", "/a~1b").add("path", "/moved").build(),
+      SerializedData::object_builder().add("op", "copy").add("from", "/items/0").add("path", "/items/1").build(),
+      SerializedData::object_builder().add("op", "remove").add("path", "/items/0/tags/0").build(),
+  }));
+
+  EXPECT_EQ(data["items"].size(), 3);
+  EXPECT_EQ(data["items"][2], 13);
+  EXPECT_EQ(data["items"][0]["tags"].size(), 1);
+  EXPECT_EQ(data["items"][1]["tags"].size(), 2);
+  EXPECT_EQ(data["gravity"], -1.6);
+  EXPECT_EQ(data["moved"], 1);
+  EXPECT_FALSE(data.get_object().has_key("a/b"));
+}
+
+TEST(SerializedPatch, FailedPatchLeavesValueIntact)
+{
+  SerializedData       data     = {{"name", "level-01"}, {"items", SerializedData::array({10})}};
+  const SerializedData original = {{"name", "level-01"}, {"items", SerializedData::array({10})}};
+
+  EXPECT_THROW(data.apply_patch(SerializedData::array({
+                   operation("replace", "/name", "changed"),
+                   operation("test", "/items/0", 11),
+               })),
+               InvalidArgumentException);
+  EXPECT_EQ(data, original);
+
+  EXPECT_THROW(data.apply_patch(SerializedData::array({operation("add", "/missing/key", 1)})),
+               InvalidArgumentException);
+  EXPECT_THROW(data.apply_patch(SerializedData::array({operation("jump", "/name", 1)})), InvalidFormatException);
+  EXPECT_THROW(data.apply_patch(SerializedData::array({SerializedData::object({{"op", "remove"}})})),
+               InvalidFormatException);
+  auto into_itself = SerializedData::object_builder().add("op", "move").add("from", "/items").add("path", "/items/0");
+  EXPECT_THROW(data.apply_patch(SerializedData::array({std::move(into_itself).build()})), InvalidArgumentException);
+  EXPECT_EQ(data, original);
+}
+
+TEST(SerializedPatch, MergePatch)
+{
+  SerializedData from = {{"name", "level-01"}, {"settings", {{"fog", true}, {"gravity", -9.8}}}};
+  auto           to   = from;
+
+  to["settings"]["fog"] = false;
+  to.get_object().erase("name");
+
+  auto patch = SerializedData::merge_diff(from, to);
+  EXPECT_EQ(patch, SerializedData({{"name", nullptr}, {"settings", {{"fog", false}}}}));
+
+  auto result = from;
+  result.apply_merge_patch(patch);
+  EXPECT_EQ(result, to);
+
+  // A patch which changes nothing does not touch the target, it stays shared with its copies
+  auto snapshot = result;
+  result.apply_merge_patch(SerializedData({{"settings", {{"fog", false}}}, {"missing", nullptr}}));
+  EXPECT_EQ(&static_cast<const SerializedData&>(result).get_object(),
+            &static_cast<const SerializedData&>(snapshot).get_object());
+
+  // Non-object patches replace the target
+  result.apply_merge_patch(SerializedData::array({1, 2}));
+  EXPECT_EQ(result, SerializedData::array({1, 2}));
+}
+
+TEST_MAIN()
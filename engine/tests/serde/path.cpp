@@ -0,0 +1,109 @@
+#include "../test.hpp"
+
+#include <gtest/gtest.h>
+#include <setsugen/serde.h>
+
+static SerializedData
+make_scene()
+{
+  return {
+      {"name", "level-01"},
+      {"a/b", 1},
+      {"m~n", 2},
+      {"items", SerializedData::array({
+                    SerializedData::object({{"id", 10}, {"tags", SerializedData::array({"x", "y"})}}),
+                    SerializedData::object({{"id", 11}, {"tags", SerializedData::array({})}}),
+                    SerializedData::object({{"name", "no id"}}),
+                })},
+  };
+}
+
+TEST(SerializedPath, Pointer)
+{
+  auto scene = make_scene();
+
+  EXPECT_EQ(SerializedPath::pointer("").resolve(scene), &scene);
+  EXPECT_EQ(*SerializedPath::pointer("/name").resolve(scene), "level-01");
+  EXPECT_EQ(*SerializedPath::pointer("/items/1/id").resolve(scene), 11);
+  EXPECT_EQ(*SerializedPath::pointer("/a~1b").resolve(scene), 1);
+  EXPECT_EQ(*SerializedPath::pointer("/m~0n").resolve(scene), 2);
+
+  EXPECT_EQ(SerializedPath::pointer("/items/3/id").resolve(scene), nullptr);
+  EXPECT_EQ(SerializedPath::pointer("/items/01").resolve(scene), nullptr);
+  EXPECT_EQ(SerializedPath::pointer("/name/0").resolve(scene), nullptr);
+  EXPECT_EQ(SerializedPath::pointer("/missing").resolve(scene), nullptr);
+
+  EXPECT_THROW(SerializedPath::pointer("name"), InvalidSyntaxException);
+  EXPECT_THROW(SerializedPath::pointer("/a~2"), InvalidSyntaxException);
+  EXPECT_EQ(SerializedPath::pointer("/a~1b/m~0n").to_pointer(), "/a~1b/m~0n");
+}
+
+TEST(SerializedPath, Dotted)
+{
+  auto scene = make_scene();
+
+  EXPECT_EQ(*SerializedPath("items[0].tags[1]").resolve(scene), "y");
+  EXPECT_EQ(*SerializedPath("items.0.id").resolve(scene), 10);
+  EXPECT_EQ(*SerializedPath("/items/0/id").resolve(scene), 10);
+  EXPECT_EQ(SerializedPath("items[2].id").resolve(scene), nullptr);
+
+  auto items = *SerializedPath("items").resolve(scene);
+  EXPECT_EQ(*SerializedPath("[1].id").resolve(items), 11);
+
+  EXPECT_THROW(SerializedPath("items..id"), InvalidSyntaxException);
+  EXPECT_THROW(SerializedPath("items[x]"), InvalidSyntaxException);
+  EXPECT_THROW(SerializedPath("items[0"), InvalidSyntaxException);
+  EXPECT_THROW(SerializedPath("items[0]id"), InvalidSyntaxException);
+  EXPECT_THROW(SerializedPath("items."), InvalidSyntaxException);
+}
+
+TEST(SerializedPath, Wildcards)
+{
+  const auto scene = make_scene();
+
+  auto ids = SerializedPath("items[*].id").select(scene);
+  ASSERT_EQ(ids.size(), 2);
+  EXPECT_EQ(*ids[0], 10);
+  EXPECT_EQ(*ids[1], 11);
+
+  DArray<String> tags;
+  SerializedPath("items.*.tags[*]").for_each(scene,
+                                             [&](const SerializedData& tag) { tags.push_back(tag.get_string().value()); });
+  EXPECT_EQ(tags, (DArray<String>{"x", "y"}));
+
+  EXPECT_TRUE(SerializedPath("items[*]").has_wildcard());
+  EXPECT_THROW(SerializedPath("items[*].id").resolve(scene), InvalidOperationException);
+}
+
+TEST(SerializedPath, MutableResolveResetsHashes)
+{
+  auto scene  = make_scene();
+  auto before = scene.hash();
+
+  SerializedPath path{"items[1].id"};
+  *path.resolve(scene) = 12;
+  EXPECT_NE(scene.hash(), before);
+
+  SerializedPath("items[*].id").for_each(scene, [](SerializedData& id) { id = 0; });
+  EXPECT_EQ(scene["items"][0]["id"], 0);
+  EXPECT_EQ(scene["items"][1]["id"], 0);
+}
+
+TEST(SerializedPath, IndexedObjects)
+{
+  SerializedData data = SerializedData::object({});
+  for (Int32 i = 0; i < 64; ++i)
+  {
+    data["key" + std::to_string(i)] = i;
+  }
+
+  for (Int32 i = 0; i < 64; ++i)
+  {
+    SerializedPath path{"key" + std::to_string(i)};
+    ASSERT_NE(path.resolve(data), nullptr);
+    EXPECT_EQ(*path.resolve(data), i);
+  }
+  EXPECT_EQ(SerializedPath("key64").resolve(data), nullptr);
+}
+
+TEST_MAIN()
@@ -0,0 +1,210 @@
+#include "../test.hpp"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <setsugen/serde.h>
+
+static SerializedData
+make_items()
+{
+  auto items = SerializedData::array({});
+  for (Int32 i = 0; i < 200; ++i)
+  {
+    items.get_array().push_back(SerializedData::object({
+        {"id", i},
+        {"name", "item-" + std::to_string(i % 20)},
+        {"weight", i * 0.25},
+        {"stackable", i % 2 == 0},
+        {"tags", SerializedData::array({"common", i % 3 == 0 ? "rare" : "common"})},
+    }));
+  }
+
+  return SerializedData::object({
+      {"version", 3},
+      {"min", std::numeric_limits<Int64>::min()},
+      {"max", std::numeric_limits<Int64>::max()},
+      {"negative", -1},
+      {"precise", 0.1 + 0.2},
+      {"empty", ""},
+      {"nothing", nullptr},
+      {"nested", SerializedData::object({
+                     {"empty_array", SerializedData::array({})},
+                     {"empty_object", SerializedData::object({})},
+                 })},
+      {"items", items},
+  });
+}
+
+static String
+encode(const SerializedData& data, Bool indexed)
+{
+  StringStream stream;
+  data.dumps(stream, Sbf{{.indexed = indexed}});
+  return stream.str();
+}
+
+TEST(Sbf, RoundTrips)
+{
+  auto original = make_items();
+
+  for (auto indexed: {false, true})
+  {
+    StringStream   stream{encode(original, indexed)};
+    SerializedData decoded;
+    decoded.parse<Sbf>(stream);
+    EXPECT_EQ(decoded, original) << indexed;
+    EXPECT_EQ(decoded["precise"].get_float().value(), 0.1 + 0.2);
+    EXPECT_EQ(decoded["min"].get_integer().value(), std::numeric_limits<Int64>::min());
+  }
+
+  // Scalars can be the root as well
+  SerializedData scalar;
+  scalar.parse<Sbf>(StringView{encode("alone", false)});
+  EXPECT_EQ(scalar, "alone");
+}
+
+TEST(Sbf, IsCompact)
+{
+  auto data = make_items();
+
+  StringStream json;
+  data.dumps<Json>(json);
+
+  // Keys and repeated strings are stored once, only the root object and the items array are large enough to be indexed
+  auto plain   = encode(data, false);
+  auto indexed = encode(data, true);
+  EXPECT_LT(plain.size() * 2, json.str().size());
+  EXPECT_GE(indexed.size() - plain.size(), 200 * 4 + 9 * 8);
+  EXPECT_LT(indexed.size() - plain.size(), 200 * 4 + 9 * 8 + 8);
+  EXPECT_EQ(plain.find("stackable"), plain.rfind("stackable"));
+  EXPECT_EQ(plain, encode(data, false));
+}
+
+TEST(Sbf, RejectsMalformedData)
+{
+  auto           buffer = encode(make_items(), true);
+  SerializedData data;
+
+  // Every truncation is caught, none reads past the end
+  for (size_t size = 0; size < buffer.size(); size += 7)
+  {
+    EXPECT_THROW(data.parse<Sbf>(StringView{buffer.data(), size}), InvalidFormatException) << size;
+  }
+
+  EXPECT_THROW(data.parse<Sbf>(StringView{"JSON{}"}), InvalidFormatException);
+  EXPECT_THROW(data.parse<Sbf>(StringView{buffer + "x"}), InvalidFormatException);
+
+  auto version = buffer;
+  version[3]   = 9;
+  EXPECT_THROW(data.parse<Sbf>(StringView{version}), InvalidFormatException);
+
+  // A string id past the table
+  String unknown{"SBF\x01\x00\x00\x06\x7F", 8};
+  EXPECT_THROW(data.parse<Sbf>(StringView{unknown}), InvalidFormatException);
+
+  // Nesting deeper than the limit, built from the inside out so that every size is right
+  String deep{"\x00", 1};
+  for (Int32 i = 0; i < 2000; ++i)
+  {
+    String size;
+    for (auto value = deep.size(); value; value >>= 7)
+    {
+      size.push_back(static_cast<char>((value & 0x7F) | (value >= 0x80 ? 0x80 : 0)));
+    }
+    deep = "\x07\x01" + size + deep;
+  }
+  EXPECT_THROW(data.parse<Sbf>(StringView{String("SBF\x01\x00\x00", 6) + deep}), InvalidFormatException);
+}
+
+TEST(SbfView, NavigatesInPlace)
+{
+  auto original = make_items();
+
+  for (auto indexed: {false, true})
+  {
+    auto    buffer = encode(original, indexed);
+    SbfView root{StringView{buffer}};
+
+    EXPECT_EQ(root.get_type(), SerializedType::Object);
+    EXPECT_EQ(root.size(), 9);
+    EXPECT_EQ(root["version"].get_integer(), 3);
+    EXPECT_EQ(root["min"].get_integer(), std::numeric_limits<Int64>::min());
+    EXPECT_EQ(root["precise"].get_float(), 0.1 + 0.2);
+    EXPECT_EQ(root["empty"].get_string(), "");
+    EXPECT_FALSE(root["nothing"]);
+    EXPECT_TRUE(root["nested"]["empty_array"].get_array().empty());
+
+    // Elements on both sides of the ones the index would skip over
+    auto items = root["items"].get_array();
+    EXPECT_EQ(items.size(), 200);
+    for (size_t i: {0, 7, 8, 150, 199})
+    {
+      EXPECT_EQ(items[i]["id"].get_integer(), static_cast<Int64>(i)) << indexed;
+      EXPECT_EQ(items[i]["name"].get_string(), "item-" + std::to_string(i % 20));
+      EXPECT_EQ(items[i]["weight"].get_float(), i * 0.25);
+      EXPECT_EQ(items[i]["stackable"].get_bool(), i % 2 == 0);
+      EXPECT_EQ(items[i]["tags"][1].get_string(), i % 3 == 0 ? "rare" : "common");
+    }
+
+    Int64 count = 0;
+    for (auto item: items)
+    {
+      EXPECT_EQ(item["id"].get_integer(), count++);
+    }
+    EXPECT_EQ(count, 200);
+
+    DArray<String> keys;
+    for (auto [key, value]: root.get_object())
+    {
+      keys.emplace_back(key);
+    }
+    EXPECT_EQ(keys.size(), 9);
+    EXPECT_EQ(keys.front(), "version");
+    EXPECT_EQ(keys.back(), "items");
+
+    EXPECT_EQ(root.to_serialized(), original);
+  }
+}
+
+TEST(SbfView, LookupAndErrors)
+{
+  for (auto indexed: {false, true})
+  {
+    auto    buffer = encode(make_items(), indexed);
+    SbfView root{StringView{buffer}};
+    auto    object = root.get_object();
+
+    EXPECT_TRUE(object.has_key("precise"));
+    EXPECT_FALSE(object.has_key("missing"));
+    // In the string table, but not a key of this object
+    EXPECT_FALSE(object.has_key("stackable"));
+    EXPECT_FALSE(object.has_key("item-3"));
+
+    EXPECT_THROW(object["missing"], OutOfBoundsException);
+    EXPECT_THROW(root["items"][200], OutOfBoundsException);
+    EXPECT_THROW(root["version"].get_string(), InvalidOperationException);
+    EXPECT_THROW(root["version"].get_array(), InvalidOperationException);
+    EXPECT_THROW(root["empty"].size(), InvalidOperationException);
+  }
+
+  EXPECT_EQ(SbfView{}.get_type(), SerializedType::Null);
+  EXPECT_THROW(SbfView{StringView{"JSON{}"}}, InvalidFormatException);
+
+  // A container whose size runs past the end of the buffer
+  String truncated{"SBF\x01\x00\x00\x07\x01\x10\x00", 10};
+  EXPECT_THROW(SbfView{StringView{truncated}}.get_array(), InvalidFormatException);
+}
+
+TEST(SbfView, ReadsMappedFile)
+{
+  auto original = make_items();
+  auto path     = (std::filesystem::temp_directory_path() / "setsugen-items.sbf").string();
+  std::ofstream{path, std::ios::binary} << encode(original, true);
+
+  MappedFile file{path};
+  SbfView    root{file.view()};
+  EXPECT_EQ(root["items"][42]["name"].get_string(), "item-2");
+  EXPECT_EQ(root.to_serialized(), original);
+}
+
+TEST_MAIN()
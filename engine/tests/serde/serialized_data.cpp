@@ -24,6 +24,15 @@ TEST(SerializedData, ManualCreation_String)
   EXPECT_EQ(s1.get_string().value(), "Hello, World!");
 }
 
+TEST(SerializedData, String_ViewDoesNotCopy)
+{
+  SerializedData s1 = SerializedData::string("A string too long for the small string buffer");
+  auto           view = s1.get_string().view();
+
+  EXPECT_EQ(view, "A string too long for the small string buffer");
+  EXPECT_EQ(view.data(), s1.get_string().value().data());
+}
+
 TEST(SerializedData, ManualCreation_Boolean)
 {
   SerializedData b1 = SerializedData::boolean(true);
@@ -371,4 +380,226 @@ TEST(SerializedData, Complex)
   EXPECT_EQ(obj["spouse"].get_type(), SerializedType::Null);
 }
 
+TEST(SerializedData, Object_KeepsInsertionOrder)
+{
+  SerializedData obj = {
+    {"zeta", 1},
+    {"alpha", 2},
+    {"mid", 3},
+  };
+  obj["beta"] = 4;
+
+  DArray<String> keys;
+  for (const auto& [key, value]: obj.get_object())
+  {
+    keys.push_back(key);
+  }
+
+  EXPECT_EQ(keys, (DArray<String>{"zeta", "alpha", "mid", "beta"}));
+}
+
+TEST(SerializedData, Builders_MoveSubtrees)
+{
+  auto children = SerializedData::array_builder(2)
+                      .add(SerializedData::object_builder().add("name", "Jane").add("age", 5).build())
+                      .add(SerializedData::object_builder().add("name", "John Jr.").add("age", 2).build())
+                      .build();
+
+  // The elements are moved along with the array instead of being copied
+  auto first  = &children[0];
+  auto parent = SerializedData::object_builder().add("name", "John").add("children", std::move(children)).build();
+
+  EXPECT_EQ(&parent["children"][0], first);
+  EXPECT_EQ(parent["name"], "John");
+  EXPECT_EQ(parent["children"].size(), 2);
+  EXPECT_EQ(parent["children"][1]["name"], "John Jr.");
+  EXPECT_EQ(parent["children"][1]["age"], 2);
+}
+
+TEST(SerializedData, Emplace_ConstructsInPlace)
+{
+  SerializedData obj = SerializedData::object({});
+  auto&          storage = obj.get_object();
+
+  storage.emplace("answer", 42);
+  storage.emplace("list", SerializedData::array({}));
+  storage.emplace("list").get_array().emplace_back("first");
+  storage.emplace("answer", "replaced");
+
+  EXPECT_EQ(storage.size(), 2);
+  EXPECT_EQ(obj["answer"], "replaced");
+  EXPECT_EQ(obj["list"][0], "first");
+}
+
+TEST(SerializedData, Object_IndexedLookup)
+{
+  SerializedData obj = SerializedData::object({});
+  auto&          storage = obj.get_object();
+
+  // Crosses the threshold at which the members get a hash index, and a few of its resizes
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    storage["key" + std::to_string(i)] = i;
+  }
+
+  EXPECT_EQ(storage.size(), 100);
+  for (Int32 i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(storage.has_key("key" + std::to_string(i)));
+    EXPECT_EQ(storage["key" + std::to_string(i)], i);
+  }
+  EXPECT_FALSE(storage.has_key("key100"));
+  EXPECT_EQ(storage.find("missing"), nullptr);
+
+  storage.erase("key3");
+  EXPECT_EQ(storage.size(), 99);
+  EXPECT_FALSE(storage.has_key("key3"));
+  EXPECT_EQ(storage["key99"], 99);
+  EXPECT_EQ(storage.begin()[3].first, "key4");
+
+  const auto& const_storage = storage;
+  EXPECT_THROW(const_storage["key3"], OutOfBoundsException);
+}
+
+TEST(SerializedData, Hash_IsStructural)
+{
+  SerializedData first = {
+      {"name", "level-01"},
+      {"size", 128},
+      {"layers", SerializedData::array({1, 2.5, nullptr, false})},
+  };
+  SerializedData second = {
+      {"layers", SerializedData::array({1.0, 2.5, nullptr, false})},
+      {"size", 128},
+      {"name", "level-01"},
+  };
+
+  EXPECT_EQ(first.hash(), second.hash());
+  EXPECT_EQ(first, second);
+
+  EXPECT_NE(SerializedData::array({1, 2}).hash(), SerializedData::array({2, 1}).hash());
+  EXPECT_NE(SerializedData::array({1, 2}), SerializedData::array({2, 1}));
+  EXPECT_NE(SerializedData(false).hash(), SerializedData(0).hash());
+  EXPECT_NE(SerializedData::object({{"a", 1}, {"b", 2}}).hash(), SerializedData::object({{"a", 2}, {"b", 1}}).hash());
+  EXPECT_NE(SerializedData::object({{"a", 1}}), SerializedData::object({{"a", 1}, {"b", 2}}));
+  EXPECT_NE(SerializedData::object({{"a", 1}}), SerializedData::array({"a", 1}));
+}
+
+TEST(SerializedData, Hash_ResetOnMutation)
+{
+  SerializedData data = {
+      {"settings", {{"width", 1280}, {"height", 720}}},
+      {"tags", SerializedData::array({"a", "b"})},
+  };
+  auto copy = data;
+
+  auto before = data.hash();
+  EXPECT_EQ(copy.hash(), before);
+
+  data["settings"]["width"] = 1920;
+  EXPECT_NE(data.hash(), before);
+  EXPECT_NE(data, copy);
+
+  data["settings"]["width"] = 1280;
+  EXPECT_EQ(data.hash(), before);
+  EXPECT_EQ(data, copy);
+
+  data["tags"].get_array().push_back("c");
+  EXPECT_NE(data.hash(), before);
+
+  data["tags"].get_array().pop_back();
+  for (auto& [key, value]: data.get_object())
+  {
+    if (key == "settings")
+    {
+      value.get_object().erase("height");
+    }
+  }
+  EXPECT_NE(data.hash(), before);
+  EXPECT_NE(data, copy);
+}
+
+TEST(SerializedData, Hash_ResetThroughRetainedReferences)
+{
+  SerializedData root  = {{"a", 1}, {"b", SerializedData::array({1})}};
+  SerializedData other = {{"a", 2}, {"b", SerializedData::array({2})}};
+
+  // Written through references kept from before the hashes were taken
+  auto& a       = root["a"];
+  auto& element = root["b"].get_array()[0];
+  auto  before  = root.hash();
+  other.hash();
+  a       = 2;
+  element = 2;
+
+  EXPECT_NE(root.hash(), before);
+  EXPECT_EQ(root.hash(), other.hash());
+  EXPECT_EQ(root, other);
+}
+
+TEST(SerializedData, Hash_ResetThroughRetainedChild)
+{
+  SerializedData data     = {{"child", {{"x", 0}}}, {"list", SerializedData::array({})}};
+  SerializedData expected = {{"child", {{"x", 1}}}, {"list", SerializedData::array({})}};
+  data["list"].get_array().push_back(SerializedData::array({1}));
+  expected["list"].get_array().push_back(SerializedData::array({1, 2}));
+
+  auto& child = data["child"];
+  auto  hash  = data.hash();
+  EXPECT_NE(hash, expected.hash());
+
+  child["x"] = 1;
+  EXPECT_NE(data.hash(), hash);
+
+  // Growing the array moves its elements, which stay linked to it
+  data["list"].get_array().reserve(64);
+  auto& inner = data["list"][0];
+  hash        = data.hash();
+  inner.get_array().push_back(2);
+  EXPECT_NE(data.hash(), hash);
+  EXPECT_EQ(data.hash(), expected.hash());
+  EXPECT_EQ(data, expected);
+  EXPECT_EQ(SerializedData::diff(data, expected).size(), 0);
+
+  hash = data.hash();
+  inner.get_array()[0] = 3;
+  EXPECT_NE(data.hash(), hash);
+  EXPECT_NE(data, expected);
+  EXPECT_EQ(SerializedData::diff(data, expected).size(), 1);
+}
+
+TEST(SerializedData, Copy_SharesUntilMutation)
+{
+  SerializedData original = {
+      {"window", {{"width", 1280}, {"height", 720}}},
+      {"audio", {{"volume", 0.5}}},
+      {"plugins", SerializedData::array({"a", "b"})},
+  };
+
+  auto        copy          = original;
+  const auto& const_orig    = original;
+  const auto& const_copy    = copy;
+  auto        shared_window = &const_orig["window"].get_object();
+  EXPECT_EQ(&const_copy.get_object(), &const_orig.get_object());
+  EXPECT_EQ(&const_copy["window"].get_object(), shared_window);
+
+  copy["window"]["width"] = 1920;
+  EXPECT_EQ(original["window"]["width"], 1280);
+  EXPECT_EQ(copy["window"]["width"], 1920);
+
+  // Only the containers on the written path were cloned
+  EXPECT_NE(&const_copy.get_object(), &const_orig.get_object());
+  EXPECT_NE(&const_copy["window"].get_object(), shared_window);
+  EXPECT_EQ(&const_copy["audio"].get_object(), &const_orig["audio"].get_object());
+  EXPECT_EQ(&const_copy["plugins"].get_array(), &const_orig["plugins"].get_array());
+
+  copy["plugins"].get_array().push_back("c");
+  EXPECT_EQ(original["plugins"].size(), 2);
+  EXPECT_EQ(copy["plugins"].size(), 3);
+
+  auto moved = std::move(copy);
+  EXPECT_EQ(copy.get_type(), SerializedType::Null);
+  EXPECT_EQ(moved["plugins"][2], "c");
+}
+
 TEST_MAIN()
@@ -0,0 +1,208 @@
+#include <setsugen/executor.h>
+#include <setsugen/logger.h>
+
+using namespace setsugen;
+
+using Clock = std::chrono::steady_clock;
+
+static Atomic<Int64> allocation_count{0};
+
+Void*
+operator new(size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+Void
+operator delete(Void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+Void
+operator delete(Void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+struct LatencyResult
+{
+  Float64 mean_us;
+  Float64 p50_us;
+  Float64 p99_us;
+  Float64 max_us;
+};
+
+// Submit one task at a time to an idle pool and measure how long it takes until the task starts running.
+template<typename E>
+LatencyResult
+measure_latency(E& executor, Int32 samples)
+{
+  DArray<Float64> latencies;
+  latencies.reserve(samples);
+
+  for (Int32 i = 0; i < samples; ++i)
+  {
+    // Give the workers time to go idle, this is the case the sleep-polling pool handles poorly
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    auto submitted = Clock::now();
+    auto started   = executor.submit([] { return Clock::now(); }).get();
+    latencies.push_back(std::chrono::duration<Float64, std::micro>(started - submitted).count());
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  Float64 sum = 0;
+  for (auto latency: latencies)
+  {
+    sum += latency;
+  }
+
+  return {
+      .mean_us = sum / samples,
+      .p50_us  = latencies[samples / 2],
+      .p99_us  = latencies[std::min<Int32>(samples - 1, samples * 99 / 100)],
+      .max_us  = latencies.back(),
+  };
+}
+
+// Submit a large batch of tiny tasks and measure how many tasks per second the pool completes.
+template<typename E>
+Float64
+measure_throughput(E& executor, Int32 tasks)
+{
+  Atomic<Int64>             sink{0};
+  DArray<std::future<Void>> futures;
+  futures.reserve(tasks);
+
+  auto start = Clock::now();
+  for (Int32 i = 0; i < tasks; ++i)
+  {
+    futures.push_back(executor.submit([&sink, i] { sink.fetch_add(i, std::memory_order_relaxed); }));
+  }
+
+  for (auto& future: futures)
+  {
+    future.get();
+  }
+  auto end = Clock::now();
+
+  return tasks / std::chrono::duration<Float64>(end - start).count();
+}
+
+// Count heap allocations per task, including the ones made by the workers while running the task.
+template<typename E, typename Submit>
+Float64
+measure_allocations(E& executor, Int32 tasks, Submit&& submit)
+{
+  Atomic<Int32> done{0};
+
+  // Warm up so that queues and task node caches reach their steady state size
+  for (Int32 i = 0; i < tasks; ++i)
+  {
+    submit(executor, done);
+  }
+  while (done.load() < tasks)
+  {
+    std::this_thread::yield();
+  }
+
+  done       = 0;
+  auto start = allocation_count.load();
+  for (Int32 i = 0; i < tasks; ++i)
+  {
+    submit(executor, done);
+  }
+  while (done.load() < tasks)
+  {
+    std::this_thread::yield();
+  }
+
+  return static_cast<Float64>(allocation_count.load() - start) / tasks;
+}
+
+// Reproduces the wrapping the executor used to do on submit (bind, function, shared packaged_task, function) so the
+// allocation count can be compared against the current path.
+Float64
+measure_legacy_allocations(Int32 tasks)
+{
+  auto start = allocation_count.load();
+  for (Int32 i = 0; i < tasks; ++i)
+  {
+    std::function<Int32()> binder = std::bind([](Int32 x) { return x; }, i);
+
+    auto ptask  = std::make_shared<std::packaged_task<Int32(Bool)>>([binder](Bool) { return binder(); });
+    auto future = ptask->get_future();
+
+    Fn<Void(Bool)> task = [ptask](Bool stopped) { (*ptask)(stopped); };
+    task(false);
+    future.get();
+  }
+
+  return static_cast<Float64>(allocation_count.load() - start) / tasks;
+}
+
+template<typename E>
+Void
+run_benchmark(const Owner<Logger>& logger, const String& name, size_t threads, Int32 samples, Int32 tasks)
+{
+  auto executor = E::create(threads);
+  executor->start();
+
+  auto latency    = measure_latency(*executor, samples);
+  auto throughput = measure_throughput(*executor, tasks);
+
+  logger->info("{}: latency mean = {}us, p50 = {}us, p99 = {}us, max = {}us",
+               {name, latency.mean_us, latency.p50_us, latency.p99_us, latency.max_us});
+  logger->info("{}: throughput = {} tasks/s over {} tasks", {name, static_cast<Int64>(throughput), tasks});
+  executor->stats().log(*logger, name);
+
+  // Same batch without the wait and run time histograms, the difference is what the instrumentation costs
+  executor->set_timing_enabled(false);
+  auto untimed_throughput = measure_throughput(*executor, tasks);
+  executor->set_timing_enabled(true);
+  logger->info("{}: throughput without timing = {} tasks/s", {name, static_cast<Int64>(untimed_throughput)});
+
+  auto submit_allocations = measure_allocations(*executor, 10'000,
+                                                [](E& executor, Atomic<Int32>& done)
+                                                {
+                                                  // The future is dropped, only the submit path is measured
+                                                  executor.submit([&done] { done.fetch_add(1); });
+                                                });
+  auto detached_allocations = measure_allocations(*executor, 10'000,
+                                                  [](E& executor, Atomic<Int32>& done)
+                                                  { executor.submit_detached([&done] { done.fetch_add(1); }); });
+
+  logger->info("{}: allocations per task, submit = {}, submit_detached = {}",
+               {name, submit_allocations, detached_allocations});
+
+  executor->stop();
+  executor->join();
+}
+
+int
+main(int argc, char** argv)
+{
+  LoggerFactory logger_factory{};
+  logger_factory.add_appender(
+      std::make_shared<ConsoleLogAppender>("console", "[{level:w=6}] {tag:w=20} ->> {message}"));
+  auto logger = logger_factory.get("executor-lab");
+
+  size_t threads = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+  Int32  samples = argc > 2 ? std::stoi(argv[2]) : 50;
+  Int32  tasks   = argc > 3 ? std::stoi(argv[3]) : 200'000;
+
+  logger->info("Running with {} threads, {} latency samples, {} throughput tasks", {threads, samples, tasks});
+
+  logger->info("Legacy submit path: allocations per task = {}", {measure_legacy_allocations(10'000)});
+
+  run_benchmark<FixedThreadPoolExecutor>(logger, "FixedThreadPool", threads, samples, tasks);
+  run_benchmark<WorkStealingExecutor>(logger, "WorkStealing", threads, samples, tasks);
+  run_benchmark<CachedThreadPoolExecutor>(logger, "CachedThreadPool", threads, samples, tasks);
+}
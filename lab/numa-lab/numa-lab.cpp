@@ -0,0 +1,151 @@
+#include <setsugen/executor.h>
+#include <setsugen/logger.h>
+
+#include <numeric>
+
+using namespace setsugen;
+
+using Clock = std::chrono::steady_clock;
+
+// Parses a kernel CPU list such as "0-3,8-11"
+DArray<Int32>
+parse_cpu_list(const String& list)
+{
+  DArray<Int32> cpus;
+  StringStream  stream(list);
+  String        range;
+  while (std::getline(stream, range, ','))
+  {
+    if (range.empty())
+    {
+      continue;
+    }
+
+    auto dash  = range.find('-');
+    auto first = std::stoi(range.substr(0, dash));
+    auto last  = dash == String::npos ? first : std::stoi(range.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu)
+    {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+DArray<DArray<Int32>>
+read_numa_nodes()
+{
+  DArray<DArray<Int32>> nodes;
+  for (Int32 node = 0;; ++node)
+  {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file)
+    {
+      break;
+    }
+
+    String list;
+    std::getline(file, list);
+    if (auto cpus = parse_cpu_list(list); !cpus.empty())
+    {
+      nodes.emplace_back(std::move(cpus));
+    }
+  }
+
+  return nodes;
+}
+
+Owner<WorkStealingExecutor>
+create_node_pool(const DArray<Int32>& cpus, const String& name)
+{
+  auto executor = WorkStealingExecutor::create(
+      ExecutorOptions{.num_threads = cpus.size(), .thread_name = name, .cpus = cpus, .pin_threads = true});
+  executor->start();
+  return executor;
+}
+
+// Sum the buffer with workers pinned to one node while its pages were first touched by workers pinned to another.
+// The buffer is allocated without being initialized so that no page is placed before the writer pool touches it.
+// Loops are started from inside the pool, the unpinned main thread would otherwise take part in them.
+Float64
+measure_bandwidth(const DArray<Int32>& home, const DArray<Int32>& remote, size_t elements, Int32 repeats)
+{
+  Owner<UInt64[]> buffer{new UInt64[elements]};
+  auto            grain = std::max<size_t>(elements / 256, 1);
+
+  {
+    auto writer = create_node_pool(home, "numa-writer");
+    writer
+        ->submit([&] { parallel_for(*writer, size_t{0}, elements, grain, [&buffer](size_t i) { buffer[i] = i; }); })
+        .get();
+    writer->stop();
+    writer->join();
+  }
+
+  auto reader = create_node_pool(remote, "numa-reader");
+
+  Float64 best = 0;
+  for (Int32 i = 0; i < repeats; ++i)
+  {
+    auto start = Clock::now();
+    auto sum   = reader
+                   ->submit(
+                       [&]
+                       {
+                         return parallel_reduce(
+                             *reader, size_t{0}, elements, grain, UInt64{0}, [&buffer](size_t i) { return buffer[i]; },
+                             [](UInt64 a, UInt64 b) { return a + b; });
+                       })
+                   .get();
+    auto seconds = std::chrono::duration<Float64>(Clock::now() - start).count();
+
+    if (sum != elements * (elements - 1) / 2)
+    {
+      throw InvalidStateException("Unexpected checksum {}", {sum});
+    }
+
+    best = std::max(best, static_cast<Float64>(elements * sizeof(UInt64)) / seconds / 1e9);
+  }
+
+  reader->stop();
+  reader->join();
+  return best;
+}
+
+int
+main(int argc, char** argv)
+{
+  LoggerFactory logger_factory{};
+  logger_factory.add_appender(
+      std::make_shared<ConsoleLogAppender>("console", "[{level:w=6}] {tag:w=20} ->> {message}"));
+  auto logger = logger_factory.get("numa-lab");
+
+  size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 512;
+  Int32  repeats   = argc > 2 ? std::stoi(argv[2]) : 5;
+  auto   elements  = megabytes * 1024 * 1024 / sizeof(UInt64);
+
+  auto nodes = read_numa_nodes();
+  if (nodes.empty())
+  {
+    DArray<Int32> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+    std::iota(cpus.begin(), cpus.end(), 0);
+    nodes.emplace_back(std::move(cpus));
+  }
+
+  logger->info("{} NUMA nodes, {} MiB buffer, best of {} runs", {nodes.size(), megabytes, repeats});
+  if (nodes.size() == 1)
+  {
+    logger->warn("Single node machine, only node local bandwidth can be measured");
+  }
+
+  for (size_t home = 0; home < nodes.size(); ++home)
+  {
+    for (size_t remote = 0; remote < nodes.size(); ++remote)
+    {
+      auto bandwidth = measure_bandwidth(nodes[home], nodes[remote], elements, repeats);
+      logger->info("memory on node {}, read from node {}: {} GB/s{}",
+                   {home, remote, bandwidth, home == remote ? " (local)" : " (cross-node)"});
+    }
+  }
+}
@@ -0,0 +1,557 @@
+#include <setsugen/logger.h>
+#include <setsugen/refl.h>
+#include <setsugen/serde.h>
+
+#include <filesystem>
+
+using namespace setsugen;
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from dropping the measured work
+static volatile Int64 sink = 0;
+
+static Atomic<Int64> allocation_count{0};
+
+Void*
+operator new(size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+Void
+operator delete(Void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+Void
+operator delete(Void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Keys of a render settings block, the kind of object most configuration files are made of
+static const DArray<String> config_keys = {"width", "height", "fullscreen", "vsync", "msaa", "gamma"};
+
+// Keys of a scene entity with a pile of components, large enough to be looked up through the hash index
+static DArray<String>
+make_scene_keys()
+{
+  DArray<String> keys = {"id",        "name",      "parent",   "position", "rotation",  "scale",  "mesh",
+                         "material",  "collider",  "rigidbody", "script",  "animator",  "light",  "camera",
+                         "audio",     "particles", "tags",      "layer",   "visible",   "static", "lod_bias"};
+  for (Int32 i = 0; i < 19; ++i)
+  {
+    keys.push_back("custom_property_" + std::to_string(i));
+  }
+  return keys;
+}
+
+static const DArray<String> scene_keys = make_scene_keys();
+
+template<typename F>
+Float64
+measure_ns(Int64 operations, F&& operation)
+{
+  auto start = Clock::now();
+  operation();
+  auto end = Clock::now();
+
+  return std::chrono::duration<Float64, std::nano>(end - start).count() / static_cast<Float64>(operations);
+}
+
+// The storage objects used before members were kept in order, as a baseline
+using UnorderedObject = UnorderedMap<String, SerializedData>;
+
+template<typename O>
+Void
+run_benchmark(const Owner<Logger>& logger, const String& name, const DArray<String>& keys, Int32 objects,
+              Int32 rounds)
+{
+  auto build = [&keys](DArray<O>& storage)
+  {
+    for (auto& object: storage)
+    {
+      for (size_t i = 0; i < keys.size(); ++i)
+      {
+        object[keys[i]] = static_cast<Int64>(i);
+      }
+    }
+  };
+
+  // Every round builds fresh objects and the best round is kept, the first ones mostly measure page faults
+  DArray<O> storage;
+  auto      build_ns = std::numeric_limits<Float64>::max();
+  for (Int32 round = 0; round < rounds; ++round)
+  {
+    storage  = DArray<O>(objects);
+    build_ns = std::min(build_ns, measure_ns(static_cast<Int64>(objects) * keys.size(), [&] { build(storage); }));
+  }
+
+  auto lookup_ns = measure_ns(static_cast<Int64>(rounds) * objects * keys.size(),
+                              [&]
+                              {
+                                for (Int32 round = 0; round < rounds; ++round)
+                                {
+                                  for (auto& object: storage)
+                                  {
+                                    for (const auto& key: keys)
+                                    {
+                                      sink = sink + object[key].get_integer().value();
+                                    }
+                                  }
+                                }
+                              });
+
+  auto iterate_ns = measure_ns(static_cast<Int64>(rounds) * objects * keys.size(),
+                               [&]
+                               {
+                                 for (Int32 round = 0; round < rounds; ++round)
+                                 {
+                                   for (auto& object: storage)
+                                   {
+                                     for (const auto& [key, value]: object)
+                                     {
+                                       sink = sink + static_cast<Int64>(key.size());
+                                     }
+                                   }
+                                 }
+                               });
+
+  logger->info("{}: {} keys, build = {}ns/member, lookup = {}ns/op, iteration = {}ns/member",
+               {name, keys.size(), build_ns, lookup_ns, iterate_ns});
+}
+
+// Every entity is 11 nodes: the object, 6 scalars, and a position array holding 3 floats
+static constexpr Int32 nodes_per_entity = 11;
+
+// The way documents used to be assembled: initializer lists, which copy their elements, and push_back of an lvalue
+static SerializedData
+build_with_initializers(Int32 entities)
+{
+  auto scene = SerializedData::array({});
+  for (Int32 i = 0; i < entities; ++i)
+  {
+    auto position = SerializedData::array({i * 1.0, i * 2.0, i * 3.0});
+
+    SerializedData entity = {
+        {"id", i},
+        {"name", "entity"},
+        {"layer", i % 8},
+        {"visible", true},
+        {"mass", 1.5},
+        {"parent", nullptr},
+        {"position", position},
+    };
+    scene.get_array().push_back(entity);
+  }
+
+  return scene;
+}
+
+static SerializedData
+build_with_builders(Int32 entities)
+{
+  auto scene = SerializedData::array_builder(entities);
+  for (Int32 i = 0; i < entities; ++i)
+  {
+    auto position = SerializedData::array_builder(3).add(i * 1.0).add(i * 2.0).add(i * 3.0).build();
+
+    scene.add(SerializedData::object_builder(7)
+                  .add("id", i)
+                  .add("name", "entity")
+                  .add("layer", i % 8)
+                  .add("visible", true)
+                  .add("mass", 1.5)
+                  .add("parent", nullptr)
+                  .add("position", std::move(position))
+                  .build());
+  }
+
+  return std::move(scene).build();
+}
+
+template<typename F>
+Void
+run_document_benchmark(const Owner<Logger>& logger, const String& name, Int32 entities, F&& build)
+{
+  auto nodes       = static_cast<Int64>(entities) * nodes_per_entity;
+  auto allocations = allocation_count.load();
+  auto start       = Clock::now();
+  auto document    = build(entities);
+  auto end         = Clock::now();
+  allocations      = allocation_count.load() - allocations;
+
+  sink = sink + static_cast<Int64>(document.size());
+  logger->info("{}: {} nodes in {}ms, {} allocations per node",
+               {name, nodes, std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+                static_cast<Float64>(allocations) / static_cast<Float64>(nodes)});
+}
+
+// Compares two documents which only differ in their last entity, first deeply and then through their cached hashes
+static Void
+run_equality_benchmark(const Owner<Logger>& logger, Int32 entities)
+{
+  auto current = build_with_builders(entities);
+  auto changed = build_with_builders(entities);
+  changed[entities - 1]["layer"] = -1;
+
+  auto deep_ns = measure_ns(1, [&] { sink = sink + (current == changed); });
+
+  auto hash_ns = measure_ns(1, [&] { sink = sink + static_cast<Int64>(current.hash() ^ changed.hash()); });
+
+  auto cached_ns = measure_ns(1, [&] { sink = sink + (current == changed); });
+
+  logger->info("Equality: deep = {}ms, first hash = {}ms, with cached hashes = {}ns",
+               {deep_ns / 1e6, hash_ns / 1e6, cached_ns});
+}
+
+// Takes a snapshot of a document and changes one value in it, as an undo stack does before every edit
+static Void
+run_copy_benchmark(const Owner<Logger>& logger, Int32 entities)
+{
+  auto document = build_with_builders(entities);
+
+  auto allocations = allocation_count.load();
+  auto copy_ns     = measure_ns(1,
+                                [&]
+                                {
+                                  auto snapshot = document;
+                                  snapshot[entities / 2]["layer"] = -1;
+                                  sink = sink + static_cast<Int64>(snapshot.size());
+                                });
+  allocations      = allocation_count.load() - allocations;
+
+  logger->info("Copy: snapshot and one write = {}us, {} allocations", {copy_ns / 1e3, allocations});
+}
+
+// Diffs a reloaded document against the loaded one, and an edited snapshot against the document it was copied from
+static Void
+run_patch_benchmark(const Owner<Logger>& logger, Int32 entities)
+{
+  auto           current  = build_with_builders(entities);
+  auto           reloaded = build_with_builders(entities);
+  SerializedData patch;
+  reloaded[entities / 2]["layer"] = -1;
+
+  auto first_ns  = measure_ns(1, [&] { patch = SerializedData::diff(current, reloaded); });
+  auto cached_ns = measure_ns(1, [&] { patch = SerializedData::diff(current, reloaded); });
+  auto apply_ns  = measure_ns(1, [&] { current.apply_patch(patch); });
+
+  auto snapshot = current;
+  snapshot[entities / 3]["position"][0] = -1.0;
+  auto edit_ns = measure_ns(1, [&] { patch = SerializedData::diff(current, snapshot); });
+
+  logger->info("Patch: reload diff = {}ms, with cached hashes = {}ms, apply = {}us, edit diff = {}us, {} operations",
+               {first_ns / 1e6, cached_ns / 1e6, apply_ns / 1e3, edit_ns / 1e3, patch.size()});
+}
+
+// Reads a nested setting the way configuration getters do, from a dotted string and through a precompiled path
+static Void
+run_path_benchmark(const Owner<Logger>& logger, Int32 reads)
+{
+  auto window = SerializedData::object_builder(scene_keys.size());
+  for (const auto& key: scene_keys)
+  {
+    window.add(key, 1);
+  }
+  window.add("width", 1280);
+
+  auto settings = SerializedData::object_builder()
+                      .add("graphics", SerializedData::object_builder().add("window", std::move(window).build()).build())
+                      .build();
+
+  const String key = "graphics.window.width";
+  auto         run = [&](const String& name, auto&& read)
+  {
+    auto allocations = allocation_count.load();
+    auto ns          = measure_ns(reads,
+                                  [&]
+                                  {
+                                    for (Int32 i = 0; i < reads; ++i)
+                                    {
+                                      sink = sink + read();
+                                    }
+                                  });
+    allocations      = allocation_count.load() - allocations;
+    logger->info("{}: {}ns/read, {} allocations per read",
+                 {name, ns, static_cast<Float64>(allocations) / static_cast<Float64>(reads)});
+  };
+
+  const auto& data = settings;
+  run("Path/string", [&] { return SerializedPath{key}.resolve(data)->get_integer().value(); });
+
+  SerializedPath path{key};
+  run("Path/compiled", [&] { return path.resolve(data)->get_integer().value(); });
+  run("Path/operator[]", [&] { return data["graphics"]["window"]["width"].get_integer().value(); });
+}
+
+struct PrefabComponent
+{
+  String          type;
+  DArray<Float32> values;
+};
+
+struct Prefab
+{
+  String                  name;
+  Int32                   layer;
+  Bool                    is_static;
+  Float64                 mass;
+  DArray<Int32>           groups;
+  DArray<PrefabComponent> components;
+};
+
+struct PrefabSet
+{
+  DArray<Prefab> prefabs;
+};
+
+DECLARE_REFLECTION(PrefabComponent, type, values);
+DECLARE_REFLECTION(Prefab, name, layer, is_static, mass, groups, components);
+DECLARE_REFLECTION(PrefabSet, prefabs);
+
+static String
+make_prefabs_json(Int32 count)
+{
+  StringStream stream;
+  stream << R"({"prefabs": [)";
+  for (Int32 i = 0; i < count; ++i)
+  {
+    stream << (i ? "," : "") << R"({"name": "prefab-)" << i << R"(", "layer": )" << i % 8
+           << R"(, "is_static": false, "mass": 1.5, "groups": [1, 5], "components": [)"
+           << R"({"type": "transform", "values": [1.0, 2.0, 3.0]}, {"type": "collider", "values": [0.5]}]})";
+  }
+  stream << "]}";
+  return stream.str();
+}
+
+// Loads prefab definitions through a SerializedData tree and straight from the parser events
+static Void
+run_reflection_benchmark(const Owner<Logger>& logger, Int32 count)
+{
+  auto json = make_prefabs_json(count);
+
+  auto run = [&](const String& name, auto&& load)
+  {
+    PrefabSet prefabs;
+    auto      allocations = allocation_count.load();
+    auto      ms          = measure_ns(1, [&] { load(prefabs); }) / 1e6;
+    allocations           = allocation_count.load() - allocations;
+
+    sink = sink + static_cast<Int64>(prefabs.prefabs.size());
+    logger->info("{}: {} prefabs in {}ms, {} allocations per prefab",
+                 {name, count, ms, static_cast<Float64>(allocations) / static_cast<Float64>(count)});
+  };
+
+  run("Reflection/tree",
+      [&](PrefabSet& prefabs)
+      {
+        StringStream   stream{json};
+        SerializedData data;
+        data.parse<Json>(stream);
+        data.deserialize(prefabs);
+      });
+
+  run("Reflection/events",
+      [&](PrefabSet& prefabs)
+      {
+        ReflectionReader reader{prefabs};
+        Json{}.deserialize(StringView{json}, reader);
+      });
+}
+
+// Parses a large generated document, the bare event scan and into each kind of tree
+static Void
+run_json_benchmark(const Owner<Logger>& logger, Int32 prefabs)
+{
+  auto json      = make_prefabs_json(prefabs);
+  auto megabytes = static_cast<Float64>(json.size()) / (1024.0 * 1024.0);
+
+  auto run = [&](const String& name, auto&& parse)
+  {
+    auto ms = measure_ns(1, parse) / 1e6;
+    logger->info("Json/{}: {}MB in {}ms, {}MB/s", {name, megabytes, ms, megabytes / (ms / 1e3)});
+  };
+
+  run("events",
+      [&]
+      {
+        SerializedVisitor visitor;
+        Json{}.deserialize(StringView{json}, visitor);
+      });
+
+  run("data",
+      [&]
+      {
+        StringStream   stream{json};
+        SerializedData data;
+        data.parse<Json>(stream);
+        sink = sink + static_cast<Int64>(data.size());
+      });
+
+  run("document",
+      [&]
+      {
+        SerializedDocument document;
+        document.parse<Json>(StringView{json});
+        sink = sink + static_cast<Int64>(document.root().size());
+      });
+
+  // Files are read through a stream buffer or mapped and parsed in place
+  auto path = (std::filesystem::temp_directory_path() / "serde-bench-lab.json").string();
+  FileOutputStream{path, std::ios::binary} << json;
+
+  run("file-stream",
+      [&]
+      {
+        FileInputStream    file{path, std::ios::binary};
+        SerializedDocument document;
+        document.parse<Json>(file);
+        sink = sink + static_cast<Int64>(document.root().size());
+      });
+
+  run("file-mapped",
+      [&]
+      {
+        MappedFile         file{path};
+        SerializedDocument document;
+        document.parse<Json>(file.view());
+        sink = sink + static_cast<Int64>(document.root().size());
+      });
+
+  std::filesystem::remove(path);
+
+  SerializedData data;
+  StringStream   stream{json};
+  data.parse<Json>(stream);
+
+  run("emit-compact",
+      [&]
+      {
+        StringOutputStream output;
+        data.dumps<Json>(output);
+        sink = sink + static_cast<Int64>(output.tellp());
+      });
+
+  run("emit-pretty",
+      [&]
+      {
+        StringOutputStream output;
+        data.dumps(output, Json{{.serializer_config = {.pretty_print = true, .indent = 2}}});
+        sink = sink + static_cast<Int64>(output.tellp());
+      });
+}
+
+// Size and round trip time of the binary format against JSON on the same prefab tree
+static Void
+run_sbf_benchmark(const Owner<Logger>& logger, Int32 prefabs)
+{
+  auto           json = make_prefabs_json(prefabs);
+  SerializedData data;
+  data.parse<Json>(StringView{json});
+
+  auto run = [&](const String& name, const auto& format)
+  {
+    String encoded;
+    auto   encode = [&]
+    {
+      StringOutputStream output;
+      data.dumps(output, format);
+      encoded = output.str();
+    };
+    auto decode = [&]
+    {
+      SerializedData decoded;
+      decoded.parse(StringView{encoded}, format);
+      sink = sink + static_cast<Int64>(decoded.size());
+    };
+
+    auto encode_ms = measure_ns(1, encode) / 1e6;
+    auto decode_ms = measure_ns(1, decode) / 1e6;
+    logger->info("Sbf/{}: {} bytes, encoded in {}ms, decoded in {}ms", {name, encoded.size(), encode_ms, decode_ms});
+  };
+
+  run("json", Json{});
+  run("sbf", Sbf{});
+  run("sbf-indexed", Sbf{{.indexed = true}});
+}
+
+// Cost of reading a few prefabs of a large SBF buffer, in place or after decoding it whole
+static Void
+run_sbf_view_benchmark(const Owner<Logger>& logger, Int32 prefabs, Int32 reads)
+{
+  auto           json = make_prefabs_json(prefabs);
+  SerializedData data;
+  data.parse<Json>(StringView{json});
+
+  auto run = [&](const String& name, const Sbf& format)
+  {
+    StringOutputStream output;
+    data.dumps(output, format);
+    auto encoded = output.str();
+
+    auto decoded_ns = measure_ns(reads,
+                                 [&]
+                                 {
+                                   SerializedData decoded;
+                                   decoded.parse(StringView{encoded}, format);
+                                   for (Int32 i = 0; i < reads; ++i)
+                                   {
+                                     const auto& prefab = decoded["prefabs"][(i * 7919) % prefabs];
+                                     sink = sink + prefab["layer"].get_integer().value();
+                                   }
+                                 });
+    auto view_ns    = measure_ns(reads,
+                                 [&]
+                                 {
+                                   SbfView root{StringView{encoded}};
+                                   for (Int32 i = 0; i < reads; ++i)
+                                   {
+                                     auto prefab = root["prefabs"][(i * 7919) % prefabs];
+                                     sink        = sink + prefab["layer"].get_integer();
+                                   }
+                                 });
+    logger->info("SbfView/{}: {}ns/read after decoding, {}ns/read in place", {name, decoded_ns, view_ns});
+  };
+
+  run("sbf", Sbf{});
+  run("sbf-indexed", Sbf{{.indexed = true}});
+}
+
+int
+main(int argc, char** argv)
+{
+  LoggerFactory logger_factory{};
+  logger_factory.add_appender(
+      std::make_shared<ConsoleLogAppender>("console", "[{level:w=6}] {tag:w=20} ->> {message}"));
+  auto logger = logger_factory.get("serde-bench-lab");
+
+  Int32 objects = argc > 1 ? std::stoi(argv[1]) : 10'000;
+  Int32 rounds  = argc > 2 ? std::stoi(argv[2]) : 20;
+
+  logger->info("Running with {} objects, {} rounds", {objects, rounds});
+
+  run_benchmark<DataStorage<SerializedType::Object>>(logger, "Object/config", config_keys, objects, rounds);
+  run_benchmark<UnorderedObject>(logger, "UnorderedMap/config", config_keys, objects, rounds);
+  run_benchmark<DataStorage<SerializedType::Object>>(logger, "Object/scene", scene_keys, objects, rounds);
+  run_benchmark<UnorderedObject>(logger, "UnorderedMap/scene", scene_keys, objects, rounds);
+
+  Int32 entities = argc > 3 ? std::stoi(argv[3]) : 1'000'000 / nodes_per_entity;
+  run_document_benchmark(logger, "Document/initializers", entities, build_with_initializers);
+  run_document_benchmark(logger, "Document/builders", entities, build_with_builders);
+  run_equality_benchmark(logger, entities);
+  run_copy_benchmark(logger, entities);
+  run_patch_benchmark(logger, entities);
+  run_path_benchmark(logger, objects * 100);
+  run_reflection_benchmark(logger, objects);
+  run_json_benchmark(logger, objects * 20);
+  run_sbf_benchmark(logger, objects * 10);
+  run_sbf_view_benchmark(logger, objects * 10, 1000);
+}